@@ -0,0 +1,125 @@
+// Compares building AABBTreeIndirect::Tree3f over a triangle mesh on a single thread and on all threads,
+// and measures the ray casting throughput of the resulting tree, casting the rays one by one
+// and in bundles of rays sharing an origin.
+#include <iostream>
+#include <random>
+#include <string>
+
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+#include <libslic3r/AABBTreeIndirect.hpp>
+#include <libslic3r/TriangleMesh.hpp>
+#include <libslic3r/Timer.hpp>
+
+using namespace Slic3r;
+
+const std::string USAGE_STR = {
+    "Usage: aabb_build_benchmark [stlfilename.stl] [number of rays]"
+};
+
+static bool same_trees(const AABBTreeIndirect::Tree3f &lhs, const AABBTreeIndirect::Tree3f &rhs)
+{
+    if (lhs.nodes().size() != rhs.nodes().size())
+        return false;
+    for (size_t i = 0; i < lhs.nodes().size(); ++ i) {
+        const auto &l = lhs.node(i);
+        const auto &r = rhs.node(i);
+        if (l.idx != r.idx || (l.is_valid() && (l.bbox.min() != r.bbox.min() || l.bbox.max() != r.bbox.max())))
+            return false;
+    }
+    return true;
+}
+
+int main(const int argc, const char *argv[])
+{
+    if (argc > 3) {
+        std::cout << USAGE_STR << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    TriangleMesh mesh;
+    if (argc > 1) {
+        if (! mesh.ReadSTLFile(argv[1])) {
+            std::cerr << "Failed to load " << argv[1] << std::endl;
+            return EXIT_FAILURE;
+        }
+    } else
+        // About 2M triangles.
+        mesh = make_sphere(50., PI / 1000.);
+    const size_t num_rays = argc > 2 ? std::stoul(argv[2]) : 1000000;
+    const indexed_triangle_set &its = mesh.its;
+
+    Timing::Timer timer;
+    AABBTreeIndirect::Tree3f serial;
+    timer.start();
+    tbb::task_arena(1).execute([&its, &serial]() {
+        serial = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(its.vertices, its.indices);
+    });
+    const double time_serial = timer.elapsed_seconds();
+
+    timer.start();
+    AABBTreeIndirect::Tree3f parallel = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(its.vertices, its.indices);
+    const double time_parallel = timer.elapsed_seconds();
+
+    // Rays from random points of a sphere around the mesh towards random points inside the mesh bounding box.
+    const BoundingBoxf3 bbox   = mesh.bounding_box();
+    const Vec3d         center = bbox.center();
+    const double        radius = bbox.size().norm();
+    std::mt19937                           rng(867092346);
+    std::normal_distribution<double>       normal;
+    std::uniform_real_distribution<double> unit(0., 1.);
+    std::vector<std::pair<Vec3d, Vec3d>>   rays(num_rays);
+    for (auto &[origin, dir] : rays) {
+        origin = center + radius * Vec3d(normal(rng), normal(rng), normal(rng)).normalized();
+        dir    = (bbox.min + Vec3d(unit(rng), unit(rng), unit(rng)).cwiseProduct(bbox.size()) - origin).normalized();
+    }
+    std::vector<unsigned char> hits(num_rays, false);
+    timer.start();
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_rays), [&its, &parallel, &rays, &hits](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            igl::Hit hit;
+            hits[i] = AABBTreeIndirect::intersect_ray_first_hit(its.vertices, its.indices, parallel, rays[i].first, rays[i].second, hit);
+        }
+    });
+    const double time_rays = timer.elapsed_seconds();
+
+    // Bundles of 64 rays sharing an origin, cast one by one and as a stream.
+    static constexpr const size_t bundle_size = 64;
+    const size_t num_bundles = num_rays / bundle_size;
+    std::vector<Vec3d> bundle_dirs(bundle_size);
+    for (Vec3d &dir : bundle_dirs)
+        dir = Vec3d(normal(rng), normal(rng), normal(rng)).normalized();
+    std::vector<size_t> bundle_hits_single(num_bundles, 0);
+    timer.start();
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_bundles), [&its, &parallel, &rays, &bundle_dirs, &bundle_hits_single](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i)
+            for (const Vec3d &dir : bundle_dirs) {
+                igl::Hit hit;
+                bundle_hits_single[i] += AABBTreeIndirect::intersect_ray_first_hit(its.vertices, its.indices, parallel, rays[i].first, dir, hit);
+            }
+    });
+    const double time_bundles_single = timer.elapsed_seconds();
+    std::vector<size_t> bundle_hits_stream(num_bundles, 0);
+    timer.start();
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_bundles), [&its, &parallel, &rays, &bundle_dirs, &bundle_hits_stream](const tbb::blocked_range<size_t> &range) {
+        std::vector<Vec3d>    origins;
+        std::vector<igl::Hit> hits;
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            origins.assign(bundle_size, rays[i].first);
+            bundle_hits_stream[i] = AABBTreeIndirect::intersect_rays_first_hit(its.vertices, its.indices, parallel, origins, bundle_dirs, hits);
+        }
+    });
+    const double time_bundles_stream = timer.elapsed_seconds();
+
+    std::cout << "Triangles: " << its.indices.size() << ", threads: " << tbb::this_task_arena::max_concurrency() << std::endl;
+    std::cout << "Serial build:   " << time_serial   << " s" << std::endl;
+    std::cout << "Parallel build: " << time_parallel << " s, speedup " << time_serial / time_parallel << std::endl;
+    std::cout << "Trees are " << (same_trees(serial, parallel) ? "identical" : "DIFFERENT") << std::endl;
+    std::cout << "Rays: " << num_rays << ", " << std::count(hits.begin(), hits.end(), true) << " hits, " <<
+        num_rays / time_rays << " rays/s" << std::endl;
+    std::cout << "Bundles of " << bundle_size << " rays, one by one: " << num_bundles * bundle_size / time_bundles_single << " rays/s, " <<
+        "as a stream: " << num_bundles * bundle_size / time_bundles_stream << " rays/s, hits " <<
+        (bundle_hits_single == bundle_hits_stream ? "identical" : "DIFFERENT") << std::endl;
+    return EXIT_SUCCESS;
+}
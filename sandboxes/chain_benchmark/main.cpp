@@ -0,0 +1,68 @@
+// Compares chain_polylines(), which chains huge collections by spatially partitioned grid cells in parallel,
+// with chaining the whole collection by a single greedy pass, reporting the time and the travel length of both.
+#include <iostream>
+#include <random>
+#include <string>
+
+#include <libslic3r/ShortestPath.hpp>
+#include <libslic3r/Timer.hpp>
+
+using namespace Slic3r;
+
+const std::string USAGE_STR = {
+    "Usage: chain_benchmark [number of segments] [max segment length in mm]"
+};
+
+// Random short segments inside a 200x200mm square, resembling gap fill or support lines.
+static Polylines random_segments(size_t num_segments, double max_length)
+{
+    std::mt19937                           rng(867092346);
+    std::uniform_real_distribution<double> pos(0., 200.);
+    std::uniform_real_distribution<double> dir(0., 2. * M_PI);
+    std::uniform_real_distribution<double> len(0.1, max_length);
+    Polylines out;
+    out.reserve(num_segments);
+    for (size_t i = 0; i < num_segments; ++ i) {
+        Vec2d  a = { pos(rng), pos(rng) };
+        double angle = dir(rng);
+        Vec2d  b = a + len(rng) * Vec2d(cos(angle), sin(angle));
+        out.push_back(Polyline{ Point::new_scale(a.x(), a.y()), Point::new_scale(b.x(), b.y()) });
+    }
+    return out;
+}
+
+static double travel_length(const Polylines &polylines)
+{
+    double travel = 0.;
+    for (size_t i = 1; i < polylines.size(); ++ i)
+        travel += (polylines[i].first_point() - polylines[i - 1].last_point()).cast<double>().norm();
+    return unscaled<double>(travel);
+}
+
+int main(const int argc, const char *argv[])
+{
+    if (argc > 3) {
+        std::cout << USAGE_STR << std::endl;
+        return EXIT_FAILURE;
+    }
+    const size_t num_segments = argc > 1 ? std::stoul(argv[1]) : 20000;
+    const double max_length   = argc > 2 ? std::stod(argv[2]) : 2.;
+    const Polylines segments  = random_segments(num_segments, max_length);
+
+    Timing::Timer timer;
+    timer.start();
+    Polylines reference = chain_polylines_unpartitioned(Polylines(segments));
+    double time_reference = timer.elapsed_seconds();
+
+    timer.start();
+    Polylines partitioned = chain_polylines(Polylines(segments));
+    double time_partitioned = timer.elapsed_seconds();
+
+    const double travel_reference   = travel_length(reference);
+    const double travel_partitioned = travel_length(partitioned);
+    std::cout << "Segments: " << num_segments << std::endl;
+    std::cout << "Unpartitioned: " << time_reference   << " s, travel " << travel_reference   << " mm" << std::endl;
+    std::cout << "Partitioned:   " << time_partitioned << " s, travel " << travel_partitioned << " mm" << std::endl;
+    std::cout << "Speedup: " << time_reference / time_partitioned << ", travel ratio: " << travel_partitioned / travel_reference << std::endl;
+    return EXIT_SUCCESS;
+}
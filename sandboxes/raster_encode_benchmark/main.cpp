@@ -0,0 +1,102 @@
+// Measures the throughput and the output size of the encoders of the SLA layer rasters
+// on the layers of a mesh rasterized at the resolution of an 8K printer display.
+#include <iostream>
+#include <string>
+#include <functional>
+
+#include <libslic3r/SLA/AGGRaster.hpp>
+#include <libslic3r/TriangleMesh.hpp>
+#include <libslic3r/TriangleMeshSlicer.hpp>
+#include <libslic3r/Timer.hpp>
+
+#include <miniz.h>
+
+using namespace Slic3r;
+
+const std::string USAGE_STR = {
+    "Usage: raster_encode_benchmark [stlfilename.stl] [number of layers]"
+};
+
+int main(const int argc, const char *argv[])
+{
+    if (argc > 3) {
+        std::cout << USAGE_STR << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    TriangleMesh mesh;
+    if (argc > 1) {
+        if (! mesh.ReadSTLFile(argv[1])) {
+            std::cerr << "Failed to load " << argv[1] << std::endl;
+            return EXIT_FAILURE;
+        }
+    } else {
+        // A sphere on a plate with a column.
+        mesh = make_sphere(30., PI / 180.);
+        mesh.translate(0.f, 0.f, 40.f);
+        TriangleMesh plate = make_cube(150., 60., 10.);
+        plate.translate(-75.f, -30.f, 0.f);
+        mesh.merge(plate);
+        TriangleMesh column = make_cylinder(8., 70.);
+        column.translate(50.f, 0.f, 0.f);
+        mesh.merge(column);
+    }
+    const size_t num_layers = argc > 2 ? std::stoul(argv[2]) : 200;
+
+    // 8K display of 218 x 123 mm, the mesh centered in XY.
+    const sla::Resolution res{ 7680, 4320 };
+    const sla::PixelDim   pxdim{ 218. / res.width_px, 123. / res.height_px };
+    const BoundingBoxf3   bbox = mesh.bounding_box();
+    mesh.translate(-float(bbox.center().x()), -float(bbox.center().y()), 0.f);
+    sla::RasterBase::Trafo trafo;
+    trafo.center_x = scaled(109.);
+    trafo.center_y = scaled(61.5);
+
+    std::vector<float> zs;
+    for (size_t i = 0; i < num_layers; ++ i)
+        zs.emplace_back(float(bbox.min.z() + (i + 0.5) * bbox.size().z() / num_layers));
+    std::vector<ExPolygons> slices = slice_mesh_ex(mesh.its, zs);
+
+    struct Encoder {
+        std::string        name;
+        sla::RasterEncoder encoder;
+        double             time { 0 };
+        size_t             size { 0 };
+    };
+    std::vector<Encoder> encoders;
+    encoders.push_back({ "PNG miniz (before)", [](const void *ptr, size_t w, size_t h, size_t num_components) {
+        size_t size = 0;
+        void  *data = tdefl_write_image_to_png_file_in_memory(ptr, int(w), int(h), int(num_components), &size);
+        std::vector<uint8_t> buf(static_cast<uint8_t*>(data), static_cast<uint8_t*>(data) + size);
+        mz_free(data);
+        return sla::EncodedRaster(std::move(buf), "png");
+    } });
+    for (int level : { 0, 1, 2, 6, 9 })
+        encoders.push_back({ "PNG level " + std::to_string(level), sla::PNGRasterEncoder{ level } });
+    encoders.push_back({ "QOI", sla::QOIRasterEncoder{} });
+    encoders.push_back({ "RLE", sla::RLERasterEncoder{} });
+
+    Timing::Timer timer;
+    double time_draw = 0.;
+    for (const ExPolygons &slice : slices) {
+        timer.start();
+        sla::RasterGrayscaleAA raster{ res, pxdim, trafo, agg::gamma_none() };
+        for (const ExPolygon &expoly : slice)
+            raster.draw(expoly);
+        time_draw += timer.elapsed_seconds();
+        for (Encoder &encoder : encoders) {
+            timer.start();
+            sla::EncodedRaster encoded = raster.encode(encoder.encoder);
+            encoder.time += timer.elapsed_seconds();
+            encoder.size += encoded.size();
+        }
+    }
+
+    const double raw_mb = double(res.pixels()) * num_layers / 1e6;
+    std::cout << "Layers: " << num_layers << ", resolution " << res.width_px << " x " << res.height_px <<
+        ", rasterization " << raw_mb / time_draw << " MB/s" << std::endl;
+    for (const Encoder &encoder : encoders)
+        std::cout << encoder.name << ": " << raw_mb / encoder.time << " MB/s, " <<
+            double(encoder.size) / 1e6 << " MB, " << double(encoder.size) / num_layers / 1e3 << " kB per layer" << std::endl;
+    return EXIT_SUCCESS;
+}
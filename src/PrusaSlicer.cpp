@@ -21,7 +21,13 @@
     #endif /* SLIC3R_GUI */
 #endif /* WIN32 */
 
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/trim.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/nowide/args.hpp>
 #include <boost/nowide/cenv.hpp>
@@ -29,6 +35,8 @@
 #include <boost/nowide/integration/filesystem.hpp>
 #include <boost/dll/runtime_symbol_info.hpp>
 
+#include <tbb/task_arena.h>
+
 #include "unix/fhs.hpp"  // Generated by CMake from ../platform/unix/fhs.hpp.in
 
 #include "libslic3r/libslic3r.h"
@@ -44,6 +52,7 @@
 #include "libslic3r/Platform.hpp"
 #include "libslic3r/Print.hpp"
 #include "libslic3r/SLAPrint.hpp"
+#include "libslic3r/SlicingServer.hpp"
 #include "libslic3r/TriangleMesh.hpp"
 #include "libslic3r/Format/AMF.hpp"
 #include "libslic3r/Format/3mf.hpp"
@@ -70,6 +79,45 @@ static PrinterTechnology get_printer_technology(const DynamicConfig &config)
     return (opt == nullptr) ? ptUnknown : opt->value;
 }
 
+// Config files loaded by the jobs of the batch mode. A file is loaded again if it was modified since.
+// Files loaded with substitutions are not cached, so that the substitutions are reported for every job.
+class BatchConfigCache
+{
+public:
+    ConfigSubstitutions load(const std::string &file, ForwardCompatibilitySubstitutionRule rule, DynamicPrintConfig &out)
+    {
+        const std::time_t mtime = boost::filesystem::last_write_time(file);
+        {
+            std::scoped_lock<std::mutex> lock(m_mutex);
+            if (auto it = m_configs.find(std::make_pair(file, rule)); it != m_configs.end() && it->second.first == mtime) {
+                out = it->second.second;
+                return {};
+            }
+        }
+        DynamicPrintConfig  config;
+        ConfigSubstitutions substitutions = config.load(file, rule);
+        if (substitutions.empty()) {
+            std::scoped_lock<std::mutex> lock(m_mutex);
+            m_configs[std::make_pair(file, rule)] = std::make_pair(mtime, config);
+        }
+        out = std::move(config);
+        return substitutions;
+    }
+
+private:
+    std::mutex                                                                                                 m_mutex;
+    std::map<std::pair<std::string, ForwardCompatibilitySubstitutionRule>, std::pair<std::time_t, DynamicPrintConfig>> m_configs;
+};
+
+struct CLI::BatchWorker
+{
+    BatchWorker(BatchConfigCache &configs) : configs(configs) {}
+
+    BatchConfigCache &configs;
+    Print             fff_print;
+    SLAPrint          sla_print;
+};
+
 int CLI::run(int argc, char **argv)
 {
     // Mark the main thread for the debugger and for runtime checks.
@@ -110,12 +158,23 @@ int CLI::run(int argc, char **argv)
 	if (! this->setup(argc, argv))
 		return 1;
 
+    if (m_config.opt_bool("batch"))
+        return this->run_batch();
+
+    if (m_config.opt_bool("server"))
+        return this->run_server();
+
+    return this->process(argc, argv);
+}
+
+int CLI::process(int argc, char **argv)
+{
     m_extra_config.apply(m_config, true);
     m_extra_config.normalize_fdm();
     
     PrinterTechnology printer_technology = get_printer_technology(m_config);
 
-    bool							start_gui			= m_actions.empty() &&
+    bool							start_gui			= m_actions.empty() && m_batch_worker == nullptr &&
         // cutting transformations are setting an "export" action.
         std::find(m_transforms.begin(), m_transforms.end(), "cut") == m_transforms.end() &&
         std::find(m_transforms.begin(), m_transforms.end(), "cut_x") == m_transforms.end() &&
@@ -147,7 +206,9 @@ int CLI::run(int argc, char **argv)
         DynamicPrintConfig  config;
         ConfigSubstitutions config_substitutions;
         try {
-            config_substitutions = config.load(file, config_substitution_rule);
+            config_substitutions = m_batch_worker ?
+                m_batch_worker->configs.load(file, config_substitution_rule, config) :
+                config.load(file, config_substitution_rule);
         } catch (std::exception &ex) {
             boost::nowide::cerr << "Error while reading config file \"" << file << "\": " << ex.what() << std::endl;
             return 1;
@@ -258,7 +319,7 @@ int CLI::run(int argc, char **argv)
             }
             if (!boost::filesystem::exists(file)) {
                 boost::nowide::cerr << "No such file: " << file << std::endl;
-                exit(1);
+                return 1;
             }
             Model model;
             try {
@@ -299,7 +360,8 @@ int CLI::run(int argc, char **argv)
         }
     }
 
-    if (!start_gui) {
+    // The jobs of the batch mode are read from stdin, there is nobody to answer.
+    if (!start_gui && m_batch_worker == nullptr) {
         const auto* post_process = m_print_config.opt<ConfigOptionStrings>("post_process");
         if (post_process != nullptr && !post_process->empty()) {
             boost::nowide::cout << "\nA post-processing script has been detected in the config data:\n\n";
@@ -594,8 +656,11 @@ int CLI::run(int argc, char **argv)
                 // is supplied); if any object has no instances, it will get a default one
                 // and all instances will be rearranged (unless --dont-arrange is supplied).
                 std::string outfile = m_config.opt_string("output");
-                Print       fff_print;
-                SLAPrint    sla_print;
+                // The batch mode reuses the print objects of the worker, so their caches stay warm.
+                Print       fff_print_local;
+                SLAPrint    sla_print_local;
+                Print      &fff_print = m_batch_worker ? m_batch_worker->fff_print : fff_print_local;
+                SLAPrint   &sla_print = m_batch_worker ? m_batch_worker->sla_print : sla_print_local;
                 sla_print.set_status_callback(
                             [](const PrintBase::SlicingStatus& s)
                 {
@@ -811,6 +876,11 @@ bool CLI::setup(int argc, char **argv)
     set_sys_shapes_dir((path_resources / "shapes").string());
     set_custom_gcodes_dir((path_resources / "custom_gcodes").string());
 
+    return this->parse_cli(argc, argv);
+}
+
+bool CLI::parse_cli(int argc, char **argv)
+{
     // Parse all command line options into a DynamicConfig.
     // If any option is unsupported, print usage and abort immediately.
     t_config_option_keys opt_order;
@@ -828,16 +898,19 @@ bool CLI::setup(int argc, char **argv)
             m_transforms.emplace_back(opt_key);
     }
 
-    {
-        const ConfigOptionInt *opt_loglevel = m_config.opt<ConfigOptionInt>("loglevel");
-        if (opt_loglevel != 0)
-            set_logging_level(opt_loglevel->value);
-    }
+    // The jobs of the batch mode share the process wide settings with the batch mode itself.
+    if (m_batch_worker == nullptr) {
+        {
+            const ConfigOptionInt *opt_loglevel = m_config.opt<ConfigOptionInt>("loglevel");
+            if (opt_loglevel != 0)
+                set_logging_level(opt_loglevel->value);
+        }
 
-    {
-        const ConfigOptionInt *opt_threads = m_config.opt<ConfigOptionInt>("threads");
-        if (opt_threads != nullptr)
-            thread_count = opt_threads->value;
+        {
+            const ConfigOptionInt *opt_threads = m_config.opt<ConfigOptionInt>("threads");
+            if (opt_threads != nullptr)
+                thread_count = opt_threads->value;
+        }
     }
 
     //FIXME Validating at this stage most likely does not make sense, as the config is not fully initialized yet.
@@ -848,7 +921,8 @@ bool CLI::setup(int argc, char **argv)
         for (const t_optiondef_map::value_type &optdef : *options)
             m_config.option(optdef.first, true);
 
-    set_data_dir(m_config.opt_string("datadir"));
+    if (m_batch_worker == nullptr)
+        set_data_dir(m_config.opt_string("datadir"));
     
     //FIXME Validating at this stage most likely does not make sense, as the config is not fully initialized yet.
     if (!validity.empty()) {
@@ -859,6 +933,117 @@ bool CLI::setup(int argc, char **argv)
     return true;
 }
 
+int CLI::run_server()
+{
+    std::string socket_path = m_config.opt_string("server_socket");
+    if (socket_path.empty())
+        socket_path = (boost::filesystem::temp_directory_path() / (SLIC3R_APP_KEY ".sock")).string();
+    try {
+        SlicingServer server;
+        boost::nowide::cout << "Slicing server listening on " << socket_path << std::endl;
+        server.serve(socket_path);
+    } catch (const std::exception &ex) {
+        boost::nowide::cerr << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int CLI::run_batch()
+{
+    // Split the threads among the jobs processed concurrently.
+    const size_t num_workers      = size_t(std::max(1, m_config.opt_int("batch_jobs")));
+    const size_t num_threads      = thread_count ? *thread_count : std::max(1u, std::thread::hardware_concurrency());
+    const int    threads_per_job  = int(std::max<size_t>(1, num_threads / num_workers));
+
+    BatchConfigCache                           configs;
+    std::mutex                                 mutex;
+    std::condition_variable                    condition;
+    std::deque<std::pair<size_t, std::string>> queue;
+    bool                                       end_of_input = false;
+    size_t                                     num_failed   = 0;
+
+    auto worker_fn = [&]() {
+        BatchWorker     worker(configs);
+        tbb::task_arena arena(threads_per_job);
+        for (;;) {
+            std::pair<size_t, std::string> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&queue, &end_of_input]() { return end_of_input || ! queue.empty(); });
+                if (queue.empty())
+                    return;
+                job = std::move(queue.front());
+                queue.pop_front();
+            }
+            // Wake up the reader waiting for a free slot in the queue.
+            condition.notify_all();
+
+            int ret = 1;
+            try {
+                // Arguments are separated by white space and may be quoted by single or double quotes.
+                // A malformed line throws and is reported as a failed job.
+                std::vector<std::string> args { SLIC3R_APP_KEY };
+                append(args, split_command_line(job.second));
+                std::vector<char*> argv;
+                for (std::string &arg : args)
+                    argv.emplace_back(arg.data());
+                argv.emplace_back(nullptr);
+                ret = arena.execute([&worker, &args, &argv]() {
+                    CLI cli;
+                    cli.m_batch_worker = &worker;
+                    if (! cli.parse_cli(int(args.size()), argv.data()))
+                        return 1;
+                    if (cli.m_config.opt_bool("batch")) {
+                        boost::nowide::cerr << "error: batch mode can not be nested" << std::endl;
+                        return 1;
+                    }
+                    if (cli.m_actions.empty()) {
+                        boost::nowide::cerr << "error: no action specified" << std::endl;
+                        return 1;
+                    }
+                    return cli.process(int(args.size()), argv.data());
+                });
+            } catch (const std::exception &ex) {
+                boost::nowide::cerr << ex.what() << std::endl;
+            }
+
+            std::scoped_lock<std::mutex> lock(mutex);
+            if (ret != 0)
+                ++ num_failed;
+            boost::nowide::cout << "job " << job.first << (ret == 0 ? " done" : " failed") << std::endl;
+        }
+    };
+
+    std::vector<boost::thread> workers;
+    for (size_t i = 0; i < num_workers; ++ i)
+        workers.emplace_back(create_thread(worker_fn));
+
+    // Read the jobs, hold at most two jobs per worker in the queue.
+    size_t      job_id = 0;
+    std::string line;
+    while (std::getline(boost::nowide::cin, line)) {
+        boost::algorithm::trim(line);
+        if (line.empty() || line.front() == '#')
+            continue;
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&queue, num_workers]() { return queue.size() < 2 * num_workers; });
+        queue.emplace_back(++ job_id, std::move(line));
+        lock.unlock();
+        condition.notify_all();
+    }
+    {
+        std::scoped_lock<std::mutex> lock(mutex);
+        end_of_input = true;
+    }
+    condition.notify_all();
+
+    for (boost::thread &worker : workers)
+        worker.join();
+
+    return num_failed == 0 ? 0 : 1;
+}
+
 void CLI::print_help(bool include_print_options, PrinterTechnology printer_technology) const
 {
     boost::nowide::cout
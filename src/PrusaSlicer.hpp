@@ -32,7 +32,20 @@ private:
     std::vector<std::string>    m_transforms;
     std::vector<Model>          m_models;
 
+    // Print objects and caches of a worker of the batch mode, kept warm between the jobs.
+    struct BatchWorker;
+    // Non-null if this CLI processes a single job of the batch mode.
+    BatchWorker                *m_batch_worker { nullptr };
+
     bool setup(int argc, char **argv);
+    /// Parses the command line into m_config, m_input_files, m_actions and m_transforms.
+    bool parse_cli(int argc, char **argv);
+    /// Loads the configs and the input files, applies the transforms and runs the actions.
+    int  process(int argc, char **argv);
+    /// Reads the jobs from stdin, one command line per line, and processes several of them concurrently.
+    int  run_batch();
+    /// Serves the slicing requests of the clients of a local socket, keeping the sliced print between the requests.
+    int  run_server();
     
     /// Prints usage of the CLI.
     void print_help(bool include_print_options = false, PrinterTechnology printer_technology = ptFFF | ptSLA | ptSLS) const;
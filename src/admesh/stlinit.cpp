@@ -25,10 +25,15 @@
 #include <string.h>
 #include <math.h>
 #include <assert.h>
+#include <float.h>
 
 #include <boost/log/trivial.hpp>
 #include <boost/nowide/cstdio.hpp>
 #include <boost/predef/other/endian.h>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <tbb/parallel_reduce.h>
+#include <tbb/blocked_range.h>
 
 #include "stl.h"
 
@@ -232,6 +237,59 @@ static bool stl_read(stl_file *stl, FILE *fp, int first_facet, bool first)
   	return true;
 }
 
+// Binary STL files smaller than this are read with stl_read(), mapping the file does not pay off.
+static constexpr uint32_t STL_MAPPED_MIN_FACETS = 65536;
+
+// Reads all facets of a binary STL file by memory mapping it and decoding the facets in parallel.
+// Returns false if the file could not be mapped, the caller shall fall back to stl_read().
+static bool stl_read_binary_mapped(stl_file *stl, const char *file)
+{
+	boost::iostreams::mapped_file_source mapped;
+	try {
+		mapped.open(file);
+	} catch (const std::exception &ex) {
+		BOOST_LOG_TRIVIAL(info) << "stl_read_binary_mapped: Couldn't map " << file << ", falling back to buffered reading: " << ex.what();
+		return false;
+	}
+	const uint32_t num_facets = stl->stats.number_of_facets;
+	if (! mapped.is_open() || mapped.size() < HEADER_SIZE + size_t(num_facets) * SIZEOF_STL_FACET)
+		return false;
+	const char *data = mapped.data() + HEADER_SIZE;
+
+	struct MinMax {
+		stl_vertex min { FLT_MAX, FLT_MAX, FLT_MAX };
+		stl_vertex max { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	};
+	MinMax bbox = tbb::parallel_reduce(tbb::blocked_range<uint32_t>(0, num_facets, 4096), MinMax{},
+		[stl, data](const tbb::blocked_range<uint32_t> &range, MinMax bbox) {
+			for (uint32_t i = range.begin(); i < range.end(); ++ i) {
+				stl_facet &facet = stl->facet_start[i];
+				// The facets are packed by 50 bytes in the file, thus they are not aligned, copy them.
+				memcpy(&facet, data + size_t(i) * SIZEOF_STL_FACET, SIZEOF_STL_FACET);
+#if BOOST_ENDIAN_BIG_BYTE
+				// Convert the loaded little endian data to big endian.
+				stl_internal_reverse_quads((char*)&facet, 48);
+#endif /* BOOST_ENDIAN_BIG_BYTE */
+				for (size_t j = 0; j < 3; ++ j) {
+					bbox.min = bbox.min.cwiseMin(facet.vertex[j]);
+					bbox.max = bbox.max.cwiseMax(facet.vertex[j]);
+				}
+			}
+			return bbox;
+		},
+		[](const MinMax &l, const MinMax &r) { return MinMax{ l.min.cwiseMin(r.min), l.max.cwiseMax(r.max) }; });
+
+	// Same statistics as collected by stl_facet_stats().
+	const stl_facet &first = stl->facet_start.front();
+	stl_vertex diff = (first.vertex[1] - first.vertex[0]).cwiseAbs();
+	stl->stats.shortest_edge = std::max(diff(0), std::max(diff(1), diff(2)));
+	stl->stats.min = bbox.min;
+	stl->stats.max = bbox.max;
+	stl->stats.size = stl->stats.max - stl->stats.min;
+	stl->stats.bounding_diameter = stl->stats.size.norm();
+	return true;
+}
+
 bool stl_open(stl_file *stl, const char *file)
 {
     Slic3r::CNumericLocalesSetter locales_setter;
@@ -240,6 +298,16 @@ bool stl_open(stl_file *stl, const char *file)
 	if (fp == nullptr)
 		return false;
 	stl_allocate(stl);
+	if (stl->stats.type == binary && stl->stats.number_of_facets >= STL_MAPPED_MIN_FACETS) {
+		// Large binary files are decoded in parallel from a memory mapped file.
+		fclose(fp);
+		if (stl_read_binary_mapped(stl, file))
+			return true;
+		if ((fp = boost::nowide::fopen(file, "rb")) == nullptr) {
+			BOOST_LOG_TRIVIAL(error) << "stl_open: Couldn't open " << file << " for reading";
+			return false;
+		}
+	}
 	bool result = stl_read(stl, fp, 0, true);
   	fclose(fp);
   	return result;
@@ -115,9 +115,14 @@ using DoublePoint = Eigen::Matrix<double, 2, 1, Eigen::DontAlign>;
 
 //------------------------------------------------------------------------------
 
+#ifdef CLIPPERLIB_ALLOCATOR
+template<typename BaseType>
+using Allocator = CLIPPERLIB_ALLOCATOR<BaseType>;
+#else // CLIPPERLIB_ALLOCATOR
 template<typename BaseType>
 using Allocator = tbb::scalable_allocator<BaseType>;
 //using Allocator = std::allocator<BaseType>;
+#endif // CLIPPERLIB_ALLOCATOR
 using Path      = std::vector<IntPoint, Allocator<IntPoint>>;
 using Paths     = std::vector<Path, Allocator<Path>>;
 
@@ -44,6 +44,15 @@ public:
                                                   m_tree, s, dir, hit, m_triangle_ray_epsilon);
     }
 
+    void intersect_rays(const indexed_triangle_set &its,
+                        const std::vector<Vec3d> &  sources,
+                        const std::vector<Vec3d> &  dirs,
+                        std::vector<igl::Hit> &     hits)
+    {
+        AABBTreeIndirect::intersect_rays_first_hit(its.vertices, its.indices,
+                                                   m_tree, sources, dirs, hits, m_triangle_ray_epsilon);
+    }
+
     void intersect_ray(const indexed_triangle_set &its,
                        const Vec3d &               s,
                        const Vec3d &               dir,
@@ -176,6 +185,40 @@ AABBMesh::query_ray_hit(const Vec3d &s, const Vec3d &dir) const
     return ret;
 }
 
+std::vector<AABBMesh::hit_result>
+AABBMesh::query_ray_hit(const std::vector<Vec3d> &sources, const std::vector<Vec3d> &dirs) const
+{
+    assert(sources.size() == dirs.size());
+    std::vector<hit_result> outs;
+    outs.reserve(sources.size());
+
+#ifdef SLIC3R_HOLE_RAYCASTER
+    if (! m_holes.empty()) {
+        for (size_t i = 0; i < sources.size(); ++ i)
+            outs.emplace_back(this->query_ray_hit(sources[i], dirs[i]));
+        return outs;
+    }
+#endif
+
+    std::vector<igl::Hit> hits;
+    m_aabb->intersect_rays(*m_tm, sources, dirs, hits);
+    for (size_t i = 0; i < hits.size(); ++ i) {
+        assert(is_approx(dirs[i].norm(), 1.));
+        const igl::Hit &hit = hits[i];
+        outs.push_back(hit_result(*this));
+        hit_result     &ret = outs.back();
+        ret.m_t = double(hit.t);
+        ret.m_dir = dirs[i];
+        ret.m_source = sources[i];
+        if (!std::isinf(hit.t) && !std::isnan(hit.t)) {
+            ret.m_normal = this->normal_by_face_id(hit.id);
+            ret.m_face_id = hit.id;
+        }
+    }
+
+    return outs;
+}
+
 std::vector<AABBMesh::hit_result>
 AABBMesh::query_ray_hits(const Vec3d &s, const Vec3d &dir) const
 {
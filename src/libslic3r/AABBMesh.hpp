@@ -120,6 +120,11 @@ public:
 
     // Casting a ray on the mesh, returns the distance where the hit occures.
     hit_result query_ray_hit(const Vec3d &s, const Vec3d &dir) const;
+
+    // Casting a bundle of rays on the mesh, returns the same hits as query_ray_hit() called for each ray.
+    // The rays are traced through the AABB tree together, which is faster for coherent rays,
+    // for example rays around a support pin or rays sharing a source.
+    std::vector<hit_result> query_ray_hit(const std::vector<Vec3d> &sources, const std::vector<Vec3d> &dirs) const;
     
     // Casts a ray on the mesh and returns all hits
     std::vector<hit_result> query_ray_hits(const Vec3d &s, const Vec3d &dir) const;
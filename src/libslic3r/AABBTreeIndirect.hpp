@@ -12,11 +12,18 @@
 
 #include <algorithm>
 #include <limits>
+#include <numeric>
 #include <type_traits>
 #include <vector>
 
 #include <Eigen/Geometry>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_invoke.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/task_arena.h>
+
 #include "BoundingBox.hpp"
 #include "Utils.hpp" // for next_highest_power_of_2()
 
@@ -101,7 +108,11 @@ public:
 		else {
 			// Allocate enough memory for a full binary tree.
             m_nodes.assign(next_highest_power_of_2(input.size()) * 2 - 1, Node());
-            build_recursive(input, 0, 0, input.size() - 1);
+            if (input.size() < parallel_build_min_entities)
+                build_recursive(input, 0, 0, input.size() - 1);
+            else
+                // Don't let the waiting threads steal unrelated tasks, the tree may be built while holding a lock.
+                tbb::this_task_arena::isolate([this, &input]() { build_recursive(input, 0, 0, input.size() - 1); });
 		}
 	}
 
@@ -123,6 +134,11 @@ public:
 	}
 
 private:
+	// Subtrees with at least this number of entities are built in parallel.
+	// The left and right subtrees are built from disjoint ranges of the input into disjoint nodes,
+	// therefore the tree built in parallel is the same as the tree built serially.
+	static constexpr const size_t parallel_build_min_entities = 16384;
+
 	// Build a balanced tree by splitting the input sequence by an axis aligned plane at a dimension.
 	template<typename SourceNode>
 	void build_recursive(std::vector<SourceNode> &input, size_t node, const size_t left, const size_t right)
@@ -137,9 +153,19 @@ private:
 		}
 
 		// Calculate bounding box of the input.
+        const bool parallel = right - left + 1 >= parallel_build_min_entities;
         BoundingBox bbox(input[left].bbox());
-        for (size_t i = left + 1; i <= right; ++ i)
-            bbox.extend(input[i].bbox());
+        if (parallel)
+            bbox = tbb::parallel_reduce(tbb::blocked_range<size_t>(left + 1, right + 1), bbox,
+                [&input](const tbb::blocked_range<size_t> &range, BoundingBox bbox) {
+                    for (size_t i = range.begin(); i < range.end(); ++ i)
+                        bbox.extend(input[i].bbox());
+                    return bbox;
+                },
+                [](const BoundingBox &l, const BoundingBox &r) { return l.merged(r); });
+        else
+            for (size_t i = left + 1; i <= right; ++ i)
+                bbox.extend(input[i].bbox());
         int dimension = -1;
         bbox.diagonal().maxCoeff(&dimension);
 
@@ -149,8 +175,14 @@ private:
 		// Insert an inner node into the tree. Inner node does not reference any input entity (triangle, line segment etc).
 		m_nodes[node].idx  = inner;
 		m_nodes[node].bbox = bbox;
-        build_recursive(input, node * 2 + 1, left, center);
-		build_recursive(input, node * 2 + 2, center + 1, right);
+        if (parallel)
+            tbb::parallel_invoke(
+                [this, &input, node, left, center]() { build_recursive(input, node * 2 + 1, left, center); },
+                [this, &input, node, center, right]() { build_recursive(input, node * 2 + 2, center + 1, right); });
+        else {
+            build_recursive(input, node * 2 + 1, left, center);
+            build_recursive(input, node * 2 + 2, center + 1, right);
+        }
 	}
 
 	// Partition the input m_nodes <left, right> at "k" and "dimension" using the QuickSelect method:
@@ -697,24 +729,26 @@ inline Tree<3, typename VertexType::Scalar> build_aabb_tree_over_indexed_triangl
         VectorType 	m_centroid;
 	};
 
-	std::vector<InputType> input;
-	input.reserve(faces.size());
+	std::vector<InputType> input(faces.size());
     const VectorType veps(eps, eps, eps);
-	for (size_t i = 0; i < faces.size(); ++ i) {
-        const IndexedFaceType &face = faces[i];
-		const VertexType &v1 = vertices[face(0)];
-		const VertexType &v2 = vertices[face(1)];
-		const VertexType &v3 = vertices[face(2)];
-		InputType n;
-        n.m_idx      = i;
-        n.m_centroid = (1./3.) * (v1 + v2 + v3);
-        n.m_bbox = BoundingBox(v1, v1);
-        n.m_bbox.extend(v2);
-        n.m_bbox.extend(v3);
-        n.m_bbox.min() -= veps;
-        n.m_bbox.max() += veps;
-        input.emplace_back(n);
-	}
+    tbb::this_task_arena::isolate([&vertices, &faces, &input, &veps]() {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, faces.size(), 4096), [&vertices, &faces, &input, &veps](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i) {
+                const IndexedFaceType &face = faces[i];
+                const VertexType &v1 = vertices[face(0)];
+                const VertexType &v2 = vertices[face(1)];
+                const VertexType &v3 = vertices[face(2)];
+                InputType &n = input[i];
+                n.m_idx      = i;
+                n.m_centroid = (1./3.) * (v1 + v2 + v3);
+                n.m_bbox = BoundingBox(v1, v1);
+                n.m_bbox.extend(v2);
+                n.m_bbox.extend(v3);
+                n.m_bbox.min() -= veps;
+                n.m_bbox.max() += veps;
+            }
+        });
+    });
 
 	TreeType out;
 	out.build(std::move(input));
@@ -792,6 +826,93 @@ inline bool intersect_ray_all_hits(
 	return ! hits.empty();
 }
 
+// Find a first intersection of each ray of a bundle with indexed triangle set.
+// The hits are the same as if intersect_ray_first_hit() was called for each ray, however the rays are traversed
+// through the AABB tree as a single stream: a tree node is visited once for all the rays that may still hit it,
+// and the rays are tested against the node bounding box or triangle in a tight loop. This saves most of the tree
+// traversal and memory fetches for coherent rays (rays sharing an origin or a direction).
+// Rays not hitting the indexed triangle set get hits[i].id == -1. Returns the number of rays hitting the triangle set.
+template<typename VertexType, typename IndexedFaceType, typename TreeType, typename VectorType>
+inline size_t intersect_rays_first_hit(
+	// Indexed triangle set - 3D vertices.
+	const std::vector<VertexType> 		&vertices,
+	// Indexed triangle set - triangular faces, references to vertices.
+	const std::vector<IndexedFaceType> 	&faces,
+	// AABBTreeIndirect::Tree over vertices & faces, bounding boxes built with the accuracy of vertices.
+	const TreeType 						&tree,
+	// Origins of the rays.
+	const std::vector<VectorType>		&origins,
+	// Directions of the rays.
+	const std::vector<VectorType>		&dirs,
+	// First intersection of each ray with the indexed triangle set.
+	std::vector<igl::Hit> 				&hits,
+	// Epsilon for the ray-triangle intersection, it should be proportional to an average triangle edge length.
+	const double 						 eps = 0.000001)
+{
+    using Scalar = typename VectorType::Scalar;
+    assert(origins.size() == dirs.size());
+    const size_t num_rays = origins.size();
+    hits.assign(num_rays, igl::Hit{ -1, -1, 0.f, 0.f, std::numeric_limits<float>::infinity() });
+    if (tree.empty() || num_rays == 0)
+        return 0;
+
+    std::vector<VectorType> invdirs;
+    invdirs.reserve(num_rays);
+    for (const VectorType &dir : dirs)
+        invdirs.emplace_back(dir.cwiseInverse());
+    std::vector<Scalar> min_t(num_rays, std::numeric_limits<Scalar>::infinity());
+
+    // Indices of the rays that may hit the nodes on the traversal stack. Each stack frame references a range of rays
+    // filtered by its parent node. The ranges of the frames above a frame on the stack are stored after its range.
+    std::vector<uint32_t> active(num_rays);
+    std::iota(active.begin(), active.end(), 0);
+    struct Frame {
+        size_t node_idx;
+        size_t begin;
+        size_t end;
+    };
+    std::vector<Frame> stack { { 0, 0, num_rays } };
+    size_t num_hits = 0;
+    while (! stack.empty()) {
+        const Frame frame = stack.back();
+        stack.pop_back();
+        const auto &node = tree.node(frame.node_idx);
+        assert(node.is_valid());
+        const auto  bbox = node.bbox.template cast<Scalar>();
+        // The ranges of the already traversed subtrees are no more needed.
+        active.resize(frame.end);
+        for (size_t i = frame.begin; i < frame.end; ++ i)
+            if (const uint32_t iray = active[i]; detail::ray_box_intersect_invdir(origins[iray], invdirs[iray], bbox, Scalar(0), min_t[iray]))
+                active.emplace_back(iray);
+        const size_t begin = frame.end;
+        const size_t end   = active.size();
+        if (begin == end)
+            continue;
+        if (node.is_leaf()) {
+            const auto        face = faces[node.idx];
+            const VertexType &v0   = vertices[face(0)];
+            const VertexType &v1   = vertices[face(1)];
+            const VertexType &v2   = vertices[face(2)];
+            for (size_t i = begin; i < end; ++ i) {
+                const uint32_t iray = active[i];
+                double t, u, v;
+                if (detail::intersect_triangle(origins[iray], dirs[iray], v0, v1, v2, t, u, v, eps) && t > 0. && float(t) < min_t[iray]) {
+                    igl::Hit &hit = hits[iray];
+                    if (hit.id == -1)
+                        ++ num_hits;
+                    hit = igl::Hit { int(node.idx), -1, float(u), float(v), float(t) };
+                    min_t[iray] = hit.t;
+                }
+            }
+        } else {
+            // Traverse the left child first, as intersect_ray_first_hit() does, to produce the same hits.
+            stack.push_back({ frame.node_idx * 2 + 2, begin, end });
+            stack.push_back({ frame.node_idx * 2 + 1, begin, end });
+        }
+    }
+    return num_hits;
+}
+
 // Finding a closest triangle, its closest point and squared distance to the closest point
 // on a 3D indexed triangle set using a pre-built AABBTreeIndirect::Tree.
 // Closest point to triangle test will be performed with the accuracy of VectorType::Scalar
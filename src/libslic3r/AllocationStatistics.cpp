@@ -0,0 +1,63 @@
+#include "AllocationStatistics.hpp"
+
+#ifdef SLIC3R_ALLOCATION_STATISTICS
+
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <boost/log/trivial.hpp>
+
+namespace Slic3r {
+
+AllocationCounters& thread_allocation_counters()
+{
+    static thread_local AllocationCounters counters;
+    return counters;
+}
+
+struct AllocationTotals
+{
+    AllocationCounters  counters;
+    uint64_t            scopes { 0 };
+};
+
+static std::mutex                               s_totals_mutex;
+static std::map<std::string, AllocationTotals>  s_totals;
+
+AllocationStatisticsScope::AllocationStatisticsScope(const char *name) :
+    m_name(name), m_start(thread_allocation_counters())
+{}
+
+AllocationStatisticsScope::~AllocationStatisticsScope()
+{
+    const AllocationCounters &end = thread_allocation_counters();
+    AllocationCounters delta;
+    delta.allocations   = end.allocations   - m_start.allocations;
+    delta.deallocations = end.deallocations - m_start.deallocations;
+    delta.bytes         = end.bytes         - m_start.bytes;
+    BOOST_LOG_TRIVIAL(trace) << "Allocations in " << m_name << ": " << delta.allocations << " allocations, " <<
+        delta.deallocations << " deallocations, " << delta.bytes << " bytes";
+
+    std::scoped_lock<std::mutex> lock(s_totals_mutex);
+    AllocationTotals &totals = s_totals[m_name];
+    totals.counters.allocations   += delta.allocations;
+    totals.counters.deallocations += delta.deallocations;
+    totals.counters.bytes         += delta.bytes;
+    ++ totals.scopes;
+}
+
+void log_allocation_statistics()
+{
+    std::scoped_lock<std::mutex> lock(s_totals_mutex);
+    for (const auto &[name, totals] : s_totals)
+        BOOST_LOG_TRIVIAL(info) << "Allocations in " << name << " (" << totals.scopes << " scopes): " <<
+            totals.counters.allocations << " allocations, " << totals.counters.deallocations << " deallocations, " <<
+            totals.counters.bytes << " bytes, " <<
+            (totals.scopes ? totals.counters.allocations / totals.scopes : 0) << " allocations per scope";
+    s_totals.clear();
+}
+
+} // namespace Slic3r
+
+#endif // SLIC3R_ALLOCATION_STATISTICS
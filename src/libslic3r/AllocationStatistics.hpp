@@ -0,0 +1,57 @@
+#ifndef slic3r_AllocationStatistics_hpp_
+#define slic3r_AllocationStatistics_hpp_
+
+// Count the allocations of the geometry containers (Points, Polygons and everything using PointsAllocator)
+// and report them per layer task of the perimeter, surface and support generators.
+// Useful to find out which kernels churn the allocator with short lived temporaries and shall use PointsArenaScope.
+// Only PointsAllocator is counted, including the allocations served by the arena: the point vectors of the contours
+// and holes of ExPolygons and Surfaces and the Clipper paths are included, the ExPolygons and Surfaces vectors
+// themselves use std::allocator and are not.
+// #define SLIC3R_ALLOCATION_STATISTICS
+
+#include <cstdint>
+
+namespace Slic3r {
+
+#ifdef SLIC3R_ALLOCATION_STATISTICS
+
+struct AllocationCounters
+{
+    uint64_t allocations    { 0 };
+    uint64_t deallocations  { 0 };
+    uint64_t bytes          { 0 };
+};
+
+// Allocation counters of the calling thread.
+AllocationCounters& thread_allocation_counters();
+
+// Reports the allocations performed by the calling thread during the lifetime of the scope
+// and accumulates them into per-name totals, see log_allocation_statistics().
+// If the scope waits for nested TBB tasks, allocations of other tasks stolen by this thread are counted as well.
+class AllocationStatisticsScope
+{
+public:
+    explicit AllocationStatisticsScope(const char *name);
+    ~AllocationStatisticsScope();
+
+private:
+    const char          *m_name;
+    AllocationCounters   m_start;
+};
+
+// Log the totals accumulated by all AllocationStatisticsScopes so far and reset them.
+void log_allocation_statistics();
+
+#define SLIC3R_ALLOCATION_STATISTICS_SCOPE(name) ::Slic3r::AllocationStatisticsScope allocation_statistics_scope(name)
+
+#else // SLIC3R_ALLOCATION_STATISTICS
+
+inline void log_allocation_statistics() {}
+
+#define SLIC3R_ALLOCATION_STATISTICS_SCOPE(name) do {} while (false)
+
+#endif // SLIC3R_ALLOCATION_STATISTICS
+
+} // namespace Slic3r
+
+#endif // slic3r_AllocationStatistics_hpp_
@@ -0,0 +1,89 @@
+#include "NFPCache.hpp"
+
+#include <mutex>
+
+#include <boost/functional/hash.hpp>
+
+namespace Slic3r { namespace arr2 {
+
+ShapeFingerprint shape_fingerprint(const Polygons &shape)
+{
+    ShapeFingerprint ret;
+
+    size_t seed = shape.size();
+    for (const Polygon &poly : shape) {
+        boost::hash_combine(seed, poly.size());
+        for (const Point &p : poly) {
+            boost::hash_combine(seed, p.x());
+            boost::hash_combine(seed, p.y());
+        }
+        ret.npoints += poly.size();
+    }
+    ret.hash = seed;
+
+    return ret;
+}
+
+size_t NFPCache::KeyHash::operator()(const Key &key) const
+{
+    size_t seed = key.fixed.hash;
+    boost::hash_combine(seed, key.fixed.npoints);
+    boost::hash_combine(seed, key.fixed_rotation);
+    boost::hash_combine(seed, key.movable.hash);
+    boost::hash_combine(seed, key.movable.npoints);
+    boost::hash_combine(seed, key.movable_rotation);
+
+    return seed;
+}
+
+NFPCache &NFPCache::instance()
+{
+    static NFPCache cache;
+    return cache;
+}
+
+std::optional<Polygons> NFPCache::find(const Key &key, const Polygons &fixed, const Polygons &movable) const
+{
+    std::shared_lock lock(m_mutex);
+    auto [begin, end] = m_nfps.equal_range(key);
+    for (auto it = begin; it != end; ++it)
+        if (it->second.fixed == fixed && it->second.movable == movable)
+            return it->second.nfp;
+
+    return std::nullopt;
+}
+
+void NFPCache::insert(const Key &key, const Polygons &fixed, const Polygons &movable, Polygons nfp)
+{
+    size_t npoints = count_points(nfp) + count_points(fixed) + count_points(movable);
+
+    std::unique_lock lock(m_mutex);
+    if (m_npoints + npoints > MaxPoints) {
+        m_nfps.clear();
+        m_npoints = 0;
+    }
+
+    // Another thread may have inserted the same NFP in the meantime.
+    auto [begin, end] = m_nfps.equal_range(key);
+    for (auto it = begin; it != end; ++it)
+        if (it->second.fixed == fixed && it->second.movable == movable)
+            return;
+
+    m_nfps.emplace(key, Entry{ fixed, movable, std::move(nfp) });
+    m_npoints += npoints;
+}
+
+void NFPCache::clear()
+{
+    std::unique_lock lock(m_mutex);
+    m_nfps.clear();
+    m_npoints = 0;
+}
+
+size_t NFPCache::size() const
+{
+    std::shared_lock lock(m_mutex);
+    return m_nfps.size();
+}
+
+}} // namespace Slic3r::arr2
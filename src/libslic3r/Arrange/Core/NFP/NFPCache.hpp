@@ -0,0 +1,91 @@
+#ifndef NFPCACHE_HPP
+#define NFPCACHE_HPP
+
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include <libslic3r/Polygon.hpp>
+
+namespace Slic3r { namespace arr2 {
+
+// Fingerprint of a shape in its own coordinate system, before rotation and
+// translation. Identical shapes, like the instances or copies of an object,
+// have the same fingerprint.
+struct ShapeFingerprint
+{
+    uint64_t hash    = 0;
+    size_t   npoints = 0;
+
+    bool operator==(const ShapeFingerprint &other) const
+    {
+        return hash == other.hash && npoints == other.npoints;
+    }
+};
+
+ShapeFingerprint shape_fingerprint(const Polygons &shape);
+
+// Cache of the no-fit polygons of a moving shape against a fixed shape,
+// keyed by the fingerprints and rotations of both shapes. The entries keep
+// copies of both shapes, which have to be equal for a hit, so that two shapes
+// with colliding fingerprints never share an NFP. The NFP is stored
+// for the fixed shape placed at the origin, it only has to be translated by
+// the translation of the fixed shape when retrieved, the translation of the
+// moving shape does not matter.
+//
+// A single instance is shared by all the beds of an arrangement and by the
+// consecutive arrange, fill bed and multiply selection runs, so the NFPs of
+// repeated part types are calculated only once. The cache is thread safe.
+class NFPCache
+{
+public:
+    struct Key
+    {
+        ShapeFingerprint fixed;
+        double           fixed_rotation = 0.;
+        ShapeFingerprint movable;
+        double           movable_rotation = 0.;
+
+        bool operator==(const Key &other) const
+        {
+            return fixed == other.fixed && fixed_rotation == other.fixed_rotation &&
+                   movable == other.movable && movable_rotation == other.movable_rotation;
+        }
+    };
+
+    // The cache is dropped when the stored NFPs exceed this number of points.
+    static constexpr size_t MaxPoints = 4000000;
+
+    static NFPCache &instance();
+
+    // fixed and movable are the shapes the fingerprints of the key were calculated from.
+    std::optional<Polygons> find(const Key &key, const Polygons &fixed, const Polygons &movable) const;
+    void                    insert(const Key &key, const Polygons &fixed, const Polygons &movable, Polygons nfp);
+
+    void   clear();
+    size_t size() const;
+
+private:
+    struct KeyHash
+    {
+        size_t operator()(const Key &key) const;
+    };
+
+    struct Entry
+    {
+        Polygons fixed;
+        Polygons movable;
+        Polygons nfp;
+    };
+
+    mutable std::shared_mutex                    m_mutex;
+    // Multimap, as different shapes may have the same fingerprint.
+    std::unordered_multimap<Key, Entry, KeyHash> m_nfps;
+    // Of the NFPs and of the shapes stored.
+    size_t                                       m_npoints = 0;
+};
+
+}} // namespace Slic3r::arr2
+
+#endif // NFPCACHE_HPP
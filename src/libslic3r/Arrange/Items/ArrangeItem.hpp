@@ -15,6 +15,7 @@
 #include "libslic3r/Arrange/Core/PackingContext.hpp"
 #include "libslic3r/Arrange/Core/NFP/NFPArrangeItemTraits.hpp"
 #include "libslic3r/Arrange/Core/NFP/NFP.hpp"
+#include "libslic3r/Arrange/Core/NFP/NFPCache.hpp"
 
 #include "libslic3r/Arrange/Items/MutableItemTraits.hpp"
 
@@ -26,6 +27,7 @@
 #include "libslic3r/Arrange/Items/ArbitraryDataStore.hpp"
 
 #include <libslic3r/ClipperUtils.hpp>
+#include <libslic3r/Execution/ExecutionTBB.hpp>
 
 namespace Slic3r { namespace arr2 {
 
@@ -47,6 +49,7 @@ inline bool check_polygons_are_convex(const Polygons &pp) {
 class DecomposedShape
 {
     Polygons m_shape;
+    ShapeFingerprint m_fingerprint; // Of m_shape, which is not modified after construction
 
     Vec2crd m_translation{0, 0}; // The translation of the poly
     double  m_rotation{0.0};     // The rotation of the poly in radians
@@ -72,6 +75,7 @@ public:
     explicit DecomposedShape(Polygon sh)
     {
         m_shape.emplace_back(std::move(sh));
+        m_fingerprint = shape_fingerprint(m_shape);
         assert(check_polygons_are_convex(m_shape));
     }
 
@@ -79,12 +83,14 @@ public:
         : DecomposedShape(Polygon{pts})
     {}
 
-    explicit DecomposedShape(Polygons sh) : m_shape{std::move(sh)}
+    explicit DecomposedShape(Polygons sh)
+        : m_shape{std::move(sh)}, m_fingerprint{shape_fingerprint(m_shape)}
     {
         assert(check_polygons_are_convex(m_shape));
     }
 
     const Polygons &contours() const { return m_shape; }
+    const ShapeFingerprint &fingerprint() const { return m_fingerprint; }
 
     const Vec2crd &translation() const { return m_translation; }
     double         rotation() const { return m_rotation; }
@@ -281,62 +287,96 @@ template<> struct WritableDataStoreTraits_<ArrangeItem>
     }
 };
 
+// The sub-nfps of the item with each of the fixed items are calculated in
+// parallel, then they are merged with pairwise unions in parallel as well.
+// The sub-nfps are looked up in the NFPCache first, so they are calculated only
+// once for each pair of distinct shapes and rotations.
 template<class FixedIt, class StopCond = DefaultStopCondition>
 static Polygons calculate_nfp_unnormalized(const ArrangeItem    &item,
                                            const Range<FixedIt> &fixed_items,
                                            StopCond &&stop_cond = {})
 {
-    size_t cap = 0;
+    const Polygons &item_outlines = item.envelope().transformed_outline();
 
-    for (const ArrangeItem &fixitem : fixed_items) {
-        const Polygons &outlines = fixitem.shape().transformed_outline();
-        cap += outlines.size();
-    }
+    // Also fills the caches of the per outline reference and min vertices,
+    // the item is accessed only for reading by the parallel tasks.
+    Vec2crd ref_whole = item.envelope().reference_vertex();
 
-    const Polygons &item_outlines = item.envelope().transformed_outline();
+    std::vector<Polygons> fixed_nfps(fixed_items.size());
+    NFPCache &cache = NFPCache::instance();
 
-    auto nfps = reserve_polygons(cap * item_outlines.size());
+    execution::for_each(ex_tbb, size_t(0), fixed_items.size(),
+        [&item, &item_outlines, &ref_whole, &fixed_items, &fixed_nfps, &cache, &stop_cond](size_t fixed_idx) {
+            if (stop_cond())
+                return;
+
+            const ArrangeItem &fixed = *std::next(fixed_items.begin(), fixed_idx);
+            Polygons &nfps = fixed_nfps[fixed_idx];
+
+            // The sub-nfp only depends on the shapes and rotations of the items
+            // and it moves together with the fixed item.
+            NFPCache::Key key{fixed.shape().fingerprint(), fixed.shape().rotation(),
+                              item.envelope().fingerprint(), item.envelope().rotation()};
+            const Vec2crd &fixed_tr = fixed.shape().translation();
+            if (std::optional<Polygons> cached = cache.find(key, fixed.shape().contours(), item.envelope().contours()); cached) {
+                nfps = std::move(*cached);
+                for (Polygon &p : nfps)
+                    p.translate(fixed_tr);
+                return;
+            }
 
-    Vec2crd ref_whole = item.envelope().reference_vertex();
-    Polygon subnfp;
-
-    for (const ArrangeItem &fixed : fixed_items) {
-        // fixed_polys should already be a set of strictly convex polygons,
-        // as ArrangeItem stores convex-decomposed polygons
-        const Polygons & fixed_polys = fixed.shape().transformed_outline();
-
-        for (const Polygon &fixed_poly : fixed_polys) {
-            Point max_fixed = Slic3r::reference_vertex(fixed_poly);
-            for (size_t mi = 0; mi < item_outlines.size(); ++mi) {
-                const Polygon &movable = item_outlines[mi];
-                const Vec2crd &mref = item.envelope().reference_vertex(mi);
-                subnfp = nfp_convex_convex_legacy(fixed_poly, movable);
-
-                Vec2crd min_movable = item.envelope().min_vertex(mi);
-
-                Vec2crd dtouch = max_fixed - min_movable;
-                Vec2crd top_other = mref + dtouch;
-                Vec2crd max_nfp = Slic3r::reference_vertex(subnfp);
-                auto dnfp = top_other - max_nfp;
-
-                auto d = ref_whole - mref + dnfp;
-                subnfp.translate(d);
-                nfps.emplace_back(subnfp);
+            // fixed_polys should already be a set of strictly convex polygons,
+            // as ArrangeItem stores convex-decomposed polygons
+            const Polygons & fixed_polys = fixed.shape().transformed_outline();
+
+            nfps.reserve(fixed_polys.size() * item_outlines.size());
+
+            for (const Polygon &fixed_poly : fixed_polys) {
+                Point max_fixed = Slic3r::reference_vertex(fixed_poly);
+                for (size_t mi = 0; mi < item_outlines.size(); ++mi) {
+                    const Polygon &movable = item_outlines[mi];
+                    const Vec2crd &mref = item.envelope().reference_vertex(mi);
+                    Polygon subnfp = nfp_convex_convex_legacy(fixed_poly, movable);
+
+                    Vec2crd min_movable = item.envelope().min_vertex(mi);
+
+                    Vec2crd dtouch = max_fixed - min_movable;
+                    Vec2crd top_other = mref + dtouch;
+                    Vec2crd max_nfp = Slic3r::reference_vertex(subnfp);
+                    auto dnfp = top_other - max_nfp;
+
+                    auto d = ref_whole - mref + dnfp;
+                    subnfp.translate(d);
+                    nfps.emplace_back(std::move(subnfp));
+                }
             }
 
-            if (stop_cond())
-                break;
+            if (nfps.size() > 1)
+                nfps = union_(nfps);
 
-            nfps = union_(nfps);
-        }
+            Polygons normalized = nfps;
+            for (Polygon &p : normalized)
+                p.translate(-fixed_tr);
+            cache.insert(key, fixed.shape().contours(), item.envelope().contours(), std::move(normalized));
+        });
 
-        if (stop_cond()) {
-            nfps.clear();
-            break;
-        }
+    // Merge the sub-nfps with pairwise unions, halving their count in each round.
+    while (fixed_nfps.size() > 1 && !stop_cond()) {
+        std::vector<Polygons> merged((fixed_nfps.size() + 1) / 2);
+        execution::for_each(ex_tbb, size_t(0), merged.size(),
+            [&fixed_nfps, &merged](size_t i) {
+                if (2 * i + 1 < fixed_nfps.size())
+                    merged[i] = union_(fixed_nfps[2 * i], fixed_nfps[2 * i + 1]);
+                else
+                    merged[i] = std::move(fixed_nfps[2 * i]);
+            });
+        fixed_nfps = std::move(merged);
     }
 
-    return nfps;
+    if (fixed_nfps.empty() || stop_cond())
+        return {};
+
+    return std::move(fixed_nfps.front());
 }
 
 template<> struct NFPArrangeItemTraits_<ArrangeItem> {
@@ -21,7 +21,9 @@
 #include <unordered_set>
 #include <mutex>
 
+#include <tbb/blocked_range.h>
 #include <tbb/parallel_for.h>
+#include <boost/functional/hash.hpp>
 #include <boost/thread/lock_guard.hpp>
 
 #ifndef NDEBUG
@@ -999,39 +1001,56 @@ Polylines reorder_brim_polyline(Polylines lines, ExtrusionEntityCollection& out,
     return lines_sorted;
 }
 
-//note: unbrimmable must keep its ordering. don't union_ex it.
+// Hash of the settings the brim footprint of the object depends on, see BrimFootprint.
+static size_t brim_footprint_key(const PrintObject &object, const PrintObjectConfig &brim_config, const Flow &flow, coordf_t scaled_resolution_brim, bool ears)
+{
+    size_t seed = ears ? 1 : 2;
+    boost::hash_combine(seed, brim_config.brim_separation.value);
+    boost::hash_combine(seed, brim_config.brim_inside_holes.value && brim_config.brim_width_interior == 0);
+    boost::hash_combine(seed, flow.spacing_ratio());
+    if (ears) {
+        boost::hash_combine(seed, object.config().brim_ears_detection_length.value);
+        boost::hash_combine(seed, brim_config.brim_ears_max_angle.value);
+        boost::hash_combine(seed, object.config().raft_first_layer_density.get_abs_value(1.) > 0.3);
+        boost::hash_combine(seed, flow.scaled_width());
+    } else
+        boost::hash_combine(seed, scaled_resolution_brim);
+    // Zero is reserved for a footprint not calculated yet.
+    return seed == 0 ? 1 : seed;
+}
 
-//TODO: test if no regression vs old _make_brim.
-// this new one can extrude brim for an object inside an other object.
-void make_brim(const Print& print, const Flow& flow, const PrintObjectPtrs& objects, ExPolygons& unbrimmable, ExtrusionEntityCollection& out) {
-    const coord_t scaled_spacing = flow.scaled_spacing();
-    const PrintObjectConfig& brim_config = objects.front()->config();
-    coord_t brim_offset = scale_t(brim_config.brim_separation.value);
-    ExPolygons    islands;
-    for (PrintObject* object : objects) {
-        ExPolygons object_islands;
-        for (const ExPolygon &expoly : object->layers().front()->lslices()) {
-            if (brim_config.brim_inside_holes && brim_config.brim_width_interior == 0) {
-                if (brim_offset == 0) {
-                    object_islands.push_back(expoly);
-                } else {
-                    for (ExPolygon &grown_expoly : offset_ex(expoly, brim_offset)) {
-                        object_islands.push_back(std::move(grown_expoly));
-                    }
+// First layer islands of the object grown by brim_separation, supports are appended to support_islands
+// if that is not null, otherwise to the islands.
+static ExPolygons brim_object_islands(const PrintObject &object, const PrintObjectConfig &brim_config, const Flow &flow, ExPolygons *support_islands)
+{
+    const coord_t brim_offset = scale_t(brim_config.brim_separation.value);
+    ExPolygons    object_islands;
+    for (const ExPolygon &expoly : object.layers().front()->lslices()) {
+        if (brim_config.brim_inside_holes && brim_config.brim_width_interior == 0) {
+            if (brim_offset == 0) {
+                object_islands.push_back(expoly);
+            } else {
+                for (ExPolygon &grown_expoly : offset_ex(expoly, brim_offset)) {
+                    object_islands.push_back(std::move(grown_expoly));
                 }
+            }
+        } else {
+            if (brim_offset == 0) {
+                object_islands.push_back(to_expolygon(expoly.contour));
             } else {
-                if (brim_offset == 0) {
-                    object_islands.push_back(to_expolygon(expoly.contour));
-                } else {
-                    for (ExPolygon &grown_expoly : offset_ex(to_expolygon(expoly.contour), brim_offset)) {
-                        object_islands.push_back(std::move(grown_expoly));
-                    }
+                for (ExPolygon &grown_expoly : offset_ex(to_expolygon(expoly.contour), brim_offset)) {
+                    object_islands.push_back(std::move(grown_expoly));
                 }
             }
         }
-        if (!object->support_layers().empty()) {
-            ExPolygons polys = union_ex(object->support_layers().front()->support_fills.polygons_covered_by_spacing(flow.spacing_ratio(), float(SCALED_EPSILON)));
-            for (ExPolygon& poly : polys) {
+    }
+    if (!object.support_layers().empty()) {
+        ExPolygons polys = union_ex(object.support_layers().front()->support_fills.polygons_covered_by_spacing(flow.spacing_ratio(), float(SCALED_EPSILON)));
+        if (support_islands != nullptr) {
+            // offset2+- to avoid bits of brim inside the raft
+            append(*support_islands, closing_ex(polys, flow.scaled_width() * 2));
+        } else {
+            for (ExPolygon &poly : polys) {
                 if (brim_offset == 0) {
                     object_islands.push_back(std::move(poly));
                 } else {
@@ -1039,30 +1058,95 @@ void make_brim(const Print& print, const Flow& flow, const PrintObjectPtrs& obje
                 }
             }
         }
-        islands.reserve(islands.size() + object_islands.size() * object->instances().size());
-        for (const PrintInstance& pt : object->instances()) {
-            for (ExPolygon& poly : object_islands) {
-                islands.push_back(poly);
-                islands.back().translate(pt.shift.x(), pt.shift.y());
+    }
+    return object_islands;
+}
+
+static BrimFootprint make_brim_footprint(const PrintObject &object, const PrintObjectConfig &brim_config, const Flow &flow, coordf_t scaled_resolution_brim)
+{
+    BrimFootprint footprint;
+    // Simplification does not depend on the placement, thus it is done before the islands are shifted to the instances.
+    for (ExPolygon &expoly : brim_object_islands(object, brim_config, flow, nullptr)) {
+        for (ExPolygon &simple_expoly : expoly.simplify(scaled_resolution_brim)) {
+            simple_expoly.assert_valid();
+            footprint.islands.emplace_back(std::move(simple_expoly));
+        }
+    }
+    return footprint;
+}
+
+static BrimFootprint make_brim_ears_footprint(const PrintObject &object, const PrintObjectConfig &brim_config, const Flow &flow)
+{
+    BrimFootprint footprint;
+    //put ears over supports unless it's more than 30% fill
+    const bool ears_over_support = object.config().raft_first_layer_density.get_abs_value(1.) > 0.3;
+    footprint.islands = brim_object_islands(object, brim_config, flow, ears_over_support ? nullptr : &footprint.support_islands);
+    coord_t ear_detection_length = std::max(scale_t(object.config().brim_ears_detection_length.value), SCALED_EPSILON);
+    for (const ExPolygon &poly : footprint.islands) {
+        Polygon decimated_polygon;
+        // brim_ears_detection_length codepath
+        if (ear_detection_length > 0) {
+            //decimate polygon
+            Points points = poly.contour.points;
+            points.push_back(points.front());
+            points = MultiPoint::douglas_peucker(points, ear_detection_length);
+            if (points.size() > 4) { //don't decimate if it's going to be below 4 points, as it's surely enough to fill everything anyway
+                points.erase(points.end() - 1);
+                decimated_polygon.points = points;
+            } else {
+                decimated_polygon.points = MultiPoint::douglas_peucker(poly.contour.points, SCALED_EPSILON);
             }
         }
+        append(footprint.ears, decimated_polygon.convex_points(brim_config.brim_ears_max_angle.value * PI / 180.0));
     }
+    return footprint;
+}
 
-    print.throw_if_canceled();
+// Calculate the footprints of the objects not cached yet or calculated with different settings, in parallel.
+static void update_brim_footprints(const Flow &flow, const PrintObjectPtrs &objects, coordf_t scaled_resolution_brim, bool ears)
+{
+    const PrintObjectConfig &brim_config = objects.front()->config();
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, objects.size()), [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t object_idx = range.begin(); object_idx < range.end(); ++ object_idx) {
+            PrintObject &object = *objects[object_idx];
+            const size_t key    = brim_footprint_key(object, brim_config, flow, scaled_resolution_brim, ears);
+            if (object.brim_footprint().key != key) {
+                object.brim_footprint()     = ears ? make_brim_ears_footprint(object, brim_config, flow) :
+                                                     make_brim_footprint(object, brim_config, flow, scaled_resolution_brim);
+                object.brim_footprint().key = key;
+            }
+        }
+    });
+}
 
-    //simplify & merge
+//note: unbrimmable must keep its ordering. don't union_ex it.
+
+//TODO: test if no regression vs old _make_brim.
+// this new one can extrude brim for an object inside an other object.
+void make_brim(const Print& print, const Flow& flow, const PrintObjectPtrs& objects, ExPolygons& unbrimmable, ExtrusionEntityCollection& out) {
+    const coord_t scaled_spacing = flow.scaled_spacing();
+    const PrintObjectConfig& brim_config = objects.front()->config();
     //get brim resolution (lower resolution if no arc fitting)
     coordf_t scaled_resolution_brim = (print.config().arc_fitting.value != ArcFittingType::Disabled)? scale_d(print.config().resolution) : scale_d(print.config().resolution_internal) / 10;
     scaled_resolution_brim = std::max(scaled_resolution_brim, coordf_t(SCALED_EPSILON * 10));
+
+    update_brim_footprints(flow, objects, scaled_resolution_brim, false);
+    print.throw_if_canceled();
+
+    //merge the footprints of all the instances
     ExPolygons unbrimmable_areas;
-    for (ExPolygon &expoly : islands) {
-        for (ExPolygon &simple_expoly : expoly.simplify(scaled_resolution_brim)) {
-            simple_expoly.assert_valid();
-            unbrimmable_areas.emplace_back(std::move(simple_expoly));
+    for (const PrintObject* object : objects) {
+        const ExPolygons &object_islands = object->brim_footprint().islands;
+        unbrimmable_areas.reserve(unbrimmable_areas.size() + object_islands.size() * object->instances().size());
+        for (const PrintInstance& pt : object->instances()) {
+            for (const ExPolygon& poly : object_islands) {
+                unbrimmable_areas.push_back(poly);
+                unbrimmable_areas.back().translate(pt.shift.x(), pt.shift.y());
+            }
         }
     }
     for (ExPolygon &expoly : unbrimmable_areas) expoly.assert_valid();
-    islands = union_safety_offset_ex(unbrimmable_areas);
+    ExPolygons islands = union_safety_offset_ex(unbrimmable_areas);
     // union_safety_offset_ex can shorten segments below epsilon. So we need to re-simplify a bit.
     for (ExPolygon &expoly : islands) {
         for (ExPolygon &simple_expoly : expoly.simplify(SCALED_EPSILON)) {
@@ -1176,77 +1260,29 @@ void make_brim(const Print& print, const Flow& flow, const PrintObjectPtrs& obje
 
 void make_brim_ears(const Print& print, const Flow& flow, const PrintObjectPtrs& objects, ExPolygons& unbrimmable, ExtrusionEntityCollection& out) {
     const PrintObjectConfig& brim_config = objects.front()->config();
+
+    update_brim_footprints(flow, objects, 0., true);
+    print.throw_if_canceled();
+
+    //merge the footprints of all the instances
     Points pt_ears;
-    coord_t brim_offset = scale_t(brim_config.brim_separation.value);
     ExPolygons islands;
     ExPolygons unbrimmable_with_support = unbrimmable;
-    for (PrintObject* object : objects) {
-        ExPolygons object_islands;
-        ExPolygons support_island;
-        for (const ExPolygon& expoly : object->layers().front()->lslices()) {
-            if (brim_config.brim_inside_holes && brim_config.brim_width_interior == 0) {
-                if (brim_offset == 0) {
-                    object_islands.push_back(expoly);
-                } else {
-                    for (ExPolygon& grown_expoly : offset_ex(expoly, brim_offset)) {
-                        object_islands.push_back(std::move(grown_expoly));
-                    }
-                }
-            } else {
-                if (brim_offset == 0) {
-                    object_islands.push_back(to_expolygon(expoly.contour));
-                } else {
-                    for (const ExPolygon& grown_expoly : offset_ex(to_expolygon(expoly.contour), brim_offset)) {
-                        object_islands.push_back(std::move(grown_expoly));
-                    }
-                }
-            }
-        }
-
-        if (!object->support_layers().empty()) {
-            ExPolygons polys = union_ex(object->support_layers().front()->support_fills.polygons_covered_by_spacing(flow.spacing_ratio(), float(SCALED_EPSILON)));
-            //put ears over supports unless it's more than 30% fill
-            if (object->config().raft_first_layer_density.get_abs_value(1.) > 0.3) {
-                for (ExPolygon& poly : polys) {
-                    if (brim_offset == 0) {
-                        object_islands.push_back(std::move(poly));
-                    } else {
-                        append(object_islands, offset_ex(ExPolygons{ poly }, brim_offset));
-                    }
-                }
-            } else {
-                // offset2+- to avoid bits of brim inside the raft
-                append(support_island, closing_ex(polys, flow.scaled_width() * 2));
-            }
-        }
-        islands.reserve(islands.size() + object_islands.size() * object->instances().size());
-        coord_t ear_detection_length = std::max(scale_t(object->config().brim_ears_detection_length.value), SCALED_EPSILON);
+    for (const PrintObject* object : objects) {
+        const BrimFootprint &footprint = object->brim_footprint();
+        islands.reserve(islands.size() + footprint.islands.size() * object->instances().size());
         // duplicate & translate for each instance
         for (const PrintInstance& copy_pt : object->instances()) {
-            for (const ExPolygon& poly : object_islands) {
+            for (const ExPolygon& poly : footprint.islands) {
                 islands.push_back(poly);
                 islands.back().translate(copy_pt.shift.x(), copy_pt.shift.y());
-                Polygon decimated_polygon;
-                // brim_ears_detection_length codepath
-                if (ear_detection_length > 0) {
-                    //decimate polygon
-                    Points points = poly.contour.points;
-                    points.push_back(points.front());
-                    points = MultiPoint::douglas_peucker(points, ear_detection_length);
-                    if (points.size() > 4) { //don't decimate if it's going to be below 4 points, as it's surely enough to fill everything anyway
-                        points.erase(points.end() - 1);
-                        decimated_polygon.points = points;
-                    } else {
-                        decimated_polygon.points = MultiPoint::douglas_peucker(poly.contour.points, SCALED_EPSILON);
-                    }
-                }
-                for (const Point& p : decimated_polygon.convex_points(brim_config.brim_ears_max_angle.value* PI / 180.0)) {
-                    pt_ears.push_back(p);
-                    pt_ears.back() += (copy_pt.shift);
-                }
+            }
+            for (const Point& p : footprint.ears) {
+                pt_ears.push_back(p);
+                pt_ears.back() += (copy_pt.shift);
             }
             // also for support-fobidden area
-            for (const ExPolygon& poly : support_island) {
+            for (const ExPolygon& poly : footprint.support_islands) {
                 unbrimmable_with_support.push_back(poly);
                 unbrimmable_with_support.back().translate(copy_pt.shift.x(), copy_pt.shift.y());
             }
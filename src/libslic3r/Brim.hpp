@@ -37,6 +37,21 @@ public:
     }
 };
 
+// First layer footprint of a PrintObject to be surrounded by the brim, in the PrintObject coordinates (not shifted to the instances).
+// make_brim() and make_brim_ears() calculate the footprints of their objects in parallel and cache them in the PrintObjects,
+// thus only the merge of the footprints is recalculated if the objects are just moved around the bed.
+// Reset by PrintObject::invalidate_step() when the first layer slices or supports change.
+struct BrimFootprint {
+    // Hash of the settings the footprint was calculated with, zero if not calculated.
+    size_t      key { 0 };
+    // Islands grown by brim_separation.
+    ExPolygons  islands;
+    // Supports not covered by the brim ears, kept free of the brim (brim ears only).
+    ExPolygons  support_islands;
+    // Convex corners of the islands to place the ears at (brim ears only).
+    Points      ears;
+};
+
 #if 0
 // Produce brim lines around those objects, that have the brim enabled.
 // Collect islands_area to be merged into the final 1st layer convex hull.
@@ -14,6 +14,8 @@
 #include "ShortestPath.hpp"
 #include "Utils.hpp"
 
+#include <optional>
+
 // #define CLIPPER_UTILS_TIMING
 
 #ifdef CLIPPER_UTILS_TIMING
@@ -339,6 +341,87 @@ static ClipperLib::Paths safety_offset(PathsProvider &&paths)
     return raw_offset(std::forward<PathsProvider>(paths), ClipperSafetyOffset, DefaultJoinType, DefaultMiterLimit);
 }
 
+// Boolean operations with at most this number of input points are considered small.
+// Small operations are the vast majority of calls issued by the perimeter, infill and support generators.
+static constexpr const size_t ClipperSmallInputPoints = 512;
+
+// Clipper engine for a single boolean operation.
+// Small operations reuse an engine cached per thread, so that the internal buffers of the engine (local minima,
+// joins, intersections) are not reallocated for each call. The cached engine is only cleared, not released,
+// after the operation, thus its buffers keep the capacity of a small operation at most.
+// Large operations and operations nested inside an operation running on the same thread get their own engine.
+// Note that the Clipper engine allocates through tbb::scalable_allocator, thus its memory is already served
+// from per-thread pools without contention between the worker threads.
+class ClipperEngine
+{
+public:
+    explicit ClipperEngine(size_t num_points) {
+        if (num_points <= ClipperSmallInputPoints && ! s_cached_busy) {
+            s_cached_busy = true;
+            m_clipper     = &s_cached;
+        } else
+            m_clipper = &m_local.emplace();
+    }
+    ~ClipperEngine() {
+        if (m_clipper == &s_cached) {
+            s_cached.Clear();
+            s_cached_busy = false;
+        }
+    }
+    ClipperEngine(const ClipperEngine&) = delete;
+    ClipperEngine& operator=(const ClipperEngine&) = delete;
+
+    ClipperLib::Clipper* operator->() { return m_clipper; }
+
+private:
+    ClipperLib::Clipper                    *m_clipper;
+    std::optional<ClipperLib::Clipper>      m_local;
+
+    static thread_local ClipperLib::Clipper s_cached;
+    static thread_local bool                s_cached_busy;
+};
+
+thread_local ClipperLib::Clipper ClipperEngine::s_cached;
+thread_local bool                ClipperEngine::s_cached_busy = false;
+
+template<typename PathsProvider>
+static size_t paths_num_points(const PathsProvider &paths)
+{
+    size_t num_points = 0;
+    for (const Points &path : paths)
+        num_points += path.size();
+    return num_points;
+}
+
+// Bounding box of the paths of a paths provider. Paths with zero area do not contribute to the bounding box,
+// thus the bounding box is undefined if the paths enclose no area at all.
+// The number of points of the paths is accumulated into num_points.
+template<typename PathsProvider>
+static BoundingBox paths_bounding_box(const PathsProvider &paths, size_t &num_points)
+{
+    BoundingBox bbox;
+    for (const Points &path : paths) {
+        bbox.merge(path);
+        num_points += path.size();
+    }
+    return bbox;
+}
+
+template<class TResult, class TSubj>
+TResult clipper_union(
+    TSubj &&                       subject,
+    // fillType pftNonZero and pftPositive "should" produce the same result for "normalized with implicit union" set of polygons
+    const ClipperLib::PolyFillType fillType = ClipperLib::pftNonZero)
+{
+    CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
+
+    ClipperEngine clipper(paths_num_points(subject));
+    clipper->AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
+    TResult retval;
+    clipper->Execute(ClipperLib::ctUnion, retval, fillType, fillType);
+    return retval;
+}
+
 template<class TResult, class TSubj, class TClip>
 TResult clipper_do(
     const ClipperLib::ClipType     clipType,
@@ -348,11 +431,26 @@ TResult clipper_do(
 {
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
-    ClipperLib::Clipper clipper;
-    clipper.AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
-    clipper.AddPaths(std::forward<TClip>(clip),    ClipperLib::ptClip,    true);
+    size_t num_points = 0;
+    if (clipType == ClipperLib::ctIntersection || clipType == ClipperLib::ctDifference) {
+        // Fast rejection by bounding boxes, which is exact: Clipping paths not overlapping the subject cannot modify it.
+        BoundingBox bbox_subject = paths_bounding_box(subject, num_points);
+        if (! bbox_subject.defined)
+            // Subject has no area, there is nothing to intersect with or to subtract from.
+            return TResult();
+        if (BoundingBox bbox_clip = paths_bounding_box(clip, num_points); ! bbox_clip.defined || ! bbox_subject.overlap(bbox_clip))
+            return clipType == ClipperLib::ctIntersection ?
+                TResult() :
+                // Difference with a disjoint clip is just the subject, normalized by the fill rule.
+                clipper_union<TResult>(std::forward<TSubj>(subject), fillType);
+    } else
+        num_points = paths_num_points(subject) + paths_num_points(clip);
+
+    ClipperEngine clipper(num_points);
+    clipper->AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
+    clipper->AddPaths(std::forward<TClip>(clip),    ClipperLib::ptClip,    true);
     TResult retval;
-    clipper.Execute(clipType, retval, fillType, fillType);
+    clipper->Execute(clipType, retval, fillType, fillType);
     return retval;
 }
 
@@ -371,21 +469,6 @@ TResult clipper_do(
         clipper_do<TResult>(clipType, std::forward<TSubj>(subject), std::forward<TClip>(clip), fillType);
 }
 
-template<class TResult, class TSubj>
-TResult clipper_union(
-    TSubj &&                       subject,
-    // fillType pftNonZero and pftPositive "should" produce the same result for "normalized with implicit union" set of polygons
-    const ClipperLib::PolyFillType fillType = ClipperLib::pftNonZero)
-{
-    CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
-
-    ClipperLib::Clipper clipper;
-    clipper.AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
-    TResult retval;
-    clipper.Execute(ClipperLib::ctUnion, retval, fillType, fillType);
-    return retval;
-}
-
 // Perform union of input polygons using the positive rule, convert to ExPolygons.
 //FIXME is there any benefit of not doing the boolean / using pftEvenOdd?
 inline ExPolygons ClipperPaths_to_Slic3rExPolygons(const ClipperLib::Paths &input, bool do_union)
@@ -0,0 +1,221 @@
+#include "ConfigBundleCache.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+namespace Slic3r {
+
+static constexpr const char     CACHE_MAGIC[8] = { 'S', '3', 'B', 'U', 'N', 'D', 'L', 'E' };
+// Increase if the file format or the flattening of the config bundles changes.
+static constexpr const uint32_t CACHE_FORMAT_VERSION = 1;
+
+// FNV-1a, stable between the runs and platforms.
+static uint64_t content_hash(const char *data, size_t size)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (const char *end = data + size; data != end; ++ data) {
+        hash ^= uint8_t(*data);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static bool bundle_content_hash(const boost::filesystem::path &bundle_path, uint64_t &hash)
+{
+    try {
+        boost::iostreams::mapped_file_source mapped(bundle_path.string());
+        hash = content_hash(mapped.data(), mapped.size());
+        return true;
+    } catch (const std::exception &) {
+        return false;
+    }
+}
+
+namespace {
+
+class Reader
+{
+public:
+    Reader(const char *begin, const char *end) : m_ptr(begin), m_end(end) {}
+
+    template<typename T> bool read(T &out) {
+        if (size_t(m_end - m_ptr) < sizeof(T))
+            return false;
+        memcpy(&out, m_ptr, sizeof(T));
+        m_ptr += sizeof(T);
+        return true;
+    }
+    bool read(std::string &out) {
+        uint32_t len;
+        if (! this->read(len) || size_t(m_end - m_ptr) < len)
+            return false;
+        out.assign(m_ptr, len);
+        m_ptr += len;
+        return true;
+    }
+    bool read(boost::property_tree::ptree &node) {
+        std::string data;
+        uint32_t    num_children;
+        if (! this->read(data) || ! this->read(num_children))
+            return false;
+        node.data() = std::move(data);
+        for (uint32_t i = 0; i < num_children; ++ i) {
+            std::string key;
+            if (! this->read(key))
+                return false;
+            // push_back keeps the order and the duplicate keys of the INI file.
+            if (! this->read(node.push_back(std::make_pair(std::move(key), boost::property_tree::ptree()))->second))
+                return false;
+        }
+        return true;
+    }
+    bool at_end() const { return m_ptr == m_end; }
+    const char* ptr() const { return m_ptr; }
+
+private:
+    const char *m_ptr;
+    const char *m_end;
+};
+
+class Writer
+{
+public:
+    template<typename T> void write(const T &value) { m_data.append(reinterpret_cast<const char*>(&value), sizeof(T)); }
+    void write(const std::string &str) {
+        this->write(uint32_t(str.size()));
+        m_data += str;
+    }
+    void write(const boost::property_tree::ptree &node) {
+        this->write(node.data());
+        this->write(uint32_t(node.size()));
+        for (const auto &child : node) {
+            this->write(child.first);
+            this->write(child.second);
+        }
+    }
+    const std::string& data() const { return m_data; }
+
+private:
+    std::string m_data;
+};
+
+} // namespace
+
+boost::filesystem::path config_bundle_cache_path(const boost::filesystem::path &cache_dir, const boost::filesystem::path &bundle_path)
+{
+    const std::string source_path = bundle_path.string();
+    char              hash[17];
+    ::snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)content_hash(source_path.data(), source_path.size()));
+    return cache_dir / (bundle_path.stem().string() + "-" + hash + ".bin");
+}
+
+bool load_config_bundle_cache(const boost::filesystem::path &cache_path, const boost::filesystem::path &bundle_path, boost::property_tree::ptree &tree)
+{
+    boost::system::error_code ec;
+    if (! boost::filesystem::exists(cache_path, ec))
+        return false;
+    const uintmax_t   bundle_size  = boost::filesystem::file_size(bundle_path, ec);
+    if (ec)
+        return false;
+    const std::time_t bundle_mtime = boost::filesystem::last_write_time(bundle_path, ec);
+    if (ec)
+        return false;
+
+    boost::iostreams::mapped_file_source mapped;
+    try {
+        mapped.open(cache_path.string());
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(info) << "Failed to map config bundle cache " << cache_path << ": " << ex.what();
+        return false;
+    }
+    Reader      reader(mapped.data(), mapped.data() + mapped.size());
+    char        magic[sizeof(CACHE_MAGIC)];
+    uint32_t    format_version;
+    std::string app_version;
+    std::string source_path;
+    uint64_t    size;
+    int64_t     mtime;
+    uint64_t    hash;
+    if (! reader.read(magic) || memcmp(magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        ! reader.read(format_version) || format_version != CACHE_FORMAT_VERSION ||
+        ! reader.read(app_version) || app_version != SLIC3R_VERSION ||
+        ! reader.read(source_path) || source_path != bundle_path.string() ||
+        ! reader.read(size) || size != bundle_size)
+        return false;
+    const size_t mtime_offset = size_t(reader.ptr() - mapped.data());
+    if (! reader.read(mtime) || ! reader.read(hash))
+        return false;
+    if (mtime != int64_t(bundle_mtime)) {
+        // The bundle was touched, check whether its content changed.
+        uint64_t bundle_hash;
+        if (! bundle_content_hash(bundle_path, bundle_hash) || bundle_hash != hash)
+            return false;
+    }
+
+    boost::property_tree::ptree out;
+    if (! reader.read(out) || ! reader.at_end()) {
+        BOOST_LOG_TRIVIAL(error) << "Config bundle cache " << cache_path << " is corrupted";
+        return false;
+    }
+    tree = std::move(out);
+
+    if (mtime != int64_t(bundle_mtime)) {
+        // Store the new modification time, so that the content of a touched bundle is hashed only once.
+        // A reader racing with this update sees a mismatching modification time at worst and hashes the bundle.
+        mapped.close();
+        boost::nowide::fstream file(cache_path.string(), std::ios::binary | std::ios::in | std::ios::out);
+        const int64_t new_mtime = int64_t(bundle_mtime);
+        file.seekp(std::streamoff(mtime_offset));
+        file.write(reinterpret_cast<const char*>(&new_mtime), sizeof(new_mtime));
+        if (! file)
+            BOOST_LOG_TRIVIAL(info) << "Failed to update the modification time in config bundle cache " << cache_path;
+    }
+    return true;
+}
+
+void save_config_bundle_cache(const boost::filesystem::path &cache_path, const boost::filesystem::path &bundle_path, const boost::property_tree::ptree &tree)
+{
+    boost::system::error_code ec;
+    const uintmax_t   bundle_size  = boost::filesystem::file_size(bundle_path, ec);
+    const std::time_t bundle_mtime = ec ? 0 : boost::filesystem::last_write_time(bundle_path, ec);
+    uint64_t          bundle_hash;
+    if (ec || ! bundle_content_hash(bundle_path, bundle_hash))
+        return;
+
+    Writer writer;
+    writer.write(CACHE_MAGIC);
+    writer.write(CACHE_FORMAT_VERSION);
+    writer.write(std::string(SLIC3R_VERSION));
+    writer.write(bundle_path.string());
+    writer.write(uint64_t(bundle_size));
+    writer.write(int64_t(bundle_mtime));
+    writer.write(bundle_hash);
+    writer.write(tree);
+
+    // Write into a temporary file first, so that a concurrently starting instance never maps a partially written cache.
+    boost::filesystem::path tmp_path = cache_path;
+    tmp_path += ".tmp";
+    try {
+        boost::filesystem::create_directories(cache_path.parent_path());
+        {
+            boost::nowide::ofstream file(tmp_path.string(), std::ios::binary | std::ios::trunc);
+            file.write(writer.data().data(), writer.data().size());
+            if (! file)
+                throw std::runtime_error("write failed");
+        }
+        boost::filesystem::rename(tmp_path, cache_path);
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(error) << "Failed to save config bundle cache " << cache_path << ": " << ex.what();
+        boost::filesystem::remove(tmp_path, ec);
+    }
+}
+
+} // namespace Slic3r
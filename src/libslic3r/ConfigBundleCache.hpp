@@ -0,0 +1,26 @@
+#ifndef slic3r_ConfigBundleCache_hpp_
+#define slic3r_ConfigBundleCache_hpp_
+
+#include <boost/filesystem/path.hpp>
+#include <boost/property_tree/ptree_fwd.hpp>
+
+namespace Slic3r {
+
+// Binary snapshot of a system config bundle, parsed from INI and flattened by the inheritance rules,
+// so that the vendor bundles do not have to be parsed and flattened on every start.
+// The snapshot is valid for the version of the application that wrote it and for the bundle file
+// at the same path, of the same size and either of the same modification time or of the same content hash.
+
+// Path of the snapshot of bundle_path in cache_dir. The file name is made unique by a hash of the full path of the bundle,
+// as the bundles of the same name in different directories would replace each other's snapshot otherwise.
+boost::filesystem::path config_bundle_cache_path(const boost::filesystem::path &cache_dir, const boost::filesystem::path &bundle_path);
+// Load the snapshot of bundle_path from cache_path through a memory map.
+// Returns false if there is no valid snapshot, tree is not modified in that case.
+// If only the modification time of the bundle changed, the new modification time is stored into the snapshot.
+bool load_config_bundle_cache(const boost::filesystem::path &cache_path, const boost::filesystem::path &bundle_path, boost::property_tree::ptree &tree);
+// Save the snapshot of bundle_path into cache_path. Failures are logged and otherwise ignored.
+void save_config_bundle_cache(const boost::filesystem::path &cache_path, const boost::filesystem::path &bundle_path, const boost::property_tree::ptree &tree);
+
+} // namespace Slic3r
+
+#endif // slic3r_ConfigBundleCache_hpp_
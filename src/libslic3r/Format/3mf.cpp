@@ -39,6 +39,7 @@ namespace pt = boost::property_tree;
 
 #include <expat.h>
 #include <Eigen/Dense>
+#include <tbb/parallel_for.h>
 #include "miniz_extension.hpp"
 
 #include "TextConfiguration.hpp"
@@ -86,6 +87,12 @@ const std::string MODEL_FILE = "3D/3dmodel.model"; // << this is the only format
 const std::string CONTENT_TYPES_FILE = "[Content_Types].xml";
 const std::string RELATIONSHIPS_FILE = "_rels/.rels";
 const std::string THUMBNAIL_FILE = "Metadata/thumbnail.png";
+// Model files at least this large are extracted to memory and their meshes are parsed in parallel.
+const size_t PARALLEL_MODEL_FILE_MIN_SIZE = 1024 * 1024;
+// Larger model files are streamed, keeping the whole file in memory would cost too much.
+const mz_uint64 PARALLEL_MODEL_FILE_MAX_SIZE = mz_uint64(1024) * 1024 * 1024;
+// Maximum size of the buffer passed to a single XML_Parse() call, its length is an int.
+const size_t XML_PARSE_MAX_CHUNK_SIZE = 64 * 1024 * 1024;
 
 const std::string SLIC3R_PRINT_CONFIG_FILE = "Metadata/Slic3r.config"; // gcode-style
 const std::string SUPER_PRINT_CONFIG_FILE = "Metadata/SuperSlicer.config"; // gcode-style
@@ -519,6 +526,10 @@ namespace Slic3r {
         Model* m_model;
         float m_unit_factor;
         CurrentObject m_curr_object;
+        // Geometries of the mesh elements of a large model file parsed in parallel, ordered as the mesh elements in the file.
+        // They are taken by _handle_end_mesh() while the rest of the model file is parsed.
+        std::vector<Geometry> m_preparsed_meshes;
+        size_t m_next_preparsed_mesh { 0 };
         IdToModelObjectMap m_objects;
         IdToAliasesMap m_objects_aliases;
         InstancesList m_instances;
@@ -559,6 +570,8 @@ namespace Slic3r {
         bool _load_model_from_file(const std::string& filename, Model& model, DynamicPrintConfig& config, ConfigSubstitutionContext& config_substitutions);
         bool _is_svg_shape_file(const std::string &filename) const;
         bool _extract_model_from_archive(mz_zip_archive& archive, const mz_zip_archive_file_stat& stat);
+        bool _parse_model_with_preparsed_meshes(mz_zip_archive& archive, const mz_zip_archive_file_stat& stat);
+        static bool _parse_mesh(std::string_view xml, Geometry& geometry, std::string& error);
         void _extract_cut_information_from_archive(mz_zip_archive& archive, const mz_zip_archive_file_stat& stat, ConfigSubstitutionContext& config_substitutions);
         void _extract_layer_heights_profile_config_from_archive(mz_zip_archive& archive, const mz_zip_archive_file_stat& stat);
         void _extract_layer_config_ranges_from_archive(mz_zip_archive& archive, const mz_zip_archive_file_stat& stat, ConfigSubstitutionContext& config_substitutions);
@@ -1136,6 +1149,9 @@ namespace Slic3r {
 
         try
         {
+            if (stat.m_uncomp_size >= PARALLEL_MODEL_FILE_MIN_SIZE && stat.m_uncomp_size <= PARALLEL_MODEL_FILE_MAX_SIZE)
+                res = _parse_model_with_preparsed_meshes(archive, stat);
+            else
             res = mz_zip_reader_extract_to_callback(&archive, stat.m_file_index, [](void* pOpaque, mz_uint64 file_ofs, const void* pBuf, size_t n)->size_t {
                 CallbackData* data = (CallbackData*)pOpaque;
                 if (!XML_Parse(data->parser, (const char*)pBuf, (int)n, (file_ofs + n == data->stat.m_uncomp_size) ? 1 : 0) || data->importer.parse_error()) {
@@ -1159,9 +1175,11 @@ namespace Slic3r {
         }
         catch (std::exception& e)
         {
+            m_preparsed_meshes.clear();
             add_error(e.what());
             return false;
         }
+        m_preparsed_meshes.clear();
 
         if (res == 0) {
             add_error("Error while extracting model data from ZIP archive");
@@ -1171,6 +1189,148 @@ namespace Slic3r {
         return true;
     }
 
+    // Find the content of the mesh elements of a model file, returns ranges of offsets into xml.
+    // The range is empty for a <mesh/> element.
+    static std::vector<std::pair<size_t, size_t>> find_mesh_contents(std::string_view xml)
+    {
+        std::vector<std::pair<size_t, size_t>> out;
+        const std::string_view mesh_start = "<mesh";
+        const std::string_view mesh_end   = "</mesh";
+        auto is_name_end = [&xml](size_t i) { return i < xml.size() && (xml[i] == '>' || xml[i] == '/' || xml[i] == ' ' || xml[i] == '\t' || xml[i] == '\r' || xml[i] == '\n'); };
+        for (size_t i = xml.find('<'); i != std::string_view::npos; i = xml.find('<', i + 1)) {
+            std::string_view tail = xml.substr(i);
+            if (boost::starts_with(tail, "<!--")) {
+                if ((i = xml.find("-->", i)) == std::string_view::npos)
+                    break;
+            } else if (boost::starts_with(tail, "<![CDATA[")) {
+                if ((i = xml.find("]]>", i)) == std::string_view::npos)
+                    break;
+            } else if (boost::starts_with(tail, mesh_start) && is_name_end(i + mesh_start.size())) {
+                // Find the end of the start tag, skipping the quoted attribute values.
+                size_t j = i + mesh_start.size();
+                for (char quote = 0; j < xml.size() && (quote != 0 || xml[j] != '>'); ++ j)
+                    if (quote == 0 && (xml[j] == '"' || xml[j] == '\''))
+                        quote = xml[j];
+                    else if (xml[j] == quote)
+                        quote = 0;
+                if (j == xml.size())
+                    break;
+                if (xml[j - 1] == '/') {
+                    // <mesh/>
+                    out.emplace_back(j + 1, j + 1);
+                    i = j;
+                    continue;
+                }
+                size_t k = j;
+                while ((k = xml.find(mesh_end, k)) != std::string_view::npos && ! is_name_end(k + mesh_end.size()))
+                    ++ k;
+                if (k == std::string_view::npos)
+                    break;
+                out.emplace_back(j + 1, k);
+                i = k;
+            }
+        }
+        return out;
+    }
+
+    // XML_Parse() of a buffer of any size, fed to the parser in chunks of at most XML_PARSE_MAX_CHUNK_SIZE.
+    static bool xml_parse_chunked(XML_Parser parser, std::string_view xml, bool is_final)
+    {
+        do {
+            const size_t len = std::min(xml.size(), XML_PARSE_MAX_CHUNK_SIZE);
+            if (! XML_Parse(parser, xml.data(), (int)len, (is_final && len == xml.size()) ? 1 : 0))
+                return false;
+            xml.remove_prefix(len);
+        } while (! xml.empty());
+        return true;
+    }
+
+    bool _3MF_Importer::_parse_mesh(std::string_view xml, Geometry& geometry, std::string& error)
+    {
+        struct MeshParser {
+            XML_Parser  parser;
+            Geometry   &geometry;
+        } data { XML_ParserCreate(nullptr), geometry };
+        if (data.parser == nullptr) {
+            error = "Unable to create parser";
+            return false;
+        }
+
+        XML_SetUserData(data.parser, (void*)&data);
+        XML_SetElementHandler(data.parser, [](void* user_data, const char* name, const char** attributes) {
+            MeshParser &data = *static_cast<MeshParser*>(user_data);
+            unsigned int num_attributes = (unsigned int)XML_GetSpecifiedAttributeCount(data.parser);
+            // Same as _handle_start_vertex() and _handle_start_triangle(), the vertices are scaled by the unit of the model later.
+            if (::strcmp(VERTEX_TAG, name) == 0) {
+                data.geometry.vertices.emplace_back(
+                    get_attribute_value_float(attributes, num_attributes, X_ATTR),
+                    get_attribute_value_float(attributes, num_attributes, Y_ATTR),
+                    get_attribute_value_float(attributes, num_attributes, Z_ATTR));
+            } else if (::strcmp(TRIANGLE_TAG, name) == 0) {
+                data.geometry.triangles.emplace_back(
+                    get_attribute_value_int(attributes, num_attributes, V1_ATTR),
+                    get_attribute_value_int(attributes, num_attributes, V2_ATTR),
+                    get_attribute_value_int(attributes, num_attributes, V3_ATTR));
+                data.geometry.custom_supports.push_back(get_attribute_value_string(attributes, num_attributes, CUSTOM_SUPPORTS_ATTR));
+                data.geometry.custom_seam.push_back(get_attribute_value_string(attributes, num_attributes, CUSTOM_SEAM_ATTR));
+                data.geometry.mm_segmentation.push_back(get_attribute_value_string(attributes, num_attributes, MM_SEGMENTATION_ATTR));
+            }
+        }, nullptr);
+
+        // The content of the mesh element is not a well formed document, wrap it with the mesh element.
+        const std::string_view prefix = "<mesh>";
+        const std::string_view suffix = "</mesh>";
+        bool ok = XML_Parse(data.parser, prefix.data(), (int)prefix.size(), 0) &&
+                  xml_parse_chunked(data.parser, xml, false) &&
+                  XML_Parse(data.parser, suffix.data(), (int)suffix.size(), 1);
+        if (! ok)
+            error = XML_ErrorString(XML_GetErrorCode(data.parser));
+        XML_ParserFree(data.parser);
+        return ok;
+    }
+
+    bool _3MF_Importer::_parse_model_with_preparsed_meshes(mz_zip_archive& archive, const mz_zip_archive_file_stat& stat)
+    {
+        std::string buffer((size_t)stat.m_uncomp_size, 0);
+        if (! mz_zip_reader_extract_to_mem(&archive, stat.m_file_index, (void*)buffer.data(), (size_t)stat.m_uncomp_size, 0))
+            return false;
+
+        // Parse the vertices and triangles of all meshes in parallel.
+        std::vector<std::pair<size_t, size_t>> meshes = find_mesh_contents(buffer);
+        std::vector<std::string>               errors(meshes.size());
+        m_preparsed_meshes.assign(meshes.size(), Geometry());
+        m_next_preparsed_mesh = 0;
+        tbb::parallel_for(size_t(0), meshes.size(), [this, &buffer, &meshes, &errors](size_t i) {
+            std::string_view xml = std::string_view(buffer).substr(meshes[i].first, meshes[i].second - meshes[i].first);
+            if (! xml.empty())
+                _parse_mesh(xml, m_preparsed_meshes[i], errors[i]);
+        });
+        for (size_t i = 0; i < meshes.size(); ++ i)
+            if (! errors[i].empty()) {
+                char error_buf[1024];
+                ::sprintf(error_buf, "Error (%s) while parsing mesh of '%s'", errors[i].c_str(), stat.m_filename);
+                throw Slic3r::FileIOError(error_buf);
+            }
+
+        // Parse the rest of the model file, skipping the content of the mesh elements.
+        // Line numbers reported by the parser are relative to the model file with the mesh content removed.
+        size_t last = 0;
+        for (size_t i = 0; i <= meshes.size(); ++ i) {
+            const size_t end    = i < meshes.size() ? meshes[i].first : buffer.size();
+            const bool   finish = i == meshes.size();
+            if (! xml_parse_chunked(m_xml_parser, std::string_view(buffer).substr(last, end - last), finish) || parse_error()) {
+                char error_buf[1024];
+                ::sprintf(error_buf, "Error (%s) while parsing '%s' at line %d", parse_error_message(), stat.m_filename, (int)XML_GetCurrentLineNumber(m_xml_parser));
+                throw Slic3r::FileIOError(error_buf);
+            }
+            if (! finish)
+                last = meshes[i].second;
+        }
+        if (m_next_preparsed_mesh != m_preparsed_meshes.size())
+            throw Slic3r::FileIOError(std::string("Unexpected mesh elements in '") + stat.m_filename + "'");
+        return true;
+    }
+
     void _3MF_Importer::_extract_cut_information_from_archive(mz_zip_archive& archive, const mz_zip_archive_file_stat& stat, ConfigSubstitutionContext& config_substitutions)
     {
         if (stat.m_uncomp_size > 0) {
@@ -1931,7 +2091,14 @@ namespace Slic3r {
 
     bool _3MF_Importer::_handle_end_mesh()
     {
-        // do nothing
+        if (m_next_preparsed_mesh < m_preparsed_meshes.size()) {
+            // The content of this mesh element was skipped, take its geometry parsed in parallel.
+            Geometry &geometry = m_preparsed_meshes[m_next_preparsed_mesh ++];
+            // Vertices were parsed before the unit of the model was known.
+            for (Vec3f &v : geometry.vertices)
+                v *= m_unit_factor;
+            m_curr_object.geometry = std::move(geometry);
+        }
         return true;
     }
 
@@ -2673,8 +2840,8 @@ namespace Slic3r {
         bool _add_thumbnail_file_to_archive(mz_zip_archive& archive, const ThumbnailData& thumbnail_data);
         bool _add_relationships_file_to_archive(mz_zip_archive& archive);
         bool _add_model_file_to_archive(const std::string& filename, mz_zip_archive& archive, const Model& model, IdToObjectDataMap& objects_data);
-        bool _add_object_to_model_stream(mz_zip_writer_staged_context &context, unsigned int& object_id, ModelObject& object, BuildItemsList& build_items, VolumeToOffsetsMap& volumes_offsets);
-        bool _add_mesh_to_object_stream(mz_zip_writer_staged_context &context, ModelObject& object, VolumeToOffsetsMap& volumes_offsets);        
+        bool _add_object_to_model_stream(std::string &output_buffer, unsigned int object_id, ModelObject& object, BuildItemsList& build_items, VolumeToOffsetsMap& volumes_offsets) const;
+        bool _add_mesh_to_object_stream(std::string &output_buffer, ModelObject& object, VolumeToOffsetsMap& volumes_offsets) const;
         bool _add_build_to_model_stream(std::stringstream& stream, const BuildItemsList& build_items);
         bool _add_cut_information_file_to_archive(mz_zip_archive& archive, Model& model);
         bool _add_layer_height_profile_file_to_archive(mz_zip_archive& archive, Model& model);
@@ -2690,6 +2857,7 @@ namespace Slic3r {
     {
         clear_errors();
         m_options = options;
+        m_options.compression_level = std::clamp(m_options.compression_level, 0, int(MZ_UBER_COMPRESSION));
         return _save_model_to_file(filename, model, config);
     }
 
@@ -2854,7 +3022,7 @@ namespace Slic3r {
 
         std::string out = stream.str();
 
-        if (!mz_zip_writer_add_mem(&archive, CONTENT_TYPES_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+        if (!mz_zip_writer_add_mem(&archive, CONTENT_TYPES_FILE.c_str(), (const void*)out.data(), out.length(), mz_uint(m_options.compression_level))) {
             add_error("Unable to add content types file to archive");
             return false;
         }
@@ -2869,7 +3037,7 @@ namespace Slic3r {
         size_t png_size = 0;
         void* png_data = tdefl_write_image_to_png_file_in_memory_ex((const void*)thumbnail_data.pixels.data(), thumbnail_data.width, thumbnail_data.height, 4, &png_size, MZ_DEFAULT_LEVEL, 1);
         if (png_data != nullptr) {
-            res = mz_zip_writer_add_mem(&archive, THUMBNAIL_FILE.c_str(), (const void*)png_data, png_size, MZ_DEFAULT_COMPRESSION);
+            res = mz_zip_writer_add_mem(&archive, THUMBNAIL_FILE.c_str(), (const void*)png_data, png_size, mz_uint(m_options.compression_level));
             mz_free(png_data);
         }
 
@@ -2890,7 +3058,7 @@ namespace Slic3r {
 
         std::string out = stream.str();
 
-        if (!mz_zip_writer_add_mem(&archive, RELATIONSHIPS_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+        if (!mz_zip_writer_add_mem(&archive, RELATIONSHIPS_FILE.c_str(), (const void*)out.data(), out.length(), mz_uint(m_options.compression_level))) {
             add_error("Unable to add relationships file to archive");
             return false;
         }
@@ -2911,19 +3079,18 @@ namespace Slic3r {
 
     bool _3MF_Exporter::_add_model_file_to_archive(const std::string& filename, mz_zip_archive& archive, const Model& model, IdToObjectDataMap& objects_data)
     {
-        mz_zip_writer_staged_context context;
-        if (!mz_zip_writer_add_staged_open(&archive, &context, MODEL_FILE.c_str(), 
+        // The model file is generated and compressed in batches of objects: The XML of the objects of a batch is generated in parallel,
+        // one object per task, then the XML is deflated in parallel in blocks. The compressed blocks are written in order
+        // into a single model file entry as they are produced.
+        MZ_ParallelDeflater deflater(&archive, MODEL_FILE.c_str(),
             m_options.zip64 ?
                 // Maximum expected and allowed 3MF file size is 16GiB.
                 // This switches the ZIP file to a 64bit mode, which adds a tiny bit of overhead to file records.
-                (uint64_t(1) << 30) * 16 : 
+                (uint64_t(1) << 30) * 16 :
                 // Maximum expected 3MF file size is 4GB-1. This is a workaround for interoperability with Windows 10 3D model fixing API, see
                 // GH issue #6193.
                 (uint64_t(1) << 32) - 1,
-            nullptr, nullptr, 0, MZ_DEFAULT_COMPRESSION, nullptr, 0, nullptr, 0)) {
-            add_error("Unable to add model file to archive");
-            return false;
-        }
+            m_options.compression_level);
 
         {
             std::stringstream stream;
@@ -2957,8 +3124,7 @@ namespace Slic3r {
             stream << " <" << METADATA_TAG << " name=\"ApplicationName\">" << SLIC3R_APP_KEY << "</" << METADATA_TAG << ">\n";
             stream << " <" << METADATA_TAG << " name=\"ApplicationVersion\">" << SLIC3R_VERSION_FULL << "</" << METADATA_TAG << ">\n";
             stream << " <" << RESOURCES_TAG << ">\n";
-            std::string buf = stream.str();
-            if (! buf.empty() && ! mz_zip_writer_add_staged_data(&context, buf.data(), buf.size())) {
+            if (! deflater.append(stream.str())) {
                 add_error("Unable to add model file to archive");
                 return false;
             }
@@ -2970,22 +3136,62 @@ namespace Slic3r {
         // The object_id here is a one based identifier of the first instance of a ModelObject in the 3MF file, where
         // all the object instances of all ModelObjects are stored and indexed in a 1 based linear fashion.
         // Therefore the list of object_ids here may not be continuous.
+        struct ObjectToExport {
+            ModelObject        *object;
+            unsigned int        object_id;
+            VolumeToOffsetsMap *volumes_offsets;
+            BuildItemsList      build_items;
+            std::string         xml;
+            bool                valid;
+        };
+        std::vector<ObjectToExport> objects;
         unsigned int object_id = 1;
         for (ModelObject* obj : model.objects) {
             if (obj == nullptr)
                 continue;
-
             // Index of an object in the 3MF file corresponding to the 1st instance of a ModelObject.
-            unsigned int curr_id = object_id;
-            IdToObjectDataMap::iterator object_it = objects_data.insert({ curr_id, ObjectData(obj) }).first;
-            // Store geometry of all ModelVolumes contained in a single ModelObject into a single 3MF indexed triangle set object.
-            // object_it->second.volumes_offsets will contain the offsets of the ModelVolumes in that single indexed triangle set.
+            IdToObjectDataMap::iterator object_it = objects_data.insert({ object_id, ObjectData(obj) }).first;
+            objects.push_back({ obj, object_id, &object_it->second.volumes_offsets, {}, {}, false });
             // object_id will be increased to point to the 1st instance of the next ModelObject.
-            if (!_add_object_to_model_stream(context, object_id, *obj, build_items, object_it->second.volumes_offsets)) {
-                add_error("Unable to add object to archive");
-                mz_zip_writer_add_staged_finish(&context);
+            object_id += (unsigned int)std::count_if(obj->instances.begin(), obj->instances.end(), [](const ModelInstance *i){ return i != nullptr; });
+        }
+
+        // Limit the size of the uncompressed XML held in memory by the number of vertices and triangles of a batch.
+        static constexpr size_t max_batch_elements = 4 * 1024 * 1024;
+        for (size_t batch_begin = 0; batch_begin < objects.size();) {
+            size_t batch_end      = batch_begin;
+            size_t batch_elements = 0;
+            for (; batch_end < objects.size() && (batch_end == batch_begin || batch_elements < max_batch_elements); ++ batch_end)
+                for (const ModelVolume *volume : objects[batch_end].object->volumes)
+                    if (volume != nullptr)
+                        batch_elements += volume->mesh().its.vertices.size() + volume->mesh().its.indices.size();
+
+            // Store geometry of all ModelVolumes contained in a single ModelObject into a single 3MF indexed triangle set object.
+            // volumes_offsets will contain the offsets of the ModelVolumes in that single indexed triangle set.
+            tbb::parallel_for(batch_begin, batch_end, [this, &objects](size_t i) {
+                ObjectToExport &obj = objects[i];
+                obj.valid = _add_object_to_model_stream(obj.xml, obj.object_id, *obj.object, obj.build_items, *obj.volumes_offsets);
+            });
+
+            std::vector<std::string_view> xml;
+            for (size_t i = batch_begin; i < batch_end; ++ i) {
+                ObjectToExport &obj = objects[i];
+                if (! obj.valid) {
+                    add_error("Found invalid mesh");
+                    add_error("Unable to add object to archive");
+                    return false;
+                }
+                append(build_items, std::move(obj.build_items));
+                xml.emplace_back(obj.xml);
+            }
+            if (! deflater.append(xml)) {
+                add_error("Unable to add model file to archive");
                 return false;
             }
+            // Release the XML of the batch.
+            for (size_t i = batch_begin; i < batch_end; ++ i)
+                std::string().swap(objects[i].xml);
+            batch_begin = batch_end;
         }
 
         {
@@ -2996,16 +3202,12 @@ namespace Slic3r {
             // Store the transformations of all the ModelInstances of all ModelObjects, indexed in a linear fashion.
             if (!_add_build_to_model_stream(stream, build_items)) {
                 add_error("Unable to add build to archive");
-                mz_zip_writer_add_staged_finish(&context);
                 return false;
             }
 
             stream << "</" << MODEL_TAG << ">\n";
-           
-            std::string buf = stream.str();
 
-            if ((! buf.empty() && ! mz_zip_writer_add_staged_data(&context, buf.data(), buf.size())) ||
-                ! mz_zip_writer_add_staged_finish(&context)) {
+            if (! deflater.append(stream.str()) || ! deflater.finish()) {
                 add_error("Unable to add model file to archive");
                 return false;
             }
@@ -3014,7 +3216,7 @@ namespace Slic3r {
         return true;
     }
 
-    bool _3MF_Exporter::_add_object_to_model_stream(mz_zip_writer_staged_context &context, unsigned int& object_id, ModelObject& object, BuildItemsList& build_items, VolumeToOffsetsMap& volumes_offsets)
+    bool _3MF_Exporter::_add_object_to_model_stream(std::string &output_buffer, unsigned int object_id, ModelObject& object, BuildItemsList& build_items, VolumeToOffsetsMap& volumes_offsets) const
     {
         std::stringstream stream;
         reset_stream(stream);
@@ -3028,13 +3230,10 @@ namespace Slic3r {
             stream << "  <" << OBJECT_TAG << " id=\"" << instance_id << "\" type=\"model\">\n";
 
             if (id == 0) {
-                std::string buf = stream.str();
+                output_buffer += stream.str();
                 reset_stream(stream);
-                if ((! buf.empty() && ! mz_zip_writer_add_staged_data(&context, buf.data(), buf.size())) ||
-                    ! _add_mesh_to_object_stream(context, object, volumes_offsets)) {
-                    add_error("Unable to add mesh to archive");
+                if (! _add_mesh_to_object_stream(output_buffer, object, volumes_offsets))
                     return false;
-                }
             }
             else {
                 stream << "   <" << COMPONENTS_TAG << ">\n";
@@ -3044,7 +3243,7 @@ namespace Slic3r {
 
             Transform3d t = instance->get_matrix();
             // instance_id is just a 1 indexed index in build_items.
-            assert(instance_id == build_items.size() + 1);
+            assert(instance_id == object_id + build_items.size());
             build_items.emplace_back(instance_id, t, instance->printable);
 
             stream << "  </" << OBJECT_TAG << ">\n";
@@ -3052,9 +3251,8 @@ namespace Slic3r {
             ++id;
         }
 
-        object_id += id;
-        std::string buf = stream.str();
-        return buf.empty() || mz_zip_writer_add_staged_data(&context, buf.data(), buf.size());
+        output_buffer += stream.str();
+        return true;
     }
 
 #if EXPORT_3MF_USE_SPIRIT_KARMA_FP
@@ -3077,26 +3275,14 @@ namespace Slic3r {
     using coordinate_type_scientific = boost::spirit::karma::real_generator<float, coordinate_policy_scientific<float>>;
 #endif // EXPORT_3MF_USE_SPIRIT_KARMA_FP
 
-    bool _3MF_Exporter::_add_mesh_to_object_stream(mz_zip_writer_staged_context &context, ModelObject& object, VolumeToOffsetsMap& volumes_offsets)
+    bool _3MF_Exporter::_add_mesh_to_object_stream(std::string &output_buffer, ModelObject& object, VolumeToOffsetsMap& volumes_offsets) const
     {
-        std::string output_buffer;
         output_buffer += "   <";
         output_buffer += MESH_TAG;
         output_buffer += ">\n    <";
         output_buffer += VERTICES_TAG;
         output_buffer += ">\n";
 
-        auto flush = [this, &output_buffer, &context](bool force = false) {
-            if ((force && ! output_buffer.empty()) || output_buffer.size() >= 65536 * 16) {
-                if (! mz_zip_writer_add_staged_data(&context, output_buffer.data(), output_buffer.size())) {
-                    add_error("Error during writing or compression");
-                    return false;
-                }
-                output_buffer.clear();
-            }
-            return true;
-        };
-
         auto format_coordinate = [](float f, char *buf) -> char* {
             assert(is_decimal_separator_point());
 #if EXPORT_3MF_USE_SPIRIT_KARMA_FP
@@ -3136,10 +3322,9 @@ namespace Slic3r {
             volumes_offsets.insert({ volume, Offsets(vertices_count) });
 
             const indexed_triangle_set &its = volume->mesh().its;
-            if (its.vertices.empty()) {
-                add_error("Found invalid mesh");
+            if (its.vertices.empty())
+                // Invalid mesh, reported by the caller, as this function is executed in parallel.
                 return false;
-            }
 
             vertices_count += (int)its.vertices.size();
 
@@ -3156,8 +3341,6 @@ namespace Slic3r {
                 boost::spirit::karma::generate(ptr, "\"/>\n");
                 *ptr = '\0';
                 output_buffer += buf;
-                if (! flush())
-                    return false;
             }
         }
 
@@ -3226,9 +3409,6 @@ namespace Slic3r {
                 }
 
                 output_buffer += "/>\n";
-
-                if (! flush())
-                    return false;
             }
         }
 
@@ -3237,9 +3417,7 @@ namespace Slic3r {
         output_buffer += ">\n   </";
         output_buffer += MESH_TAG;
         output_buffer += ">\n";
-
-        // Force flush.
-        return flush(true);
+        return true;
     }
 
     void _3MF_Exporter::add_transformation(std::stringstream &stream, const Transform3d &tr)
@@ -3327,7 +3505,7 @@ namespace Slic3r {
         }
 
         if (!out.empty()) {
-            if (!mz_zip_writer_add_mem(&archive, CUT_INFORMATION_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+            if (!mz_zip_writer_add_mem(&archive, CUT_INFORMATION_FILE.c_str(), (const void*)out.data(), out.length(), mz_uint(m_options.compression_level))) {
                 add_error("Unable to add cut information file to archive");
                 return false;
             }
@@ -3361,7 +3539,7 @@ namespace Slic3r {
         }
 
         if (!out.empty()) {
-            if (!mz_zip_writer_add_mem(&archive, LAYER_HEIGHTS_PROFILE_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+            if (!mz_zip_writer_add_mem(&archive, LAYER_HEIGHTS_PROFILE_FILE.c_str(), (const void*)out.data(), out.length(), mz_uint(m_options.compression_level))) {
                 add_error("Unable to add layer heights profile file to archive");
                 return false;
             }
@@ -3472,16 +3650,16 @@ namespace Slic3r {
         }
 
         if (!default_out.empty()) {
-            if (!mz_zip_writer_add_mem(&archive, SLIC3R_LAYER_CONFIG_RANGES_FILE.c_str(), (const void*)default_out.data(), default_out.length(), MZ_DEFAULT_COMPRESSION))
+            if (!mz_zip_writer_add_mem(&archive, SLIC3R_LAYER_CONFIG_RANGES_FILE.c_str(), (const void*)default_out.data(), default_out.length(), mz_uint(m_options.compression_level)))
             {
                 add_error("Unable to add layer heights profile file to archive");
                 return false;
             }
-            if (!mz_zip_writer_add_mem(&archive, SUPER_LAYER_CONFIG_RANGES_FILE.c_str(), (const void*)default_out.data(), default_out.length(), MZ_DEFAULT_COMPRESSION)) {
+            if (!mz_zip_writer_add_mem(&archive, SUPER_LAYER_CONFIG_RANGES_FILE.c_str(), (const void*)default_out.data(), default_out.length(), mz_uint(m_options.compression_level))) {
                 add_error("Unable to add layer heights profile file to archive");
                 return false;
             }
-            if (!prusa_out.empty() && !mz_zip_writer_add_mem(&archive, PRUSA_LAYER_CONFIG_RANGES_FILE.c_str(), (const void*)prusa_out.data(), prusa_out.length(), MZ_DEFAULT_COMPRESSION)) {
+            if (!prusa_out.empty() && !mz_zip_writer_add_mem(&archive, PRUSA_LAYER_CONFIG_RANGES_FILE.c_str(), (const void*)prusa_out.data(), prusa_out.length(), mz_uint(m_options.compression_level))) {
                 add_error("Unable to add layer heights profile file to archive");
                 return false;
             }
@@ -3517,7 +3695,7 @@ namespace Slic3r {
             // Adds version header at the beginning:
             out = std::string("support_points_format_version=") + std::to_string(support_points_format_version) + std::string("\n") + out;
 
-            if (!mz_zip_writer_add_mem(&archive, SLA_SUPPORT_POINTS_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+            if (!mz_zip_writer_add_mem(&archive, SLA_SUPPORT_POINTS_FILE.c_str(), (const void*)out.data(), out.length(), mz_uint(m_options.compression_level))) {
                 add_error("Unable to add sla support points file to archive");
                 return false;
             }
@@ -3568,7 +3746,7 @@ namespace Slic3r {
             // Adds version header at the beginning:
             out = std::string("drain_holes_format_version=") + std::to_string(drain_holes_format_version) + std::string("\n") + out;
             
-            if (!mz_zip_writer_add_mem(&archive, SLA_DRAIN_HOLES_FILE.c_str(), static_cast<const void*>(out.data()), out.length(), mz_uint(MZ_DEFAULT_COMPRESSION))) {
+            if (!mz_zip_writer_add_mem(&archive, SLA_DRAIN_HOLES_FILE.c_str(), static_cast<const void*>(out.data()), out.length(), mz_uint(m_options.compression_level))) {
                 add_error("Unable to add sla support points file to archive");
                 return false;
             }
@@ -3597,7 +3775,7 @@ namespace Slic3r {
         }
 
         if (!out.empty()) {
-            if (!mz_zip_writer_add_mem(&archive, config_name.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+            if (!mz_zip_writer_add_mem_parallel(&archive, config_name.c_str(), (const void*)out.data(), out.length(), m_options.compression_level)) {
                 add_error("Unable to add print config file to archive");
                 return false;
             }
@@ -3848,7 +4026,7 @@ namespace Slic3r {
 
         std::string out = stream.str();
 
-        if (!mz_zip_writer_add_mem(&archive, file_path.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+        if (!mz_zip_writer_add_mem_parallel(&archive, file_path.c_str(), (const void*)out.data(), out.length(), m_options.compression_level)) {
             add_error("Unable to add model config file to archive");
             return false;
         }
@@ -3900,7 +4078,7 @@ bool _3MF_Exporter::_add_custom_gcode_per_print_z_file_to_archive( mz_zip_archiv
     } 
 
     if (!out.empty()) {
-        if (!mz_zip_writer_add_mem(&archive, CUSTOM_GCODE_PER_PRINT_Z_FILE.c_str(), (const void*)out.data(), out.length(), MZ_DEFAULT_COMPRESSION)) {
+        if (!mz_zip_writer_add_mem(&archive, CUSTOM_GCODE_PER_PRINT_Z_FILE.c_str(), (const void*)out.data(), out.length(), mz_uint(m_options.compression_level))) {
             add_error("Unable to add custom Gcodes per print_z file to archive");
             return false;
         }
@@ -45,11 +45,14 @@ namespace Slic3r {
         bool export_config = true;
         bool export_modifiers = true;
         const ThumbnailData* thumbnail_data = nullptr;
+        // ZIP compression level of the archive entries, 0 (no compression) to 10 (best compression, slow), 6 is the miniz default.
+        int compression_level = 6;
         OptionStore3mf& set_fullpath_sources(bool use_fullpath_sources) { fullpath_sources = use_fullpath_sources; return *this; }
         OptionStore3mf& set_zip64(bool use_zip64) { zip64 = use_zip64; return *this; }
         OptionStore3mf& set_export_config(bool use_export_config) { export_config = use_export_config; return *this; }
         OptionStore3mf& set_export_modifiers(bool use_export_modifiers) { export_modifiers = use_export_modifiers; return *this; }
         OptionStore3mf& set_thumbnail_data(const ThumbnailData* thumbnail) { thumbnail_data = thumbnail; return *this; }
+        OptionStore3mf& set_compression_level(int level) { compression_level = level; return *this; }
     };
 
     // Save the given model and the config data contained in the given Print into a 3mf file.
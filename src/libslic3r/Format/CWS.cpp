@@ -132,14 +132,13 @@ void MaskedCWSArchive::export_print(const std::string     fname,
         zipper.add_entry("slicer.ini");
         zipper << to_ini(slicerconf);
         
-        size_t i = 0;
-        for (const sla::EncodedRaster &rst : m_layers) {
+        for_each_layer([&zipper, &project](size_t i, const sla::EncodedRaster &rst) {
 
-            std::string imgname = project + string_printf("%.5d", i++) + "." +
+            std::string imgname = project + string_printf("%.5d", i) + "." +
                                   rst.extension();
             
             zipper.add_entry(imgname.c_str(), rst.data(), rst.size());
-        }
+        });
     } catch(std::exception& e) {
         BOOST_LOG_TRIVIAL(error) << e.what();
         // Rethrow the exception
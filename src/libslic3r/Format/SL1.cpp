@@ -168,7 +168,7 @@ std::unique_ptr<sla::RasterBase> SL1Archive::create_raster() const
 
 sla::RasterEncoder SL1Archive::get_encoder() const
 {
-    return sla::PNGRasterEncoder{};
+    return sla::PNGRasterEncoder{m_cfg.sla_output_compression.value};
 }
 
 static void write_thumbnail(Zipper &zipper, const ThumbnailData &data)
@@ -212,14 +212,13 @@ void SL1Archive::export_print(Zipper               &zipper,
         zipper.add_entry("prusaslicer.ini");
         zipper << to_ini(slicerconf);
 
-        size_t i = 0;
-        for (const sla::EncodedRaster &rst : m_layers) {
+        for_each_layer([&zipper, &project](size_t i, const sla::EncodedRaster &rst) {
 
-            std::string imgname = project + string_printf("%.5d", i++) + "." +
+            std::string imgname = project + string_printf("%.5d", i) + "." +
                                   rst.extension();
 
             zipper.add_entry(imgname.c_str(), rst.data(), rst.size());
-        }
+        });
 
         for (const ThumbnailData& data : thumbnails)
             if (data.is_valid())
@@ -357,40 +356,28 @@ ExPolygons rings_to_expolygons(const std::vector<marchsq::Ring> &rings,
 }
 
 std::vector<ExPolygons> extract_slices_from_sla_archive(
-    ZipperArchive           &arch,
+    ZipperArchiveReader     &arch,
     const RasterParams      &rstp,
     const marchsq::Coord    &win,
     std::function<bool(int)> progr)
 {
-    std::vector<ExPolygons> slices(arch.entries.size());
+    std::vector<ExPolygons> slices(arch.entry_count());
 
     struct Status
     {
-        double                                 incr, val, prev;
-        bool                                   stop  = false;
-        execution::SpinningMutex<ExecutionTBB> mutex = {};
+        double incr, val, prev;
+        bool   stop = false;
     } st{100. / slices.size(), 0., 0.};
 
-    execution::for_each(
-        ex_tbb, size_t(0), arch.entries.size(),
-        [&arch, &slices, &st, &rstp, &win, progr](size_t i) {
-            // Status indication guarded with the spinlock
-            {
-                std::lock_guard lck(st.mutex);
-                if (st.stop) return;
-
-                st.val += st.incr;
-                double curr = std::round(st.val);
-                if (curr > st.prev) {
-                    st.prev = curr;
-                    st.stop = !progr(int(curr));
-                }
-            }
-
+    // The layer images are read from the archive one by one, decoded and
+    // contoured in parallel. Only a bounded number of the compressed images
+    // are held in memory.
+    arch.transform_entries<ExPolygons>(
+        2 * execution::max_concurrency(ex_tbb),
+        [&rstp, &win](size_t, const EntryBuffer &entry) {
             png::ImageGreyscale img;
-            png::ReadBuf        rb{arch.entries[i].buf.data(),
-                            arch.entries[i].buf.size()};
-            if (!png::decode_png(rb, img)) return;
+            png::ReadBuf        rb{entry.buf.data(), entry.buf.size()};
+            if (!png::decode_png(rb, img)) return ExPolygons{};
 
             constexpr uint8_t isoval = 128;
             auto              rings = marchsq::execute(img, isoval, win);
@@ -400,9 +387,20 @@ std::vector<ExPolygons> extract_slices_from_sla_archive(
             // Invert the raster transformations indicated in the profile metadata
             invert_raster_trafo(expolys, rstp.trafo, rstp.width, rstp.height);
 
-            slices[i] = std::move(expolys);
+            return expolys;
         },
-        execution::max_concurrency(ex_tbb));
+        [&slices, &st, progr](size_t i, ExPolygons &&expolys) {
+            slices[i] = std::move(expolys);
+
+            // Status indication, called in the order of the layers.
+            st.val += st.incr;
+            double curr = std::round(st.val);
+            if (curr > st.prev) {
+                st.prev = curr;
+                st.stop = !progr(int(curr));
+            }
+            return !st.stop;
+        });
 
     if (st.stop) slices = {};
 
@@ -431,8 +429,8 @@ ConfigSubstitutions SL1Reader::read(std::vector<ExPolygons> &slices,
 
     std::vector<std::string> includes = { "ini", "png"};
     std::vector<std::string> excludes = { "thumbnail" };
-    ZipperArchive arch = read_zipper_archive(m_fname, includes, excludes);
-    auto [profile_use, config_substitutions] = extract_profile(arch, profile_out);
+    ZipperArchiveReader arch(m_fname, includes, excludes);
+    auto [profile_use, config_substitutions] = extract_profile(arch.metadata(), profile_out);
 
     RasterParams   rstp = get_raster_params(profile_use);
     marchsq::Coord win  = {windowsize.y(), windowsize.x()};
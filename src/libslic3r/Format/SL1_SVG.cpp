@@ -8,6 +8,7 @@
 #include "libslic3r/ClipperUtils.hpp"
 #include "libslic3r/BoundingBox.hpp"
 #include "libslic3r/Format/ZipperArchiveImport.hpp"
+#include "libslic3r/Execution/ExecutionTBB.hpp"
 
 #define NANOSVG_IMPLEMENTATION
 #include "nanosvg/nanosvg.h"
@@ -259,8 +260,8 @@ ConfigSubstitutions SL1_SVGReader::read(std::vector<ExPolygons> &slices,
                                         DynamicPrintConfig      &profile_out)
 {
     std::vector<std::string> includes = { CONFIG_FNAME, PROFILE_FNAME, "svg"};
-    ZipperArchive arch = read_zipper_archive(m_fname, includes, {});
-    auto [profile_use, config_substitutions] = extract_profile(arch, profile_out);
+    ZipperArchiveReader arch(m_fname, includes, {});
+    auto [profile_use, config_substitutions] = extract_profile(arch.metadata(), profile_out);
 
     RasterParams rstp = get_raster_params(profile_use);
 
@@ -268,45 +269,51 @@ ConfigSubstitutions SL1_SVGReader::read(std::vector<ExPolygons> &slices,
     {
         double                                 incr, val, prev;
         bool                                   stop  = false;
-    } st{100. / arch.entries.size(), 0., 0.};
-
-    for (const EntryBuffer &entry : arch.entries) {
-        if (st.stop) break;
-
-        st.val += st.incr;
-        double curr = std::round(st.val);
-        if (curr > st.prev) {
-            st.prev = curr;
-            st.stop = !m_progr(int(curr));
-        }
-
-        // Don't want to use dirty casts for the buffer to be usable in
-        // the NanoSVGParser until performance is not a bottleneck here.
-        auto svgtxt = reserve_vector<char>(entry.buf.size() + 1);
-        std::copy(entry.buf.begin(), entry.buf.end(), std::back_inserter(svgtxt));
-        svgtxt.emplace_back('\0');
-        NanoSVGParser svgp(svgtxt.data());
-
-        Polygons polys;
-        for (NSVGshape *shape = svgp.image->shapes; shape != nullptr; shape = shape->next) {
-            for (NSVGpath *path = shape->paths; path != nullptr; path = path->next) {
-                Polygon p;
-                for (int i = 0; i < path->npts; ++i) {
-                    size_t c = 2 * i;
-                    p.points.emplace_back(scaled(Vec2f(path->pts[c], path->pts[c + 1])));
+    } st{100. / arch.entry_count(), 0., 0.};
+
+    // The svg files are read from the archive one by one and parsed in
+    // parallel, only a bounded number of them is held in memory.
+    arch.transform_entries<ExPolygons>(
+        2 * execution::max_concurrency(ex_tbb),
+        [&rstp](size_t, const EntryBuffer &entry) {
+            // Don't want to use dirty casts for the buffer to be usable in
+            // the NanoSVGParser until performance is not a bottleneck here.
+            auto svgtxt = reserve_vector<char>(entry.buf.size() + 1);
+            std::copy(entry.buf.begin(), entry.buf.end(), std::back_inserter(svgtxt));
+            svgtxt.emplace_back('\0');
+            NanoSVGParser svgp(svgtxt.data());
+
+            Polygons polys;
+            for (NSVGshape *shape = svgp.image->shapes; shape != nullptr; shape = shape->next) {
+                for (NSVGpath *path = shape->paths; path != nullptr; path = path->next) {
+                    Polygon p;
+                    for (int i = 0; i < path->npts; ++i) {
+                        size_t c = 2 * i;
+                        p.points.emplace_back(scaled(Vec2f(path->pts[c], path->pts[c + 1])));
+                    }
+                    polys.emplace_back(p);
                 }
-                polys.emplace_back(p);
             }
-        }
 
-        // Create the slice from the read polygons. Here, the fill rule has to
-        // be the same as stated in the svg file which is `nonzero` when exported
-        // using SL1_SVGArchive. Would be better to parse it from the svg file,
-        // but if it's different, the file is probably corrupted anyways.
-        ExPolygons expolys = union_ex(polys, ClipperLib::pftNonZero);
-        invert_raster_trafo(expolys, rstp.trafo, rstp.width, rstp.height);
-        slices.emplace_back(expolys);
-    }
+            // Create the slice from the read polygons. Here, the fill rule has to
+            // be the same as stated in the svg file which is `nonzero` when exported
+            // using SL1_SVGArchive. Would be better to parse it from the svg file,
+            // but if it's different, the file is probably corrupted anyways.
+            ExPolygons expolys = union_ex(polys, ClipperLib::pftNonZero);
+            invert_raster_trafo(expolys, rstp.trafo, rstp.width, rstp.height);
+            return expolys;
+        },
+        [this, &slices, &st](size_t, ExPolygons &&expolys) {
+            st.val += st.incr;
+            double curr = std::round(st.val);
+            if (curr > st.prev) {
+                st.prev = curr;
+                st.stop = !m_progr(int(curr));
+            }
+
+            slices.emplace_back(std::move(expolys));
+            return !st.stop;
+        });
 
     // Compile error without the move
     return std::move(config_substitutions);
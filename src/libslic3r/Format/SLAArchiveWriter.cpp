@@ -6,8 +6,56 @@
 #include "SLAArchiveWriter.hpp"
 #include "SLAArchiveFormatRegistry.hpp"
 
+#include "libslic3r/Exception.hpp"
+
+#include <boost/filesystem.hpp>
+
 namespace Slic3r {
 
+SLALayerSpool::SLALayerSpool()
+{
+    namespace fs = boost::filesystem;
+    m_path = (fs::temp_directory_path() / fs::unique_path("slic3r_sla_layers_%%%%-%%%%-%%%%-%%%%.tmp")).string();
+    m_out.open(m_path, std::ios::binary | std::ios::out | std::ios::trunc);
+    if (! m_out)
+        throw Slic3r::FileIOError(std::string("Failed to create a temporary file for the rasterized layers: ") + m_path);
+}
+
+SLALayerSpool::~SLALayerSpool()
+{
+    m_out.close();
+    boost::system::error_code ec;
+    boost::filesystem::remove(m_path, ec);
+}
+
+void SLALayerSpool::append(const sla::EncodedRaster &rst)
+{
+    uint64_t offset = m_layers.empty() ? 0 : m_layers.back().offset + m_layers.back().size;
+    m_layers.push_back({ offset, rst.size(), rst.extension() });
+    m_out.write(static_cast<const char*>(rst.data()), std::streamsize(rst.size()));
+    if (! m_out)
+        throw Slic3r::FileIOError(std::string("Failed to write the rasterized layers into a temporary file: ") + m_path);
+}
+
+void SLALayerSpool::finish()
+{
+    m_out.flush();
+    if (! m_out)
+        throw Slic3r::FileIOError(std::string("Failed to write the rasterized layers into a temporary file: ") + m_path);
+}
+
+void SLALayerSpool::for_each(const std::function<void(size_t, const sla::EncodedRaster &)> &fn) const
+{
+    std::ifstream in(m_path, std::ios::binary | std::ios::in);
+    for (size_t idx = 0; idx < m_layers.size(); ++ idx) {
+        const Layer          &layer = m_layers[idx];
+        std::vector<uint8_t>  data(layer.size);
+        if (! in.seekg(std::streamoff(layer.offset)) || ! in.read(reinterpret_cast<char*>(data.data()), std::streamsize(layer.size)))
+            throw Slic3r::FileIOError(std::string("Failed to read the rasterized layers from a temporary file: ") + m_path);
+        fn(idx, sla::EncodedRaster(std::move(data), layer.ext));
+    }
+}
+
 std::unique_ptr<SLAArchiveWriter>
 SLAArchiveWriter::create(OutputFormat archtype, const SLAPrinterConfig &cfg)
 {
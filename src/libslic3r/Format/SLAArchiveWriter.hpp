@@ -6,6 +6,10 @@
 #define SLAARCHIVE_HPP
 
 #include <vector>
+#include <fstream>
+#include <functional>
+
+#include <oneapi/tbb/parallel_pipeline.h>
 
 #include "libslic3r/Config.hpp"
 #include "libslic3r/SLA/RasterBase.hpp"
@@ -17,16 +21,71 @@ namespace Slic3r {
 class SLAPrint;
 class SLAPrinterConfig;
 
+// Encoded layers appended to a temporary file in layer order. Only the offsets of the layers
+// are kept in memory, the layers are loaded one by one when the archive is being written.
+class SLALayerSpool {
+public:
+    SLALayerSpool();
+    ~SLALayerSpool();
+
+    // Not thread safe, the layers have to be appended in layer order.
+    void append(const sla::EncodedRaster &rst);
+    // Flush the written layers, to be called before for_each().
+    void finish();
+
+    size_t size() const { return m_layers.size(); }
+    size_t layer_size(size_t idx) const { return m_layers[idx].size; }
+
+    // Fn: void(size_t idx, const sla::EncodedRaster &rst), called in layer order.
+    void for_each(const std::function<void(size_t, const sla::EncodedRaster &)> &fn) const;
+
+private:
+    struct Layer {
+        uint64_t    offset;
+        size_t      size;
+        std::string ext;
+    };
+    std::vector<Layer> m_layers;
+    std::string        m_path;
+    std::ofstream      m_out;
+};
+
 class SLAArchiveWriter {
+    // Non-null if the layers were rasterized in the streaming mode.
+    std::unique_ptr<SLALayerSpool> m_spool;
+    bool                           m_streaming = false;
+
 protected:
+    // Layers rasterized in the in-memory mode. Use layer_count(), layer_size() and for_each_layer()
+    // to access the layers independently of the rasterization mode.
     std::vector<sla::EncodedRaster> m_layers;
 
     virtual std::unique_ptr<sla::RasterBase> create_raster() const = 0;
     virtual sla::RasterEncoder get_encoder() const = 0;
 
+    size_t layer_count() const { return m_spool ? m_spool->size() : m_layers.size(); }
+    size_t layer_size(size_t idx) const { return m_spool ? m_spool->layer_size(idx) : m_layers[idx].size(); }
+
+    // Fn: void(size_t idx, const sla::EncodedRaster &rst), called in layer order.
+    // In the streaming mode only a single layer is held in memory at a time.
+    template<class Fn> void for_each_layer(Fn &&fn) const
+    {
+        if (m_spool)
+            m_spool->for_each(fn);
+        else
+            for (size_t idx = 0; idx < m_layers.size(); ++ idx)
+                fn(idx, m_layers[idx]);
+    }
+
 public:
     virtual ~SLAArchiveWriter() = default;
 
+    // In the streaming mode draw_layers() rasterizes, encodes and spools the layers to a temporary file
+    // in a pipeline with a bounded number of layers in flight, thus the memory consumed
+    // does not grow with the number of layers.
+    void set_streaming(bool streaming) { m_streaming = streaming; }
+    bool streaming() const { return m_streaming; }
+
     // Fn have to be thread safe: void(sla::RasterBase& raster, size_t lyrid);
     template<class Fn, class CancelFn, class EP = ExecutionTBB>
     void draw_layers(
@@ -35,6 +94,31 @@ public:
         CancelFn cancelfn = []() { return false; },
         const EP & ep       = {})
     {
+        m_spool.reset();
+        if (m_streaming) {
+            m_layers.clear();
+            m_layers.shrink_to_fit();
+            m_spool = std::make_unique<SLALayerSpool>();
+            size_t next_idx = 0;
+            tbb::parallel_pipeline(2 * execution::max_concurrency(ep),
+                tbb::make_filter<void, size_t>(tbb::filter_mode::serial_in_order,
+                    [layer_num, &next_idx, &cancelfn](tbb::flow_control &fc) -> size_t {
+                        if (next_idx == layer_num || cancelfn())
+                            fc.stop();
+                        return next_idx ++;
+                    }) &
+                tbb::make_filter<size_t, sla::EncodedRaster>(tbb::filter_mode::parallel,
+                    [this, &drawfn](size_t idx) {
+                        auto rst = create_raster();
+                        drawfn(*rst, idx);
+                        return rst->encode(get_encoder());
+                    }) &
+                tbb::make_filter<sla::EncodedRaster, void>(tbb::filter_mode::serial_in_order,
+                    [this](const sla::EncodedRaster &enc) { m_spool->append(enc); }));
+            m_spool->finish();
+            return;
+        }
+
         m_layers.resize(layer_num);
         execution::for_each(
             ep, size_t(0), m_layers.size(),
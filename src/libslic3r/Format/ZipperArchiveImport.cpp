@@ -48,24 +48,24 @@ EntryBuffer read_entry(const mz_zip_archive_file_stat &entry,
 
 } // namespace
 
-ZipperArchive read_zipper_archive(const std::string &zipfname,
-                                  const std::vector<std::string> &includes,
-                                  const std::vector<std::string> &excludes)
+// Little RAII
+struct ZipperArchiveReader::Arch : public MZ_Archive
 {
-    ZipperArchive arch;
-
-    // Little RAII
-    struct Arch : public MZ_Archive
+    Arch(const std::string &fname)
     {
-        Arch(const std::string &fname)
-        {
-            if (!open_zip_reader(&arch, fname))
-                throw Slic3r::FileIOError(get_errorstr());
-        }
+        if (!open_zip_reader(&arch, fname))
+            throw Slic3r::FileIOError(get_errorstr());
+    }
 
-        ~Arch() { close_zip_reader(&arch); }
-    } zip(zipfname);
+    ~Arch() { close_zip_reader(&arch); }
+};
 
+ZipperArchiveReader::ZipperArchiveReader(const std::string              &zipfname,
+                                         const std::vector<std::string> &includes,
+                                         const std::vector<std::string> &excludes)
+    : m_arch(std::make_unique<Arch>(zipfname))
+{
+    MZ_Archive &zip = *m_arch;
     mz_uint num_entries = mz_zip_reader_get_num_files(&zip.arch);
 
     for (mz_uint i = 0; i < num_entries; ++i) {
@@ -88,26 +88,45 @@ ZipperArchive read_zipper_archive(const std::string &zipfname,
                 continue;
 
             if (name == CONFIG_FNAME)  {
-                arch.config = read_ini(entry, zip);
+                m_metadata.config = read_ini(entry, zip);
                 continue;
             }
 
             if (name == PROFILE_FNAME) {
-                arch.profile = read_ini(entry, zip);
+                m_metadata.profile = read_ini(entry, zip);
                 continue;
             }
 
-            auto it = std::lower_bound(
-                arch.entries.begin(), arch.entries.end(),
-                EntryBuffer{{}, name},
-                [](const EntryBuffer &r1, const EntryBuffer &r2) {
-                    return std::less<std::string>()(r1.fname, r2.fname);
-                });
-
-            arch.entries.insert(it, read_entry(entry, zip, name));
+            m_entries.emplace_back(entry.m_file_index, std::move(name));
         }
     }
 
+    std::stable_sort(m_entries.begin(), m_entries.end(),
+                     [](const auto &e1, const auto &e2) { return e1.second < e2.second; });
+}
+
+ZipperArchiveReader::~ZipperArchiveReader() = default;
+
+EntryBuffer ZipperArchiveReader::read_entry(size_t idx)
+{
+    mz_zip_archive_file_stat entry;
+    if (!mz_zip_reader_file_stat(&m_arch->arch, m_entries[idx].first, &entry))
+        throw Slic3r::FileIOError(m_arch->get_errorstr());
+
+    return Slic3r::read_entry(entry, *m_arch, m_entries[idx].second);
+}
+
+ZipperArchive read_zipper_archive(const std::string &zipfname,
+                                  const std::vector<std::string> &includes,
+                                  const std::vector<std::string> &excludes)
+{
+    ZipperArchiveReader reader(zipfname, includes, excludes);
+    ZipperArchive       arch = reader.metadata();
+
+    arch.entries.reserve(reader.entry_count());
+    for (size_t i = 0; i < reader.entry_count(); ++i)
+        arch.entries.emplace_back(reader.read_entry(i));
+
     return arch;
 }
 
@@ -5,12 +5,16 @@
 #ifndef ZIPPERARCHIVEIMPORT_HPP
 #define ZIPPERARCHIVEIMPORT_HPP
 
+#include <atomic>
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <memory>
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <oneapi/tbb/parallel_pipeline.h>
+
 #include "libslic3r/PrintConfig.hpp"
 
 namespace Slic3r {
@@ -45,6 +49,67 @@ ZipperArchive read_zipper_archive(const std::string &zipfname,
                                   const std::vector<std::string> &includes,
                                   const std::vector<std::string> &excludes);
 
+// Reader of an archive that was written using the Zipper class, which reads
+// the entries on demand instead of holding all of them in memory.
+// The includes and excludes parameters and the metadata files are handled
+// the same way as in read_zipper_archive().
+class ZipperArchiveReader
+{
+public:
+    ZipperArchiveReader(const std::string              &zipfname,
+                        const std::vector<std::string> &includes,
+                        const std::vector<std::string> &excludes);
+    ~ZipperArchiveReader();
+
+    // Profile and config of the archive, ZipperArchive::entries is empty.
+    const ZipperArchive &metadata() const { return m_metadata; }
+
+    // Number of the included entries, sorted by their lower case file names.
+    size_t entry_count() const { return m_entries.size(); }
+
+    // Not thread safe.
+    EntryBuffer read_entry(size_t idx);
+
+    // Read the entries in order by a serial stage, transform them by fn in
+    // parallel and hand the results over to outfn in the order of the entries.
+    // At most max_tokens entries are held in memory at a time.
+    // Fn:    T(size_t idx, const EntryBuffer &entry), has to be thread safe.
+    // OutFn: bool(size_t idx, T &&result), returns false to stop reading.
+    template<class T, class Fn, class OutFn>
+    void transform_entries(size_t max_tokens, Fn &&fn, OutFn &&outfn)
+    {
+        size_t next_idx = 0;
+        // Written by the last filter and read by the first one, which may run on different threads.
+        std::atomic<bool> stop { false };
+        tbb::parallel_pipeline(max_tokens,
+            tbb::make_filter<void, std::pair<size_t, EntryBuffer>>(tbb::filter_mode::serial_in_order,
+                [this, &next_idx, &stop](tbb::flow_control &fc) -> std::pair<size_t, EntryBuffer> {
+                    if (stop.load(std::memory_order_relaxed) || next_idx == m_entries.size()) {
+                        fc.stop();
+                        return {};
+                    }
+                    size_t idx = next_idx ++;
+                    return { idx, read_entry(idx) };
+                }) &
+            tbb::make_filter<std::pair<size_t, EntryBuffer>, std::pair<size_t, T>>(tbb::filter_mode::parallel,
+                [&fn](const std::pair<size_t, EntryBuffer> &entry) -> std::pair<size_t, T> {
+                    return { entry.first, fn(entry.first, entry.second) };
+                }) &
+            tbb::make_filter<std::pair<size_t, T>, void>(tbb::filter_mode::serial_in_order,
+                [&outfn, &stop](std::pair<size_t, T> &&result) {
+                    if (! stop.load(std::memory_order_relaxed) && ! outfn(result.first, std::move(result.second)))
+                        stop.store(true, std::memory_order_relaxed);
+                }));
+    }
+
+private:
+    struct Arch;
+    std::unique_ptr<Arch> m_arch;
+    ZipperArchive         m_metadata;
+    // File index in the archive and lower case file name of the included entries.
+    std::vector<std::pair<unsigned int, std::string>> m_entries;
+};
+
 // Extract the print profile form the archive into 'out'.
 // Returns a profile that has correct parameters to use for model reconstruction
 // even if the needed parameters were not fully found in the archive's metadata.
@@ -4,9 +4,14 @@
 ///|/
 #include <stdlib.h>
 #include <string.h>
+#include <atomic>
 
 #include <boost/log/trivial.hpp>
 #include <boost/nowide/cstdio.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <tbb/parallel_for.h>
 
 #include "objparser.hpp"
 
@@ -29,7 +34,18 @@ static double strtod_clocale(const char* str, char const** str_end)
 	return val;
 }
 
-static bool obj_parseline(const char *line, ObjData &data)
+// Face vertex referencing its coordinate, normal or texture coordinate relatively (with a negative index).
+// If a file is parsed in chunks, these references are resolved relative to the start of their chunk
+// and they are offset by the number of entries of the preceding chunks when the chunks are merged.
+struct ObjRelativeVertex
+{
+	size_t	vertexIdx;
+	bool	coord;
+	bool	normal;
+	bool	textureCoord;
+};
+
+static bool obj_parseline(const char *line, ObjData &data, std::vector<ObjRelativeVertex> *relative = nullptr)
 {
 #define EATWS() while (*line == ' ' || *line == '\t') ++ line
 
@@ -236,6 +252,8 @@ static bool obj_parseline(const char *line, ObjData &data)
 					line = endptr;
 				}
 			}
+			if (relative && (vertex.coordIdx < 0 || vertex.normalIdx < 0 || vertex.textureCoordIdx < 0))
+				relative->push_back({ data.vertices.size(), vertex.coordIdx < 0, vertex.normalIdx < 0, vertex.textureCoordIdx < 0 });
 			if (vertex.coordIdx < 0)
                 vertex.coordIdx += (int)data.coordinates.size() / 4;
             else
@@ -343,10 +361,8 @@ static bool obj_parseline(const char *line, ObjData &data)
 	return true;
 }
 
-bool objparse(const char *path, ObjData &data)
+static bool objparse_buffered(const char *path, ObjData &data)
 {
-    Slic3r::CNumericLocalesSetter locales_setter;
-
 	FILE *pFile = boost::nowide::fopen(path, "rt");
 	if (pFile == 0)
 		return false;
@@ -388,6 +404,150 @@ bool objparse(const char *path, ObjData &data)
 	return true;
 }
 
+// Parse the lines of [begin, end), the last line does not need to be terminated.
+static bool objparse_chunk(const char *begin, const char *end, ObjData &data, std::vector<ObjRelativeVertex> &relative)
+{
+	// The lines are copied to be zero terminated for obj_parseline().
+	std::string line;
+	for (const char *it = begin; it != end;) {
+		const char *eol = it;
+		while (eol != end && *eol != '\r' && *eol != '\n')
+			++ eol;
+		if (eol - it > 65536) {
+	    	BOOST_LOG_TRIVIAL(error) << "ObjParser: Excessive line length";
+			return false;
+		}
+		line.assign(it, eol);
+		const char *c = line.c_str();
+		while (*c == ' ' || *c == '\t')
+			++ c;
+		obj_parseline(c, data, &relative);
+		it = eol == end ? end : eol + 1;
+	}
+	return true;
+}
+
+template<typename T>
+static void append_offset(std::vector<T> &dst, const std::vector<T> &src, int vertexIdxOffset)
+{
+	for (T item : src) {
+		item.vertexIdxFirst += vertexIdxOffset;
+		dst.emplace_back(std::move(item));
+	}
+}
+
+// Files smaller than this are parsed with objparse_buffered().
+static constexpr size_t OBJ_MAPPED_MIN_SIZE = 4 * 1024 * 1024;
+// Approximate size of a block of lines parsed by a single task.
+static constexpr size_t OBJ_CHUNK_SIZE      = 1024 * 1024;
+
+// Memory map the file, split it into chunks at line boundaries, parse the chunks in parallel and merge them.
+// Returns false if the file could not be mapped or parsed, data is not modified in that case.
+static bool objparse_mapped(const char *path, ObjData &data)
+{
+	boost::iostreams::mapped_file_source mapped;
+	try {
+		mapped.open(path);
+	} catch (const std::exception &ex) {
+		BOOST_LOG_TRIVIAL(info) << "ObjParser: Couldn't map " << path << ", falling back to buffered reading: " << ex.what();
+		return false;
+	}
+	if (! mapped.is_open())
+		return false;
+
+	const char  *file_begin = mapped.data();
+	const char  *file_end   = file_begin + mapped.size();
+	const size_t num_chunks = std::max<size_t>(1, mapped.size() / OBJ_CHUNK_SIZE);
+	std::vector<const char*> bounds(num_chunks + 1, file_end);
+	bounds.front() = file_begin;
+	for (size_t i = 1; i < num_chunks; ++ i) {
+		// Start the chunk after the end of line following its approximate start.
+		const char *it = std::max(bounds[i - 1], file_begin + i * (mapped.size() / num_chunks));
+		while (it != file_end && *it != '\r' && *it != '\n')
+			++ it;
+		bounds[i] = it == file_end ? it : it + 1;
+	}
+
+	std::vector<ObjData>                        chunks(num_chunks);
+	std::vector<std::vector<ObjRelativeVertex>> relative(num_chunks);
+	std::atomic<bool>                           failed { false };
+	tbb::parallel_for(size_t(0), num_chunks, [&bounds, &chunks, &relative, &failed](size_t i) {
+		if (! failed && ! objparse_chunk(bounds[i], bounds[i + 1], chunks[i], relative[i]))
+			failed = true;
+	});
+	if (failed)
+		return false;
+
+	// Number of entries preceding each chunk, the chunks are appended to the already parsed data.
+	struct Offsets {
+		size_t coordinates;
+		size_t normals;
+		size_t textureCoordinates;
+		size_t parameters;
+		size_t vertices;
+	};
+	std::vector<Offsets> offsets(num_chunks + 1);
+	offsets.front() = { data.coordinates.size(), data.normals.size(), data.textureCoordinates.size(), data.parameters.size(), data.vertices.size() };
+	for (size_t i = 0; i < num_chunks; ++ i) {
+		const ObjData &chunk = chunks[i];
+		const Offsets &o     = offsets[i];
+		offsets[i + 1] = { o.coordinates + chunk.coordinates.size(), o.normals + chunk.normals.size(), o.textureCoordinates + chunk.textureCoordinates.size(),
+		                   o.parameters + chunk.parameters.size(), o.vertices + chunk.vertices.size() };
+	}
+
+	// Concatenate the chunks, copy the bulk data in parallel.
+	data.coordinates       .resize(offsets.back().coordinates);
+	data.normals           .resize(offsets.back().normals);
+	data.textureCoordinates.resize(offsets.back().textureCoordinates);
+	data.parameters        .resize(offsets.back().parameters);
+	data.vertices          .resize(offsets.back().vertices);
+	tbb::parallel_for(size_t(0), num_chunks, [&data, &chunks, &relative, &offsets](size_t i) {
+		const ObjData &chunk = chunks[i];
+		const Offsets &o     = offsets[i];
+		std::copy(chunk.coordinates.begin(),        chunk.coordinates.end(),        data.coordinates.begin()        + o.coordinates);
+		std::copy(chunk.normals.begin(),            chunk.normals.end(),            data.normals.begin()            + o.normals);
+		std::copy(chunk.textureCoordinates.begin(), chunk.textureCoordinates.end(), data.textureCoordinates.begin() + o.textureCoordinates);
+		std::copy(chunk.parameters.begin(),         chunk.parameters.end(),         data.parameters.begin()         + o.parameters);
+		std::copy(chunk.vertices.begin(),           chunk.vertices.end(),           data.vertices.begin()           + o.vertices);
+		for (const ObjRelativeVertex &rv : relative[i]) {
+			ObjVertex &vertex = data.vertices[o.vertices + rv.vertexIdx];
+			if (rv.coord)
+				vertex.coordIdx += int(o.coordinates / 4);
+			if (rv.normal)
+				vertex.normalIdx += int(o.normals / 3);
+			if (rv.textureCoord)
+				vertex.textureCoordIdx += int(o.textureCoordinates / 3);
+		}
+	});
+	for (size_t i = 0; i < num_chunks; ++ i) {
+		const ObjData &chunk = chunks[i];
+		data.mtllibs.insert(data.mtllibs.end(), chunk.mtllibs.begin(), chunk.mtllibs.end());
+		append_offset(data.usemtls,         chunk.usemtls,         int(offsets[i].vertices));
+		append_offset(data.objects,         chunk.objects,         int(offsets[i].vertices));
+		append_offset(data.groups,          chunk.groups,          int(offsets[i].vertices));
+		append_offset(data.smoothingGroups, chunk.smoothingGroups, int(offsets[i].vertices));
+	}
+	return true;
+}
+
+bool objparse(const char *path, ObjData &data)
+{
+    Slic3r::CNumericLocalesSetter locales_setter;
+
+	boost::system::error_code ec;
+	const uintmax_t file_size = boost::filesystem::file_size(boost::filesystem::path(path), ec);
+	if (! ec && file_size >= OBJ_MAPPED_MIN_SIZE) {
+		try {
+			if (objparse_mapped(path, data))
+				return true;
+		} catch (std::bad_alloc&) {
+	    	BOOST_LOG_TRIVIAL(error) << "ObjParser: Out of memory";
+			return false;
+		}
+	}
+	return objparse_buffered(path, data);
+}
+
 bool objparse(std::istream &stream, ObjData &data)
 {
     Slic3r::CNumericLocalesSetter locales_setter;
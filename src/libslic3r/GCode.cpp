@@ -1963,7 +1963,7 @@ void GCode::_do_export(Print& print_mod, GCodeOutputStream &file, ThumbnailsGene
      print.set_status(0, L("Computing seam visibility areas: object %s / %s"),
                       {"1", std::to_string(print.objects().size())},
                       PrintBase::SlicingStatus::FORCE_SHOW | PrintBase::SlicingStatus::SECONDARY_STATE);
-    m_seam_placer.init(print, this->m_throw_if_canceled);
+    m_seam_placer.init(print_mod, this->m_throw_if_canceled);
 
     //activate first extruder is multi-extruder and not in start-gcode
     if ((initial_extruder_id != (uint16_t)-1)) {
@@ -2055,7 +2055,7 @@ void GCode::_do_export(Print& print_mod, GCodeOutputStream &file, ThumbnailsGene
                     set_extra_lift(0, 0, print.config(), m_writer, initial_extruder_id);
                 }
                 //reinit the seam placer on the new object
-                m_seam_placer.init(print, this->m_throw_if_canceled);
+                m_seam_placer.init(print_mod, this->m_throw_if_canceled);
                 // Reset the cooling buffer internal state (the current position, feed rate, accelerations).
                 m_cooling_buffer->reset(this->writer().get_position());
                 m_cooling_buffer->set_current_extruder(initial_extruder_id);
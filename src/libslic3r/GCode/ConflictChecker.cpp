@@ -11,87 +11,59 @@
 #include <map>
 #include <functional>
 #include <atomic>
+#include <numeric>
 
 namespace Slic3r {
 
-namespace RasterizationImpl {
-using IndexPair = std::pair<int64_t, int64_t>;
-using Grids     = std::vector<IndexPair>;
-
-inline constexpr int64_t RasteXDistance = scale_(1);
-inline constexpr int64_t RasteYDistance = scale_(1);
-
-inline IndexPair point_map_grid_index(const Point &pt, int64_t xdist, int64_t ydist)
-{
-    auto x = pt.x() / xdist;
-    auto y = pt.y() / ydist;
-    return std::make_pair(x, y);
-}
-
-inline bool nearly_equal(const Point &p1, const Point &p2) { return std::abs(p1.x() - p2.x()) < SCALED_EPSILON && std::abs(p1.y() - p2.y()) < SCALED_EPSILON; }
-
-inline Grids line_rasterization(const Line &line, int64_t xdist = RasteXDistance, int64_t ydist = RasteYDistance)
+// Bounding boxes stored as a structure of arrays for the sort and sweep broad phase.
+struct SweepBoxes
 {
-    Grids     res;
-    Point     rayStart     = line.a;
-    Point     rayEnd       = line.b;
-    IndexPair currentVoxel = point_map_grid_index(rayStart, xdist, ydist);
-    IndexPair lastVoxel    = point_map_grid_index(rayEnd, xdist, ydist);
-
-    Point ray = rayEnd - rayStart;
-
-    double stepX = ray.x() >= 0 ? 1 : -1;
-    double stepY = ray.y() >= 0 ? 1 : -1;
-
-    double nextVoxelBoundaryX = (currentVoxel.first + stepX) * xdist;
-    double nextVoxelBoundaryY = (currentVoxel.second + stepY) * ydist;
-
-    if (stepX < 0) { nextVoxelBoundaryX += xdist; }
-    if (stepY < 0) { nextVoxelBoundaryY += ydist; }
-
-    double tMaxX = ray.x() != 0 ? (nextVoxelBoundaryX - rayStart.x()) / ray.x() : DBL_MAX;
-    double tMaxY = ray.y() != 0 ? (nextVoxelBoundaryY - rayStart.y()) / ray.y() : DBL_MAX;
-
-    double tDeltaX = ray.x() != 0 ? static_cast<double>(xdist) / ray.x() * stepX : DBL_MAX;
-    double tDeltaY = ray.y() != 0 ? static_cast<double>(ydist) / ray.y() * stepY : DBL_MAX;
-
-    res.push_back(currentVoxel);
-
-    double tx = tMaxX;
-    double ty = tMaxY;
-
-    while (lastVoxel != currentVoxel) {
-        if (lastVoxel.first == currentVoxel.first) {
-            for (int64_t i = currentVoxel.second; i != lastVoxel.second; i += (int64_t) stepY) {
-                currentVoxel.second += (int64_t) stepY;
-                res.push_back(currentVoxel);
-            }
-            break;
-        }
-        if (lastVoxel.second == currentVoxel.second) {
-            for (int64_t i = currentVoxel.first; i != lastVoxel.first; i += (int64_t) stepX) {
-                currentVoxel.first += (int64_t) stepX;
-                res.push_back(currentVoxel);
-            }
-            break;
-        }
-
-        if (tx < ty) {
-            currentVoxel.first += (int64_t) stepX;
-            tx += tDeltaX;
-        } else {
-            currentVoxel.second += (int64_t) stepY;
-            ty += tDeltaY;
-        }
-        res.push_back(currentVoxel);
-        if (res.size() >= 100000) { // bug
-            assert(0);
+    std::vector<coord_t> min_x, max_x, min_y, max_y;
+
+    size_t size() const { return min_x.size(); }
+    void   push_back(const BoundingBox &bbox)
+    {
+        min_x.emplace_back(bbox.min.x());
+        max_x.emplace_back(bbox.max.x());
+        min_y.emplace_back(bbox.min.y());
+        max_y.emplace_back(bbox.max.y());
+    }
+    BoundingBox bbox(size_t i) const { return { Point(min_x[i], min_y[i]), Point(max_x[i], max_y[i]) }; }
+
+    // Sort the boxes by their minimum X and sweep along the X axis, call fn(i, j) for each pair of overlapping boxes
+    // until fn returns true. Returns true if stopped by fn.
+    template<typename Fn> bool sweep(Fn &&fn) const
+    {
+        std::vector<size_t> order(this->size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [this](size_t l, size_t r) { return min_x[l] < min_x[r]; });
+        std::vector<size_t> active;
+        for (size_t i : order) {
+            // Drop the boxes ending before this one starts, test the rest.
+            size_t num_active = 0;
+            for (size_t j : active)
+                if (max_x[j] >= min_x[i]) {
+                    active[num_active ++] = j;
+                    if (max_y[j] >= min_y[i] && min_y[j] <= max_y[i] && fn(j, i))
+                        return true;
+                }
+            active.resize(num_active);
+            active.emplace_back(i);
         }
+        return false;
     }
+};
 
-    return res;
+static BoundingBox get_extents(const std::vector<ExtrusionPaths> &layers)
+{
+    // Merge the points one by one, the bounding box of a single axis aligned segment is not "defined".
+    BoundingBox bbox;
+    for (const ExtrusionPaths &paths : layers)
+        for (const ExtrusionPath &path : paths)
+            for (const Point &pt : path.as_polyline().to_polyline().points)
+                bbox.merge(pt);
+    return bbox;
 }
-} // namespace RasterizationImpl
 
 
 
@@ -274,22 +246,57 @@ std::pair<std::vector<ExtrusionPaths>, std::vector<ExtrusionPaths>> getAllLayers
 
 ConflictComputeOpt ConflictChecker::find_inter_of_lines(const LineWithIDs &lines)
 {
-    using namespace RasterizationImpl;
-    std::map<IndexPair, std::vector<int>> indexToLine;
-
-    for (int i = 0; i < (int)lines.size(); ++i) {
-        const LineWithID &l1      = lines[i];
-        auto              indexes = line_rasterization(l1._line);
-        for (auto index : indexes) {
-            const auto &possibleIntersectIdxs = indexToLine[index];
-            for (auto possibleIntersectIdx : possibleIntersectIdxs) {
-                const LineWithID &l2 = lines[possibleIntersectIdx];
-                if (auto interRes = line_intersect(l1, l2); interRes.has_value()) { return interRes; }
+    // Footprints of the instances in this layer.
+    std::map<std::pair<int, int>, int> footprint_ids;
+    std::vector<int>                   line_footprints(lines.size());
+    std::vector<BoundingBox>           footprints;
+    for (size_t i = 0; i < lines.size(); ++ i) {
+        const LineWithID &line = lines[i];
+        auto [it, inserted] = footprint_ids.insert({ { line._obj_id, line._inst_id }, int(footprints.size()) });
+        if (inserted)
+            footprints.emplace_back();
+        line_footprints[i] = it->second;
+        footprints[it->second].merge(line._line.a);
+        footprints[it->second].merge(line._line.b);
+    }
+
+    // Broad phase: only the lines inside the overlaps of the footprints of different instances may intersect.
+    SweepBoxes footprint_boxes;
+    for (const BoundingBox &bbox : footprints)
+        footprint_boxes.push_back(bbox);
+    std::vector<BoundingBoxes> overlaps(footprints.size());
+    bool                       any_overlap = false;
+    footprint_boxes.sweep([&footprint_boxes, &overlaps, &any_overlap](size_t i, size_t j) {
+        BoundingBox bi = footprint_boxes.bbox(i), bj = footprint_boxes.bbox(j);
+        BoundingBox overlap(bi.min.cwiseMax(bj.min), bi.max.cwiseMin(bj.max));
+        overlaps[i].emplace_back(overlap);
+        overlaps[j].emplace_back(overlap);
+        any_overlap = true;
+        return false;
+    });
+    if (! any_overlap)
+        return {};
+
+    SweepBoxes       candidates;
+    std::vector<int> candidate_lines;
+    for (size_t i = 0; i < lines.size(); ++ i)
+        if (const BoundingBoxes &line_overlaps = overlaps[line_footprints[i]]; ! line_overlaps.empty()) {
+            BoundingBox bbox(lines[i]._line.a.cwiseMin(lines[i]._line.b), lines[i]._line.a.cwiseMax(lines[i]._line.b));
+            if (std::any_of(line_overlaps.begin(), line_overlaps.end(), [&bbox](const BoundingBox &overlap) { return overlap.overlap(bbox); })) {
+                candidates.push_back(bbox);
+                candidate_lines.emplace_back(int(i));
             }
-            indexToLine[index].push_back(i);
         }
-    }
-    return {};
+
+    // Narrow phase: intersect the lines of different instances with overlapping bounding boxes.
+    ConflictComputeOpt out;
+    candidates.sweep([&](size_t i, size_t j) {
+        int li = candidate_lines[i], lj = candidate_lines[j];
+        if (line_footprints[li] != line_footprints[lj])
+            out = line_intersect(lines[li], lines[lj]);
+        return out.has_value();
+    });
+    return out;
 }
 
 ConflictResultOpt ConflictChecker::find_inter_of_lines_in_diff_objs(SpanOfConstPtrs<PrintObject> objs,
@@ -301,22 +308,61 @@ ConflictResultOpt ConflictChecker::find_inter_of_lines_in_diff_objs(SpanOfConstP
     // Let's use the address of this variable to represent the wipe tower.
     int wtptr = 0;
 
-    LinesBucketQueue conflictQueue;
-    if (! wipe_tower_data.z_and_depth_pairs.empty()) {
+    // Extract the extrusions of the objects in parallel, together with their bounding boxes.
+    std::vector<std::pair<std::vector<ExtrusionPaths>, std::vector<ExtrusionPaths>>> objs_layers(objs.size());
+    std::vector<BoundingBox>                                                          objs_bboxes(objs.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, objs.size()), [&objs, &objs_layers, &objs_bboxes](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            objs_layers[i] = getAllLayersExtrusionPathsFromObject(objs[i]);
+            objs_bboxes[i] = get_extents(objs_layers[i].first);
+            objs_bboxes[i].merge(get_extents(objs_layers[i].second));
+        }
+    });
+    std::vector<ExtrusionPaths> wtpaths;
+    if (! wipe_tower_data.z_and_depth_pairs.empty())
         // The wipe tower is being generated.
+        wtpaths = getFakeExtrusionPathsFromWipeTower(wipe_tower_data);
+
+    // Broad phase: only the objects, whose instances overlap another instance or the wipe tower, may collide.
+    // The wipe tower is marked by objs.size().
+    SweepBoxes       footprints;
+    std::vector<int> footprint_owners;
+    if (BoundingBox bbox = get_extents(wtpaths); bbox.defined) {
+        footprints.push_back(bbox);
+        footprint_owners.emplace_back(int(objs.size()));
+    }
+    for (size_t i = 0; i < objs.size(); ++ i)
+        if (objs_bboxes[i].defined)
+            for (const PrintInstance &inst : objs[i]->instances()) {
+                BoundingBox bbox = objs_bboxes[i];
+                bbox.translate(inst.shift);
+                footprints.push_back(bbox);
+                footprint_owners.emplace_back(int(i));
+            }
+    std::vector<bool> colliding(objs.size() + 1, false);
+    footprints.sweep([&footprint_owners, &colliding](size_t i, size_t j) {
+        colliding[footprint_owners[i]] = true;
+        colliding[footprint_owners[j]] = true;
+        return false;
+    });
+    if (std::find(colliding.begin(), colliding.end(), true) == colliding.end())
+        return {};
+
+    LinesBucketQueue conflictQueue;
+    if (colliding.back()) {
         const Vec2d plate_origin = Vec2d::Zero();
-        std::vector<ExtrusionPaths> wtpaths = getFakeExtrusionPathsFromWipeTower(wipe_tower_data);
         conflictQueue.emplace_back_bucket(std::move(wtpaths), &wtptr, Points{Point(plate_origin)});
     }
-    for (const PrintObject *obj : objs) {
-        std::pair<std::vector<ExtrusionPaths>, std::vector<ExtrusionPaths>> layers = getAllLayersExtrusionPathsFromObject(obj);
-
+    for (size_t i = 0; i < objs.size(); ++ i) {
+        if (! colliding[i])
+            continue;
+        const PrintObject *obj = objs[i];
         Points instances_shifts;
         for (const PrintInstance& inst : obj->instances())
             instances_shifts.emplace_back(inst.shift);
 
-        conflictQueue.emplace_back_bucket(std::move(layers.first), obj, instances_shifts);
-        conflictQueue.emplace_back_bucket(std::move(layers.second), obj, instances_shifts);
+        conflictQueue.emplace_back_bucket(std::move(objs_layers[i].first), obj, instances_shifts);
+        conflictQueue.emplace_back_bucket(std::move(objs_layers[i].second), obj, instances_shifts);
     }
     conflictQueue.build_queue();
 
@@ -329,7 +375,7 @@ ConflictResultOpt ConflictChecker::find_inter_of_lines_in_diff_objs(SpanOfConstP
         layersLines.push_back(std::move(lines));
     }
 
-    bool                                   find = false;
+    std::atomic<bool>                      find = false;
     tbb::concurrent_vector<std::tuple<ConflictComputeResult, double, int>> conflict;
 
     tbb::parallel_for(tbb::blocked_range<size_t>(0, layersLines.size()), [&](tbb::blocked_range<size_t> range) {
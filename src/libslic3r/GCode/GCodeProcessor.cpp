@@ -291,10 +291,9 @@ static void recalculate_trapezoids(std::vector<GCodeProcessor::TimeBlock>& block
             // Recalculate if current block entry or exit junction speed has changed.
             if (curr->flags.recalculate || next->flags.recalculate) {
                 // NOTE: Entry and exit factors always > 0 by all previous logic operations.
-                GCodeProcessor::TimeBlock block = *curr;
-                block.feedrate_profile.exit = next->feedrate_profile.entry;
-                block.calculate_trapezoid();
-                curr->trapezoid = block.trapezoid;
+                // The exit feedrate is only an input of calculate_trapezoid(), thus it may be overwritten in place.
+                curr->feedrate_profile.exit = next->feedrate_profile.entry;
+                curr->calculate_trapezoid();
                 curr->flags.recalculate = false; // Reset current only to ensure next trapezoid is computed
             }
         }
@@ -302,14 +301,41 @@ static void recalculate_trapezoids(std::vector<GCodeProcessor::TimeBlock>& block
 
     // Last/newest block in buffer. Always recalculated.
     if (next != nullptr) {
-        GCodeProcessor::TimeBlock block = *next;
-        block.feedrate_profile.exit = next->safe_feedrate;
-        block.calculate_trapezoid();
-        next->trapezoid = block.trapezoid;
+        next->feedrate_profile.exit = next->safe_feedrate;
+        next->calculate_trapezoid();
         next->flags.recalculate = false;
     }
 }
 
+// The blocks are copied into a structure of arrays to evaluate the trapezoids with SIMD. The operations and their order
+// are the same as of TimeBlock::time(), thus the times only differ if the compiler contracts the expressions into
+// fused multiply-adds differently.
+Eigen::ArrayXf GCodeProcessor::blocks_time(const std::vector<TimeBlock>& blocks, size_t num_blocks)
+{
+    const Eigen::Index n = Eigen::Index(num_blocks);
+    Eigen::ArrayXf entry(n), acceleration(n), accelerate_until(n), decelerate_after(n), cruise_feedrate(n), distance(n);
+    for (Eigen::Index i = 0; i < n; ++i) {
+        const TimeBlock& block = blocks[i];
+        entry[i]            = block.feedrate_profile.entry;
+        acceleration[i]     = block.acceleration;
+        accelerate_until[i] = block.trapezoid.accelerate_until;
+        decelerate_after[i] = block.trapezoid.decelerate_after;
+        cruise_feedrate[i]  = block.trapezoid.cruise_feedrate;
+        distance[i]         = block.distance;
+    }
+    // Both branches are evaluated, the infinities of the divisions by zero are thrown away by select().
+    // Trapezoid::acceleration_time()
+    const Eigen::ArrayXf acceleration_time = (acceleration != 0.0f).select(
+        ((entry.square() + 2.0f * acceleration * accelerate_until).max(0.0f).sqrt() - entry) / acceleration, 0.0f);
+    // Trapezoid::cruise_time()
+    const Eigen::ArrayXf cruise_time = (cruise_feedrate != 0.0f).select((decelerate_after - accelerate_until) / cruise_feedrate, 0.0f);
+    // Trapezoid::deceleration_time()
+    const Eigen::ArrayXf deceleration = -acceleration;
+    const Eigen::ArrayXf deceleration_time = (deceleration != 0.0f).select(
+        ((cruise_feedrate.square() + 2.0f * deceleration * (distance - decelerate_after)).max(0.0f).sqrt() - cruise_feedrate) / deceleration, 0.0f);
+    return acceleration_time + cruise_time + deceleration_time;
+}
+
 void GCodeProcessor::TimeMachine::calculate_time(size_t keep_last_n_blocks, float additional_time)
 {
     if (!enabled || blocks.size() < 2)
@@ -329,9 +355,11 @@ void GCodeProcessor::TimeMachine::calculate_time(size_t keep_last_n_blocks, floa
     recalculate_trapezoids(blocks);
 
     size_t n_blocks_process = blocks.size() - keep_last_n_blocks;
+    const Eigen::ArrayXf blocks_times = blocks_time(blocks, n_blocks_process);
+    // The statistics are accumulated block by block in the same order as before, so the sums do not change.
     for (size_t i = 0; i < n_blocks_process; ++i) {
         const TimeBlock& block = blocks[i];
-        float block_time = block.time() * time_acceleration;
+        float block_time = blocks_times[i] * time_acceleration;
         if (i == 0)
             block_time += additional_time;
 
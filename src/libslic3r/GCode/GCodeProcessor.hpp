@@ -304,6 +304,9 @@ namespace Slic3r {
             float time() const;
         };
 
+        // Times of the first num_blocks blocks, same as TimeBlock::time(), evaluated over arrays to vectorize.
+        static Eigen::ArrayXf blocks_time(const std::vector<TimeBlock>& blocks, size_t num_blocks);
+
     private:
         struct TimeMachine
         {
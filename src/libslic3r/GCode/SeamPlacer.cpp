@@ -11,6 +11,7 @@
 #include "tbb/parallel_for.h"
 #include "tbb/blocked_range.h"
 #include "tbb/parallel_reduce.h"
+#include <boost/functional/hash.hpp>
 #include <boost/log/trivial.hpp>
 #include <algorithm>
 #include <queue>
@@ -169,6 +170,8 @@ std::vector<float> raycast_visibility(const AABBTreeIndirect::Tree<3, float> &ra
                     &raycasting_tree, &result, &samples, deactivate](tbb::blocked_range<size_t> r) {
                 // Maintaining hits memory outside of the loop, so it does not have to be reallocated for each query.
                 std::vector<igl::Hit> hits;
+                std::vector<Vec3d> ray_origins;
+                std::vector<Vec3d> ray_dirs;
                 for (size_t s_idx = r.begin(); s_idx < r.end(); ++s_idx) {
                     result[s_idx] = 1.0f;
                     if (deactivate) {
@@ -183,20 +186,25 @@ std::vector<float> raycast_visibility(const AABBTreeIndirect::Tree<3, float> &ra
                     Frame f;
                     f.set_from_z(normal);
 
-                    for (const auto &dir : precomputed_sample_directions) {
-                        Vec3f final_ray_dir = (f.to_world(dir));
-                        if (!model_contains_negative_parts) {
-                            igl::Hit hitpoint;
-                            // FIXME: This AABBTTreeIndirect query will not compile for float ray origin and
-                            // direction.
-                            Vec3d final_ray_dir_d = final_ray_dir.cast<double>();
-                            Vec3d ray_origin_d = (center + normal * 0.01f).cast<double>(); // start above surface.
-                            bool hit = AABBTreeIndirect::intersect_ray_first_hit(triangles.vertices,
-                                    triangles.indices, raycasting_tree, ray_origin_d, final_ray_dir_d, hitpoint);
-                            if (hit && its_face_normal(triangles, hitpoint.id).dot(final_ray_dir) <= 0) {
+                    if (!model_contains_negative_parts) {
+                        // All the rays of a sample start at the same point, cast them as a single bundle.
+                        // FIXME: This AABBTTreeIndirect query will not compile for float ray origin and
+                        // direction.
+                        ray_origins.assign(precomputed_sample_directions.size(), (center + normal * 0.01f).cast<double>()); // start above surface.
+                        ray_dirs.clear();
+                        for (const auto &dir : precomputed_sample_directions)
+                            ray_dirs.emplace_back(f.to_world(dir).cast<double>());
+                        AABBTreeIndirect::intersect_rays_first_hit(triangles.vertices,
+                                triangles.indices, raycasting_tree, ray_origins, ray_dirs, hits);
+                        for (size_t ray_idx = 0; ray_idx < hits.size(); ++ray_idx) {
+                            if (hits[ray_idx].id != -1 && its_face_normal(triangles, hits[ray_idx].id).dot(ray_dirs[ray_idx].cast<float>()) <= 0) {
                                 result[s_idx] -= decrease_step;
                             }
-                        } else { //TODO improve logic for order based boolean operations - consider order of volumes
+                        }
+                    } else {
+                        for (const auto &dir : precomputed_sample_directions) {
+                            Vec3f final_ray_dir = (f.to_world(dir));
+                            //TODO improve logic for order based boolean operations - consider order of volumes
                             bool casting_from_negative_volume = samples.triangle_indices[s_idx]
                                     >= negative_volumes_start_index;
 
@@ -1212,7 +1220,7 @@ void pick_random_seam_point(const std::vector<SeamCandidate> &perimeter_points,
 // Store results in the SeamPlacer variables m_seam_per_object
 void SeamPlacer::gather_seam_candidates(const PrintObject *po, const SeamPlacerImpl::GlobalModelInfo &global_model_info, SeamPosition configured_seam_preference) {
     using namespace SeamPlacerImpl;
-    PrintObjectSeamData &seam_data = m_seam_per_object.emplace(po, PrintObjectSeamData { }).first->second;
+    PrintObjectSeamData &seam_data = *m_seam_per_object.emplace(po, std::make_shared<PrintObjectSeamData>()).first->second;
     seam_data.layers.resize(po->layer_count());
     
     // use an antomic idx instead of the range, to avoid a thread being very late because it's on the difficult layers.
@@ -1245,7 +1253,7 @@ void SeamPlacer::calculate_candidates_visibility(const PrintObject *po,
         const SeamPlacerImpl::GlobalModelInfo &global_model_info) {
     using namespace SeamPlacerImpl;
 
-    std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object[po].layers;
+    std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object[po]->layers;
     tbb::parallel_for(tbb::blocked_range<size_t>(0, layers.size()),
             [&layers, &global_model_info](tbb::blocked_range<size_t> r) {
                 for (size_t layer_idx = r.begin(); layer_idx < r.end(); ++layer_idx) {
@@ -1261,7 +1269,7 @@ void SeamPlacer::calculate_overhangs_and_layer_embedding(const PrintObject *po)
     using namespace SeamPlacerImpl;
     using PerimeterDistancer = AABBTreeLines::LinesDistancer<Linef>;
 
-    std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object[po].layers;
+    std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object[po]->layers;
     tbb::parallel_for(tbb::blocked_range<size_t>(0, layers.size()),
             [po, &layers](tbb::blocked_range<size_t> r) {
                 std::unique_ptr<PerimeterDistancer> prev_layer_distancer;
@@ -1392,7 +1400,7 @@ std::optional<std::pair<size_t, size_t>> SeamPlacer::find_next_seam_in_layer(
 // get the nearests points from layers above & below. stop when the seam_align_tolerable_dist_factor don't allow to jump to a point, 
 std::vector<std::pair<size_t, size_t>> SeamPlacer::find_seam_string(const PrintObject *po,
         std::pair<size_t, size_t> start_seam, const SeamPlacerImpl::SeamComparator &comparator) const {
-    const std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object.find(po)->second.layers;
+    const std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object.find(po)->second->layers;
     int layer_idx = start_seam.first;
 
     //initialize searching for seam string - cluster of nearby seams on previous and next layers
@@ -1476,7 +1484,7 @@ void SeamPlacer::align_seam_points(const PrintObject *po, const SeamPlacerImpl::
 #endif
 
     //gather vector of all seams on the print_object - pair of layer_index and seam__index within that layer
-    const std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object[po].layers;
+    const std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object[po]->layers;
     std::vector<std::pair<size_t, size_t>> seams;
     for (size_t layer_idx = 0; layer_idx < layers.size(); ++layer_idx) {
         const std::vector<SeamCandidate> &layer_perimeter_points = layers[layer_idx].points;
@@ -1724,14 +1732,39 @@ void SeamPlacer::align_seam_points(const PrintObject *po, const SeamPlacerImpl::
 
 }
 
-void SeamPlacer::init(const Print &print, std::function<void(void)> throw_if_canceled_func) {
+// Hash of the inputs of the seam data, which do not invalidate the perimeters of the object.
+static size_t seam_data_key(const PrintObject &po)
+{
+    const PrintObjectConfig &config = po.config();
+    size_t seed = size_t(config.seam_position.value);
+    boost::hash_combine(seed, config.seam_angle_cost.value);
+    boost::hash_combine(seed, config.seam_travel_cost.value);
+    boost::hash_combine(seed, config.seam_visibility.value);
+    for (double nozzle_diameter : po.print()->config().nozzle_diameter.get_values())
+        boost::hash_combine(seed, nozzle_diameter);
+    // Changing the seam painting only invalidates the G-code export.
+    for (const ModelVolume *mv : po.model_object()->volumes) {
+        boost::hash_combine(seed, mv->id().id);
+        boost::hash_combine(seed, mv->seam_facets.timestamp());
+    }
+    // Zero is reserved for the data not calculated yet.
+    return seed == 0 ? 1 : seed;
+}
+
+void SeamPlacer::init(Print &print, std::function<void(void)> throw_if_canceled_func) {
     using namespace SeamPlacerImpl;
     m_seam_per_object.clear();
     cache_volume_to_bb.clear();
     this->external_perimeters_first = print.default_region_config().external_perimeters_first;
 
     for (size_t obj_idx = 0; obj_idx < print.objects().size(); ++ obj_idx) {
-        const PrintObject *po = print.objects()[obj_idx];
+        PrintObject *po = print.get_object(obj_idx);
+        // The seam data is in the object coordinates, thus it stays valid if the instances are moved.
+        const size_t key = seam_data_key(*po);
+        if (const std::shared_ptr<PrintObjectSeamData> &cached = po->seam_data(); cached && cached->key == key) {
+            m_seam_per_object.emplace(po, cached);
+            continue;
+        }
         print.set_status(int((obj_idx * 100) / print.objects().size()),
                          ("Computing seam visibility areas: object %s / %s"),
                          {std::to_string(obj_idx + 1), std::to_string(print.objects().size())},
@@ -1775,7 +1808,7 @@ void SeamPlacer::init(const Print &print, std::function<void(void)> throw_if_can
             BOOST_LOG_TRIVIAL(debug)
             << "SeamPlacer: pick_seam_point : start";
             //pick seam point
-            std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object[po].layers;
+            std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object[po]->layers;
             tbb::parallel_for(tbb::blocked_range<size_t>(0, layers.size()),
                     [&layers, configured_seam_preference, comparator, po](tbb::blocked_range<size_t> r) {
                         for (size_t layer_idx = r.begin(); layer_idx < r.end(); ++layer_idx) {
@@ -1801,8 +1834,10 @@ void SeamPlacer::init(const Print &print, std::function<void(void)> throw_if_can
         }
 
 #ifdef DEBUG_FILES
-        debug_export_points(m_seam_per_object[po].layers, po->bounding_box(), comparator);
+        debug_export_points(m_seam_per_object[po]->layers, po->bounding_box(), comparator);
 #endif
+        m_seam_per_object[po]->key = key;
+        po->seam_data() = m_seam_per_object[po];
     }
 }
 
@@ -1922,7 +1957,7 @@ Point SeamPlacer::place_seam(const Layer *layer, const ExtrusionLoop &loop, cons
     };
 
     const PrintObjectSeamData::LayerSeams &layer_perimeters =
-            m_seam_per_object.find(layer->object())->second.layers[layer_index];
+            m_seam_per_object.find(layer->object())->second->layers[layer_index];
 
     // Find the closest perimeter in the SeamPlacer to this loop.
     // Repeat search until two consecutive points of the loop are found, that result in the same closest_perimeter
@@ -129,6 +129,8 @@ struct PrintObjectSeamData
     std::vector<LayerSeams> layers;
     // Map of PrintObjects (PO) -> vector of layers of PO -> unique_ptr to KD
     // tree of all points of the given layer
+    // Hash of the settings and of the seam painting the data was calculated with, see SeamPlacer::init().
+    size_t key { 0 };
 
     void clear()
     {
@@ -168,12 +170,15 @@ public:
     static constexpr size_t seam_align_mm_per_segment = 4.0f;
 
     //The following data structures hold all perimeter points for all PrintObject.
-    std::unordered_map<const PrintObject*, PrintObjectSeamData> m_seam_per_object;
+    //Shared with the PrintObjects, which keep them for the next export until their perimeters change.
+    std::unordered_map<const PrintObject*, std::shared_ptr<PrintObjectSeamData>> m_seam_per_object;
 
     // if it's expected, we need to randomized at the external perimeter.
     bool external_perimeters_first = false;
 
-    void init(const Print &print, std::function<void(void)> throw_if_canceled_func);
+    // Calculate the seam data of the objects, or reuse the data cached by the objects if their perimeters,
+    // seam settings and seam painting did not change since the last export (for example if only the instances were moved).
+    void init(Print &print, std::function<void(void)> throw_if_canceled_func);
 
     Point place_seam(const Layer *layer, const ExtrusionLoop &loop, const uint16_t print_object_instance_idx, const Point &last_pos) const;
 
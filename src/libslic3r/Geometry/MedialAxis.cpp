@@ -12,6 +12,12 @@
 #include "ClipperUtils.hpp"
 
 #include <boost/log/trivial.hpp>
+#include <boost/functional/hash.hpp>
+
+#include <array>
+#include <list>
+#include <mutex>
+#include <optional>
 
 namespace Slic3r { namespace Geometry {
 
@@ -2041,8 +2047,98 @@ check_circular(ExPolygon& expolygon, coord_t max_variation) {
     return 0;
 }
 
+// Results of MedialAxis::build() with use_cache(true), most recently used first.
+// Prismatic objects have the same thin walls & gap fill on many consecutive layers, and the voronoi diagram is expensive.
+// The layers are processed in parallel, so the cache is shared by all the threads.
+struct MedialAxisCacheEntry
+{
+    size_t                  hash;
+    ExPolygon               surface;
+    // empty if the bounds are the surface.
+    std::optional<ExPolygon> bounds;
+    std::array<coord_t, 9>  params;
+    bool                    stop_at_min_width;
+    ThickPolylines          polylines;
+
+    bool same_input(const MedialAxisCacheEntry& other) const {
+        return this->hash == other.hash && this->params == other.params && this->stop_at_min_width == other.stop_at_min_width &&
+            this->surface == other.surface && this->bounds == other.bounds;
+    }
+};
+
+static constexpr const size_t MedialAxisCacheSize = 256;
+static std::mutex                       s_medial_axis_cache_mutex;
+static std::list<MedialAxisCacheEntry>  s_medial_axis_cache;
+
+static void hash_expolygon(size_t& seed, const ExPolygon& expolygon)
+{
+    auto hash_points = [&seed](const Points& pts) {
+        boost::hash_combine(seed, pts.size());
+        for (const Point& pt : pts) {
+            boost::hash_combine(seed, pt.x());
+            boost::hash_combine(seed, pt.y());
+        }
+    };
+    hash_points(expolygon.contour.points);
+    for (const Polygon& hole : expolygon.holes)
+        hash_points(hole.points);
+}
+
+void
+MedialAxis::clear_cache()
+{
+    std::scoped_lock<std::mutex> lock(s_medial_axis_cache_mutex);
+    s_medial_axis_cache.clear();
+}
+
 void
 MedialAxis::build(ThickPolylines& polylines_out)
+{
+    if (!this->m_use_cache) {
+        this->build_uncached(polylines_out);
+        return;
+    }
+
+    MedialAxisCacheEntry entry;
+    entry.surface = this->m_surface;
+    if (this->m_bounds != &this->m_surface && !(*this->m_bounds == this->m_surface))
+        entry.bounds = *this->m_bounds;
+    entry.params = { this->m_max_width, this->m_min_width, this->m_biggest_width, this->m_min_length, this->m_resolution,
+                     this->m_height, this->m_nozzle_diameter, this->m_taper_size, this->m_extension_length };
+    entry.stop_at_min_width = this->m_stop_at_min_width;
+    entry.hash = 0;
+    hash_expolygon(entry.hash, entry.surface);
+    if (entry.bounds)
+        hash_expolygon(entry.hash, *entry.bounds);
+    for (coord_t param : entry.params)
+        boost::hash_combine(entry.hash, param);
+    boost::hash_combine(entry.hash, entry.stop_at_min_width);
+
+    {
+        std::scoped_lock<std::mutex> lock(s_medial_axis_cache_mutex);
+        for (auto it = s_medial_axis_cache.begin(); it != s_medial_axis_cache.end(); ++it)
+            if (it->same_input(entry)) {
+                s_medial_axis_cache.splice(s_medial_axis_cache.begin(), s_medial_axis_cache, it);
+                append(polylines_out, it->polylines);
+                return;
+            }
+    }
+
+    this->build_uncached(entry.polylines);
+    append(polylines_out, entry.polylines);
+
+    std::scoped_lock<std::mutex> lock(s_medial_axis_cache_mutex);
+    // another thread may have computed the same medial axis in the meantime.
+    for (const MedialAxisCacheEntry& cached : s_medial_axis_cache)
+        if (cached.same_input(entry))
+            return;
+    s_medial_axis_cache.push_front(std::move(entry));
+    if (s_medial_axis_cache.size() > MedialAxisCacheSize)
+        s_medial_axis_cache.pop_back();
+}
+
+void
+MedialAxis::build_uncached(ThickPolylines& polylines_out)
 {
     //static int id = 0;
     //id++;
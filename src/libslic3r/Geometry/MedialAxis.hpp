@@ -92,6 +92,11 @@ public:
     MedialAxis& set_min_length(const coord_t min_length) { this->m_min_length = min_length; return *this; }
     MedialAxis& set_biggest_width(const coord_t biggest_width) { this->m_biggest_width = biggest_width; return *this; }
     MedialAxis& set_extension_length(const coord_t extension_length) { this->m_extension_length = extension_length; return *this; }
+    /// optional parameter: reuse the result of a previous build() with the same surface, bounds and parameters (ie: the same gap fill on consecutive layers of a prismatic object). Default : false
+    MedialAxis& use_cache(const bool use_cache) { this->m_use_cache = use_cache; return *this; }
+
+    /// drop all the results stored by build() with use_cache(true).
+    static void clear_cache();
 
 private:
 
@@ -120,6 +125,8 @@ private:
     bool m_stop_at_min_width;
     // arbitrary extra extension at ends.
     coord_t m_extension_length = 0;
+    // if true, build() looks for the result in the cache before computing the voronoi diagram.
+    bool m_use_cache = false;
 
     //voronoi stuff
     using VD = VoronoiDiagram;
@@ -138,6 +145,9 @@ private:
 
     // functions called by build:
 
+    /// compute the medial axis, without looking into the cache.
+    void build_uncached(ThickPolylines& polylines_out);
+
     /// create a simplied version of surface, store it in expolygon
     void simplify_polygon_frontier();
     /// fusion little polylines created (by voronoi) on the external side of a curve inside the main polyline.
@@ -820,6 +820,74 @@ void Layer::make_perimeters()
     BOOST_LOG_TRIVIAL(trace) << "Generating perimeters for layer " << this->id() << " - Done";
 }
 
+static bool surfaces_equal(const Surfaces &lhs, const Surfaces &rhs)
+{
+    if (lhs.size() != rhs.size())
+        return false;
+    for (size_t i = 0; i < lhs.size(); ++ i) {
+        const Surface &l = lhs[i];
+        const Surface &r = rhs[i];
+        if (l.surface_type != r.surface_type || l.thickness != r.thickness || l.thickness_layers != r.thickness_layers ||
+            l.bridge_angle != r.bridge_angle || l.extra_perimeters != r.extra_perimeters ||
+            l.maxNbSolidLayersOnTop != r.maxNbSolidLayersOnTop || l.priority != r.priority || ! (l.expolygon == r.expolygon))
+            return false;
+    }
+    return true;
+}
+
+// Test whether make_perimeters() would produce the same extrusions and fill areas for this layer as for the other layer.
+// The perimeter generator alternates some features between odd and even layers and treats the first layers differently,
+// thus only layers of the same parity above the first layers, raft and bottom solid layers are considered.
+// Fuzzy skin is random, thus it is never reused.
+bool Layer::has_same_perimeters_input(const Layer &other) const
+{
+    if (m_object != other.m_object || m_regions.size() != other.m_regions.size() || this->height != other.height ||
+        this->id() % 2 != other.id() % 2 || this->id() == 0 || other.id() == 0)
+        return false;
+    const size_t raft_layers = size_t(m_object->config().raft_layers.value);
+    if ((this->id() > raft_layers) != (other.id() > raft_layers) || m_object->print()->config().spiral_vase)
+        return false;
+    for (size_t region_id = 0; region_id < m_regions.size(); ++ region_id) {
+        const LayerRegion &layerm       = *m_regions[region_id];
+        const LayerRegion &other_layerm = *other.m_regions[region_id];
+        const PrintRegionConfig &config = layerm.region().config();
+        if (&layerm.region() != &other_layerm.region() || config.fuzzy_skin != FuzzySkinType::None ||
+            (this->id() >= size_t(config.bottom_solid_layers.value)) != (other.id() >= size_t(config.bottom_solid_layers.value)) ||
+            ! surfaces_equal(layerm.slices().surfaces, other_layerm.slices().surfaces))
+            return false;
+    }
+    auto same_slices = [](const Layer *lhs, const Layer *rhs) {
+        return lhs == rhs || (lhs != nullptr && rhs != nullptr && lhs->lslices() == rhs->lslices());
+    };
+    return m_lslices == other.m_lslices && this->lslices_ex.size() == other.lslices_ex.size() &&
+        same_slices(this->lower_layer, other.lower_layer) && same_slices(this->upper_layer, other.upper_layer);
+}
+
+// Replaces make_perimeters() for a layer with the same perimeters input as the other layer, see has_same_perimeters_input().
+void Layer::copy_perimeters_from(const Layer &other)
+{
+    assert(this->has_same_perimeters_input(other));
+    BOOST_LOG_TRIVIAL(trace) << "Copying perimeters of layer " << other.id() << " to layer " << this->id();
+    for (size_t region_id = 0; region_id < m_regions.size(); ++ region_id) {
+        LayerRegion       &layerm       = *m_regions[region_id];
+        const LayerRegion &other_layerm = *other.m_regions[region_id];
+        if (layerm.slices().empty())
+            continue;
+        layerm.clear();
+        layerm.m_perimeters                       = other_layerm.m_perimeters;
+        layerm.m_thin_fills                       = other_layerm.m_thin_fills;
+        layerm.m_fill_expolygons                  = other_layerm.m_fill_expolygons;
+        layerm.m_fill_expolygons_bboxes           = other_layerm.m_fill_expolygons_bboxes;
+        layerm.m_fill_expolygons_composite        = other_layerm.m_fill_expolygons_composite;
+        layerm.m_fill_expolygons_composite_bboxes = other_layerm.m_fill_expolygons_composite_bboxes;
+        layerm.m_fill_no_overlap_expolygons       = other_layerm.m_fill_no_overlap_expolygons;
+        layerm.m_fill_surfaces                    = other_layerm.m_fill_surfaces;
+    }
+    // Islands reference the extrusions by their indices into the LayerRegions, which are the same as in the other layer.
+    for (size_t lslice_idx = 0; lslice_idx < this->lslices_ex.size(); ++ lslice_idx)
+        this->lslices_ex[lslice_idx].islands = other.lslices_ex[lslice_idx].islands;
+}
+
 void Layer::make_milling_post_process() {
     if (this->object()->print()->config().milling_diameter.empty()) return;
 
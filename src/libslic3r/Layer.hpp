@@ -415,6 +415,9 @@ public:
     // Slices merged into islands, to be used by the elephant foot compensation to trim the individual surfaces with the shrunk merged slices.
     ExPolygons              merged(coordf_t offset_scaled = 0) const;
     void                    make_perimeters();
+    // Prismatic objects: most layers generate the same perimeters as the layer two layers below.
+    bool                    has_same_perimeters_input(const Layer &other) const;
+    void                    copy_perimeters_from(const Layer &other);
     void                    make_milling_post_process();
     void                    make_fills(FillAdaptive::Octree     *adaptive_fill_octree,
                                        FillAdaptive::Octree     *support_fill_octree,
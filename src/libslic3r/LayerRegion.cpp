@@ -126,6 +126,8 @@ void LayerRegion::make_perimeters(
     // Ranges of fill areas above per input slice.
     std::vector<ExPolygonRange>                            &fill_expolygons_ranges)
 {
+    SLIC3R_ALLOCATION_STATISTICS_SCOPE("LayerRegion::make_perimeters");
+
     m_perimeters.clear();
     m_thin_fills.clear();
 
@@ -168,11 +170,19 @@ void LayerRegion::make_perimeters(
 
     const ExPolygons *lower_slices = this->layer()->lower_layer ? &this->layer()->lower_layer->lslices() : nullptr;
     const ExPolygons *upper_slices = this->layer()->upper_layer ? &this->layer()->upper_layer->lslices() : nullptr;
+
+    // The temporaries of the perimeter generator are served by the arena of this thread and released at once.
+    // The generator writes into local collections, which are copied out of the arena at the end.
+    PointsArenaScope          arena;
+    ExtrusionEntityCollection perimeters;
+    ExtrusionEntityCollection thin_fills;
+    ExPolygons                fills;
+    ExPolygons                fill_no_overlap;
     
     for (const Surface &surface : slices) {
-        size_t perimeters_begin = m_perimeters.size();
-        size_t gap_fills_begin = m_thin_fills.size();
-        size_t fill_expolygons_begin = fill_expolygons.size();
+        size_t perimeters_begin = perimeters.size();
+        size_t gap_fills_begin = thin_fills.size();
+        size_t fill_expolygons_begin = fill_expolygons.size() + fills.size();
 
         PerimeterGenerator::PerimeterGenerator g{params};
         g.throw_if_canceled = [this]() { this->layer()->object()->print()->throw_if_canceled(); };
@@ -181,22 +191,29 @@ void LayerRegion::make_perimeters(
             surface, lower_slices, slices, upper_slices,
             // output:
                 // Loops with the external thin walls
-            &m_perimeters,
+            &perimeters,
                 // Gaps without the thin walls
-            &m_thin_fills,
+            &thin_fills,
                 // Infills without the gap fills
-            fill_expolygons,
+            fills,
                 // mask for "no overlap" area
-            m_fill_no_overlap_expolygons
+            fill_no_overlap
         );
 
-        for(auto *peri : this->m_perimeters.entities()) assert(!peri->empty());
+        for(auto *peri : perimeters.entities()) assert(!peri->empty());
 
         perimeter_and_gapfill_ranges.emplace_back(
-            ExtrusionRange{ uint32_t(perimeters_begin), uint32_t(m_perimeters.size()) }, 
-            ExtrusionRange{ uint32_t(gap_fills_begin),  uint32_t(m_thin_fills.size()) });
-        fill_expolygons_ranges.emplace_back(ExtrusionRange{ uint32_t(fill_expolygons_begin), uint32_t(fill_expolygons.size()) });
+            ExtrusionRange{ uint32_t(perimeters_begin), uint32_t(perimeters.size()) }, 
+            ExtrusionRange{ uint32_t(gap_fills_begin),  uint32_t(thin_fills.size()) });
+        fill_expolygons_ranges.emplace_back(ExtrusionRange{ uint32_t(fill_expolygons_begin), uint32_t(fill_expolygons.size() + fills.size()) });
     }
+
+    // Copy the results out of the arena, the copies are allocated on the heap.
+    arena.stop();
+    m_perimeters.append(perimeters.entities());
+    m_thin_fills.append(thin_fills.entities());
+    fill_expolygons.insert(fill_expolygons.end(), fills.begin(), fills.end());
+    m_fill_no_overlap_expolygons.insert(m_fill_no_overlap_expolygons.end(), fill_no_overlap.begin(), fill_no_overlap.end());
 }
 
 void LayerRegion::make_milling_post_process(const SurfaceCollection& slices) {
@@ -474,6 +491,8 @@ static Surfaces expand_merge_surfaces(
 
 void LayerRegion::process_external_surfaces(const Layer *lower_layer, const Polygons *lower_layer_covered)
 {
+    SLIC3R_ALLOCATION_STATISTICS_SCOPE("LayerRegion::process_external_surfaces");
+
     using namespace Slic3r::Algorithm;
 
 #ifdef SLIC3R_DEBUG_SLICE_PROCESSING
@@ -948,6 +967,8 @@ void LayerRegion::process_external_surfaces(const Layer *lower_layer, const Poly
 
 void LayerRegion::prepare_fill_surfaces()
 {
+    SLIC3R_ALLOCATION_STATISTICS_SCOPE("LayerRegion::prepare_fill_surfaces");
+
 #ifdef SLIC3R_DEBUG_SLICE_PROCESSING
     export_region_slices_to_svg_debug("2_prepare_fill_surfaces-initial");
     export_region_fill_surfaces_to_svg_debug("2_prepare_fill_surfaces-initial");
@@ -19,6 +19,40 @@
 #include <openvdb/tools/Composite.h>
 #include <openvdb/tools/LevelSetRebuild.h>
 #include <openvdb/tools/FastSweeping.h>
+#include <openvdb/tools/Interpolation.h>
+
+#include <libslic3r/MarchingSquares.hpp>
+#include <libslic3r/ClipperUtils.hpp>
+#include <libslic3r/Execution/ExecutionTBB.hpp>
+
+namespace Slic3r {
+
+// Inside / outside mask of a plane sampled on a regular lattice, contoured by marching squares.
+struct GridSliceMask
+{
+    size_t               rows = 0, cols = 0;
+    std::vector<uint8_t> data;
+};
+
+} // namespace Slic3r
+
+namespace marchsq {
+
+template<> struct _RasterTraits<Slic3r::GridSliceMask> {
+    using Rst = Slic3r::GridSliceMask;
+
+    // The type of pixel cell in the raster
+    using ValueType = uint8_t;
+
+    // Value at a given position
+    static uint8_t get(const Rst &rst, size_t row, size_t col) { return rst.data[row * rst.cols + col]; }
+
+    // Number of rows and cols of the raster
+    static size_t rows(const Rst &rst) { return rst.rows; }
+    static size_t cols(const Rst &rst) { return rst.cols; }
+};
+
+} // namespace marchsq
 
 namespace Slic3r {
 
@@ -179,6 +213,92 @@ indexed_triangle_set grid_to_mesh(const VoxelGrid &vgrid,
     return ret;
 }
 
+std::vector<ExPolygons> grid_to_slices(const VoxelGrid         &vgrid,
+                                       const std::vector<float> &zs,
+                                       double                    isovalue,
+                                       double                    sample_size,
+                                       std::function<void()>     throw_on_cancel)
+{
+    openvdb::initialize();
+
+    std::vector<ExPolygons> slices(zs.size());
+
+    const openvdb::FloatGrid &grid = vgrid.grid;
+    openvdb::CoordBBox        ibb  = grid.evalActiveVoxelBoundingBox();
+    if (ibb.empty() || sample_size <= 0.)
+        return slices;
+
+    // One voxel of margin, so that the contours touching the active voxels are closed.
+    ibb.expand(1);
+    const openvdb::BBoxd wbb  = grid.transform().indexToWorld(ibb);
+    const size_t         cols = size_t(std::ceil((wbb.max().x() - wbb.min().x()) / sample_size)) + 1;
+    const size_t         rows = size_t(std::ceil((wbb.max().y() - wbb.min().y()) / sample_size)) + 1;
+
+    execution::for_each(
+        ex_tbb, size_t(0), zs.size(),
+        [&grid, &zs, &slices, &wbb, rows, cols, isovalue, sample_size, &throw_on_cancel](size_t i) {
+            const double z = zs[i];
+            if (z < wbb.min().z() || z > wbb.max().z())
+                return;
+            throw_on_cancel();
+
+            openvdb::FloatGrid::ConstAccessor accessor = grid.getConstAccessor();
+            openvdb::tools::GridSampler<openvdb::FloatGrid::ConstAccessor, openvdb::tools::BoxSampler> sampler(accessor, grid.transform());
+
+            GridSliceMask mask{ rows, cols, std::vector<uint8_t>(rows * cols, 0) };
+            bool          empty = true;
+            for (size_t r = 0; r < rows; ++ r)
+                for (size_t c = 0; c < cols; ++ c) {
+                    const float v = sampler.wsSample(openvdb::Vec3d(wbb.min().x() + c * sample_size, wbb.min().y() + r * sample_size, z));
+                    // The same classification as volumeToMesh() does.
+                    if (v < isovalue) {
+                        mask.data[r * cols + c] = 255;
+                        empty = false;
+                    }
+                }
+            if (empty)
+                return;
+
+            // The ring vertices of marching squares snap to the lattice. Move each of them onto the
+            // isosurface by Newton steps along the gradient of the sampled field, so that the contours
+            // are not quantized to the sample size.
+            auto value = [&sampler, z](const Vec2d &p) { return double(sampler.wsSample(openvdb::Vec3d(p.x(), p.y(), z))); };
+            const double h = 0.5 * sample_size;
+            auto to_isosurface = [&value, h, isovalue, sample_size](const Vec2d &p0) {
+                Vec2d p = p0;
+                for (int iter = 0; iter < 2; ++ iter) {
+                    const double v = value(p) - isovalue;
+                    const Vec2d  g{ (value(p + Vec2d(h, 0.)) - value(p - Vec2d(h, 0.))) / (2. * h),
+                                    (value(p + Vec2d(0., h)) - value(p - Vec2d(0., h))) / (2. * h) };
+                    const double g2 = g.squaredNorm();
+                    if (g2 < EPSILON)
+                        break;
+                    p -= (v / g2) * g;
+                }
+                // Never move farther than a sample, the lattice vertex is accurate to that already.
+                Vec2d d = p - p0;
+                if (d.squaredNorm() > sample_size * sample_size)
+                    p = p0 + d.normalized() * sample_size;
+                return p;
+            };
+
+            std::vector<marchsq::Ring> rings = marchsq::execute(mask, uint8_t(128), { 2, 2 });
+            Polygons polys;
+            polys.reserve(rings.size());
+            for (const marchsq::Ring &ring : rings) {
+                Polygon poly;
+                poly.points.reserve(ring.size());
+                for (const marchsq::Coord &crd : ring)
+                    poly.points.emplace_back(scaled(to_isosurface({ wbb.min().x() + crd.c * sample_size, wbb.min().y() + crd.r * sample_size })));
+                polys.emplace_back(std::move(poly));
+            }
+            slices[i] = union_ex(polys);
+        },
+        execution::max_concurrency(ex_tbb));
+
+    return slices;
+}
+
 VoxelGridPtr dilate_grid(const VoxelGrid &vgrid,
                          float            exteriorBandWidth,
                          float            interiorBandWidth)
@@ -6,6 +6,7 @@
 #define OPENVDBUTILS_HPP
 
 #include <libslic3r/TriangleMesh.hpp>
+#include <libslic3r/ExPolygon.hpp>
 
 namespace Slic3r {
 
@@ -64,6 +65,18 @@ indexed_triangle_set grid_to_mesh(const VoxelGrid &grid,
                                   double           adaptivity    = 0.0,
                                   bool relaxDisorientedTriangles = true);
 
+// Slice the isosurface of the grid by horizontal planes at the heights zs in
+// parallel, without generating its mesh. The returned polygons enclose the
+// regions with values below the isovalue. Each plane is sampled with the
+// spacing of sample_size (world units) and contoured by marching squares,
+// the contour vertices are then moved onto the isosurface by interpolating
+// the sampled values.
+std::vector<ExPolygons> grid_to_slices(const VoxelGrid         &grid,
+                                       const std::vector<float> &zs,
+                                       double                    isovalue,
+                                       double                    sample_size,
+                                       std::function<void()>     throw_on_cancel = []{});
+
 VoxelGridPtr dilate_grid(const VoxelGrid &grid,
                          float            exteriorBandWidth = 3.0f,
                          float            interiorBandWidth = 3.0f);
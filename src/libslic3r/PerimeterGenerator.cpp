@@ -4352,6 +4352,7 @@ ProcessSurfaceResult PerimeterGenerator::process_classic(const Parameters &
                                         .use_min_real_width(scale_t(params.ext_perimeter_flow.nozzle_diameter()))
                                         .use_tapers(thin_walls_overlap)
                                         .set_min_length(params.get_ext_perimeter_width() + params.get_ext_perimeter_spacing())
+                                        .use_cache(true)
                                         .build(thin_walls_thickpolys);
                                 }
                                 break;
@@ -4962,6 +4963,7 @@ ProcessSurfaceResult PerimeterGenerator::process_classic(const Parameters &
                 md.set_extension_length(gapfill_extension);
             }
             md.set_biggest_width(max);
+            md.use_cache(true);
             md.build(polylines);
         }
         // create extrusion from lines
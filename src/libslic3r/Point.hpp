@@ -22,6 +22,8 @@
 
 #include <oneapi/tbb/scalable_allocator.h>
 
+#include "PointsAllocator.hpp"
+
 
 #include <Eigen/Geometry> 
 
@@ -65,7 +67,8 @@ using Vec3d   = Eigen::Matrix<double,   3, 1, Eigen::DontAlign>;
 using Vec4d   = Eigen::Matrix<double,   4, 1, Eigen::DontAlign>;
 
 template<typename BaseType>
-using PointsAllocator = tbb::scalable_allocator<BaseType>;
+using PointsAllocator = ArenaScalableAllocator<BaseType>;
+//using PointsAllocator = tbb::scalable_allocator<BaseType>;
 //using PointsAllocator = std::allocator<BaseType>;
 using Points         = std::vector<Point, PointsAllocator<Point>>;
 using PointPtrs      = std::vector<Point*>;
@@ -0,0 +1,122 @@
+#include "PointsAllocator.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace Slic3r {
+
+namespace {
+
+// Monotonic arena of a thread. The memory is allocated in blocks of growing size and released at once by reset().
+class Arena
+{
+public:
+    ~Arena() { this->release(0); }
+
+    void* allocate(std::size_t bytes) noexcept
+    {
+        // Round up to keep the alignment of the blocks.
+        bytes = (bytes + Alignment - 1) & ~(Alignment - 1);
+        // Large vectors would waste the arena, they are rarely temporaries anyway.
+        if (bytes == 0 || bytes > MaxAllocation)
+            return nullptr;
+        if (m_blocks.empty() || m_used + bytes > m_blocks.back().size) {
+            // Continue with the next retained block or allocate a new one.
+            std::size_t size = m_blocks.empty() ? FirstBlockSize : std::min(2 * m_blocks.back().size, MaxBlockSize);
+            if (m_total + size > MaxTotalSize)
+                return nullptr;
+            char *data = static_cast<char*>(scalable_malloc(size));
+            if (data == nullptr)
+                return nullptr;
+            m_blocks.push_back({ data, size });
+            m_total += size;
+            m_used   = 0;
+        }
+        void *ptr = m_blocks.back().data + m_used;
+        m_used += bytes;
+        return ptr;
+    }
+
+    bool owns(const void *ptr) const noexcept
+    {
+        const char *p = static_cast<const char*>(ptr);
+        for (const Block &block : m_blocks)
+            if (p >= block.data && p < block.data + block.size)
+                return true;
+        return false;
+    }
+
+    // Release all the allocations at once. The first block is kept for the next scope of this thread.
+    void reset() noexcept
+    {
+        this->release(1);
+        m_used = 0;
+    }
+
+    // Inside the outermost PointsArenaScope of the thread.
+    bool in_scope { false };
+    // Serving the allocations, until the scope is stopped.
+    bool active   { false };
+
+private:
+    void release(std::size_t num_retained) noexcept
+    {
+        for (std::size_t i = num_retained; i < m_blocks.size(); ++ i)
+            scalable_free(m_blocks[i].data);
+        m_blocks.resize(std::min(num_retained, m_blocks.size()));
+        m_total = m_blocks.empty() ? 0 : m_blocks.front().size;
+    }
+
+    static constexpr std::size_t Alignment      = alignof(std::max_align_t);
+    static constexpr std::size_t FirstBlockSize = 256 * 1024;
+    static constexpr std::size_t MaxBlockSize   = 16 * 1024 * 1024;
+    static constexpr std::size_t MaxTotalSize   = 256 * 1024 * 1024;
+    static constexpr std::size_t MaxAllocation  = 1024 * 1024;
+
+    struct Block
+    {
+        char        *data;
+        std::size_t  size;
+    };
+    std::vector<Block>  m_blocks;
+    // Bytes used of the last block.
+    std::size_t         m_used  { 0 };
+    std::size_t         m_total { 0 };
+};
+
+thread_local Arena s_arena;
+
+} // namespace
+
+void* PointsArena::allocate(std::size_t bytes) noexcept
+{
+    return s_arena.active ? s_arena.allocate(bytes) : nullptr;
+}
+
+bool PointsArena::owns(const void *ptr) noexcept
+{
+    return s_arena.owns(ptr);
+}
+
+PointsArenaScope::PointsArenaScope() : m_owner(! s_arena.in_scope)
+{
+    if (m_owner)
+        s_arena.in_scope = s_arena.active = true;
+}
+
+PointsArenaScope::~PointsArenaScope()
+{
+    if (m_owner) {
+        s_arena.in_scope = s_arena.active = false;
+        s_arena.reset();
+    }
+}
+
+void PointsArenaScope::stop()
+{
+    if (m_owner)
+        s_arena.active = false;
+}
+
+} // namespace Slic3r
@@ -0,0 +1,95 @@
+#ifndef slic3r_PointsAllocator_hpp_
+#define slic3r_PointsAllocator_hpp_
+
+// Allocator of the point vectors of the geometry containers (Points and the contours of Polygons, ExPolygons,
+// Polylines and Surfaces, Clipper paths). The point vectors are allocated through tbb::scalable_allocator,
+// except inside a PointsArenaScope: there the point vectors allocated by the calling thread are served by a monotonic
+// arena of the thread, their deallocation is a no-op and the whole arena is released at once at the end of the scope.
+// The per layer kernels create and destroy millions of short lived point vectors, the arena replaces these
+// allocations with bumping a pointer.
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+#include <oneapi/tbb/scalable_allocator.h>
+
+#include "AllocationStatistics.hpp"
+
+namespace Slic3r {
+
+class Point;
+
+namespace PointsArena {
+    // Memory from the arena of the calling thread if the arena is active and has space for it, nullptr otherwise.
+    void* allocate(std::size_t bytes) noexcept;
+    // Is the memory owned by the arena of the calling thread? Such memory is released with the arena.
+    bool  owns(const void *ptr) noexcept;
+} // namespace PointsArena
+
+// Serves the point vectors allocated by the calling thread from the arena of the thread for the lifetime of the scope.
+// The point vectors allocated inside the scope must not outlive it. The results of the scope are to be copied
+// after stop(): the following allocations are served by the heap again, while the memory of the arena stays valid
+// until the end of the scope. Nested scopes do nothing, the outermost scope of the thread controls the arena.
+// The scope shall not wait for nested TBB tasks, as a task stolen by the waiting thread would allocate its results
+// from the arena.
+class PointsArenaScope
+{
+public:
+    PointsArenaScope();
+    ~PointsArenaScope();
+    PointsArenaScope(const PointsArenaScope&) = delete;
+    PointsArenaScope& operator=(const PointsArenaScope&) = delete;
+
+    // Stop serving the allocations from the arena before the results are copied out.
+    void stop();
+
+private:
+    bool m_owner;
+};
+
+// tbb::scalable_allocator, which serves the point vectors from the arena of the calling thread inside a PointsArenaScope.
+// With SLIC3R_ALLOCATION_STATISTICS defined, it counts the allocations into the counters of the calling thread.
+template<typename T>
+class ArenaScalableAllocator
+{
+public:
+    using value_type = T;
+
+    ArenaScalableAllocator() noexcept = default;
+    template<typename U>
+    ArenaScalableAllocator(const ArenaScalableAllocator<U> &) noexcept {}
+
+    T* allocate(std::size_t n) {
+#ifdef SLIC3R_ALLOCATION_STATISTICS
+        AllocationCounters &counters = thread_allocation_counters();
+        ++ counters.allocations;
+        counters.bytes += n * sizeof(T);
+#endif // SLIC3R_ALLOCATION_STATISTICS
+        // Only the point vectors, the other containers of Clipper are cached by the threads and they would keep the arena memory.
+        if constexpr (std::is_same_v<T, Point>)
+            if (void *ptr = PointsArena::allocate(n * sizeof(T)); ptr)
+                return static_cast<T*>(ptr);
+        if (void *ptr = scalable_malloc(n * sizeof(T)); ptr)
+            return static_cast<T*>(ptr);
+        throw std::bad_alloc();
+    }
+    void deallocate(T *ptr, std::size_t /* n */) noexcept {
+#ifdef SLIC3R_ALLOCATION_STATISTICS
+        ++ thread_allocation_counters().deallocations;
+#endif // SLIC3R_ALLOCATION_STATISTICS
+        if constexpr (std::is_same_v<T, Point>)
+            if (PointsArena::owns(ptr))
+                return;
+        scalable_free(ptr);
+    }
+};
+
+template<typename T, typename U>
+inline bool operator==(const ArenaScalableAllocator<T> &, const ArenaScalableAllocator<U> &) noexcept { return true; }
+template<typename T, typename U>
+inline bool operator!=(const ArenaScalableAllocator<T> &, const ArenaScalableAllocator<U> &) noexcept { return false; }
+
+} // namespace Slic3r
+
+#endif // slic3r_PointsAllocator_hpp_
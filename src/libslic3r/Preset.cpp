@@ -688,6 +688,7 @@ static std::vector<std::string> s_Preset_print_options {
         "first_layer_infill_extrusion_spacing", 
         "first_layer_infill_extrusion_width", 
         "perimeter_round_corners",
+        "perimeter_reuse_identical_layers",
         "perimeter_extrusion_spacing",
         "perimeter_extrusion_width",
         "perimeter_extrusion_change_odd_layers",
@@ -1020,6 +1021,7 @@ static std::vector<std::string> s_Preset_sla_print_options {
     "hollowing_min_thickness",
     "hollowing_quality",
     "hollowing_closing_distance",
+    "hollowing_direct_slicing",
     "output_filename_format",
     "default_sla_print_profile",
     "compatible_printers",
@@ -1086,6 +1088,7 @@ static std::vector<std::string> s_Preset_sla_printer_options {
     "min_exposure_time", "max_exposure_time",
     "min_initial_exposure_time", "max_initial_exposure_time", "sla_output_precision",
     "output_format",
+    "sla_output_compression",
     "sla_output_precision",
     //FIXME the print host keys are left here just for conversion from the Printer preset to Physical Printer preset.
     "print_host", "printhost_apikey", "printhost_cafile", "printhost_port",
@@ -8,6 +8,7 @@
 
 #include "libslic3r.h"
 #include "PresetBundle.hpp"
+#include "ConfigBundleCache.hpp"
 #include "Utils.hpp"
 #include "Model.hpp"
 #include "format.hpp"
@@ -167,6 +168,7 @@ void PresetBundle::setup_directories()
 		data_dir / "vendor",
         data_dir / "cache",
         data_dir / "cache" / "vendor",
+        data_dir / "cache" / "bundles",
         data_dir / "shapes",
 #ifdef SLIC3R_PROFILE_USE_PRESETS_SUBDIR
         // Store the print/filament/printer presets into a "presets" directory.
@@ -1330,9 +1332,13 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
         this->reset(flags.has(LoadConfigBundleAttribute::SaveImported));
 
     // 1) Read the complete config file into a boost::property_tree.
+    // A system bundle does not depend on the other bundles once flattened, thus it may be loaded from its binary snapshot.
     namespace pt = boost::property_tree;
     pt::ptree tree;
-    {
+    const bool                    use_cache  = flags.has(LoadConfigBundleAttribute::LoadSystem);
+    const boost::filesystem::path cache_path = config_bundle_cache_path(boost::filesystem::path(data_dir()) / "cache" / "bundles", path).make_preferred();
+    const bool                    flattened  = use_cache && load_config_bundle_cache(cache_path, path, tree);
+    if (! flattened) {
         boost::nowide::ifstream ifs(path);
         try {
             pt::read_ini(ifs, tree);
@@ -1359,7 +1365,11 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
 
     // 1.5) Flatten the config bundle by applying the inheritance rules. Internal profiles (with names starting with '*') are removed.
     // If loading a user config bundle, do not flatten with the system profiles, but keep the "inherits" flag intact.
-    flatten_configbundle_hierarchy(tree, flags.has(LoadConfigBundleAttribute::LoadSystem) ? nullptr : this);
+    if (! flattened) {
+        flatten_configbundle_hierarchy(tree, flags.has(LoadConfigBundleAttribute::LoadSystem) ? nullptr : this);
+        if (use_cache)
+            save_config_bundle_cache(cache_path, path, tree);
+    }
 
     // 2) Parse the property_tree, extract the active preset names and the profiles, save them into local config files.
     // Parse the obsolete preset names, to be deleted when upgrading from the old configuration structure.
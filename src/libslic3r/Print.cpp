@@ -20,6 +20,7 @@
 ///|/
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
+#include "AllocationStatistics.hpp"
 #include "Exception.hpp"
 #include "Print.hpp"
 #include "BoundingBox.hpp"
@@ -1344,6 +1345,7 @@ void Print::process()
 
     m_timestamp_last_change = std::time(0);
     BOOST_LOG_TRIVIAL(info) << "Slicing process finished." << log_memory_info();
+    log_allocation_statistics();
     //notify gui that the slicing/preview structs are ready to be drawed
     if (something_done)
         this->set_status(printstep_2_percent[PrintStep::psGCodeExport], L("Slicing done"), SlicingStatus::FlagBits::SLICING_ENDED);
@@ -26,6 +26,7 @@
 #include "PrintBase.hpp"
 
 #include "BoundingBox.hpp"
+#include "Brim.hpp"
 #include "ExtrusionEntityCollection.hpp"
 #include "Flow.hpp"
 #include "Point.hpp"
@@ -57,6 +58,7 @@ class Layer;
 class ModelObject;
 class Print;
 class PrintObject;
+struct PrintObjectSeamData;
 class SupportLayer;
 
 namespace FillAdaptive {
@@ -413,6 +415,11 @@ public:
     const std::optional<ExtrusionEntityCollection>& skirt_first_layer() const { return m_skirt_first_layer; }
     const ExtrusionEntityCollection& skirt() const { return m_skirt; }
     const ExtrusionEntityCollection& brim() const { return m_brim; }
+    // First layer footprint of the brim, cached by make_brim() and make_brim_ears().
+    const BrimFootprint&             brim_footprint() const { return m_brim_footprint; }
+    BrimFootprint&                   brim_footprint() { return m_brim_footprint; }
+    // Seam placement data, cached by SeamPlacer::init() between the G-code exports.
+    std::shared_ptr<PrintObjectSeamData>& seam_data() { return m_seam_data; }
 
 protected:
     // to be called from Print only.
@@ -505,6 +512,9 @@ private:
     std::optional<ExtrusionEntityCollection> m_skirt_first_layer;
     ExtrusionEntityCollection               m_skirt;
     ExtrusionEntityCollection               m_brim;
+    BrimFootprint                           m_brim_footprint;
+    // Kept until the perimeters are invalidated.
+    std::shared_ptr<PrintObjectSeamData>    m_seam_data;
 
     // this is set to true when LayerRegion->slices is split in top/internal/bottom
     // so that next call to make_perimeters() performs a union() before computing loops
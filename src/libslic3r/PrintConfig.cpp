@@ -4565,6 +4565,14 @@ void PrintConfigDef::init_fff_params()
     def->mode = comExpert | comSuSi;
     def->set_default_value(new ConfigOptionPercent(100));
 
+    def = this->add("perimeter_reuse_identical_layers", coBool);
+    def->label = L("Reuse the perimeters of identical layers");
+    def->category = OptionCategory::perimeter;
+    def->tooltip = L("Generate the perimeters only once for a run of layers with the same slices, and copy them to the other layers of the run."
+                    " Speeds up the slicing of prismatic objects. The generated perimeters are the same.");
+    def->mode = comExpert | comSuSi;
+    def->set_default_value(new ConfigOptionBool(true));
+
     def = this->add("perimeter_reverse", coBool);
     def->label = L("Perimeter reversal on even layers");
     def->category = OptionCategory::perimeter;
@@ -8283,6 +8291,16 @@ void PrintConfigDef::init_sla_params()
     def->mode = comExpert | comPrusa;
     def->set_default_value(new ConfigOptionFloat(2.0));
 
+    def = this->add("hollowing_direct_slicing", coBool);
+    def->label = L("Slice the interior directly");
+    def->category = OptionCategory::hollowing;
+    def->tooltip  = L(
+        "Slice the hollowed interior directly from its voxel representation instead of "
+        "generating its mesh first. Faster and less memory hungry for large models, "
+        "but the cavity isn't shown in the 3D preview.");
+    def->mode = comExpert | comSuSi;
+    def->set_default_value(new ConfigOptionBool(false));
+
     def = this->add("material_print_speed", coEnum);
     def->label = L("Print speed");
     def->tooltip = L(
@@ -8315,6 +8333,17 @@ void PrintConfigDef::init_sla_params()
     def->mode = comAdvancedE | comSuSi; // output_format should be preconfigured in profiles;
     def->set_default_value(new ConfigOptionEnum<OutputFormat>(ofSL1));
 
+    def = this->add("sla_output_compression", coInt);
+    def->label = L("PNG compression level");
+    def->tooltip = L("Compression level of the PNG images of the layers in the output archive. "
+                     "0 stores the images uncompressed, 1 uses a fast encoder dedicated to the images of the layers, "
+                     "2 to 9 use a general compressor, which is several times slower and compresses the images of the layers "
+                     "about as well, but it may compress better the layers with fine patterns.");
+    def->min = 0;
+    def->max = 9;
+    def->mode = comExpert | comSuSi;
+    def->set_default_value(new ConfigOptionInt(1));
+
     def = this->add("sla_output_precision", coFloat);
     def->label = L("SLA output precision");
     def->tooltip = L("Minimum resolution in nanometers");
@@ -9424,6 +9453,7 @@ std::unordered_set<std::string> prusa_export_to_remove_keys = {
 "hole_to_polyhole_threshold",
 "hole_to_polyhole_twisted",
 "hole_to_polyhole",
+"hollowing_direct_slicing",
 "infill_connection",
 "infill_connection_bottom",
 "infill_connection_bridge",
@@ -9480,6 +9510,7 @@ std::unordered_set<std::string> prusa_export_to_remove_keys = {
 "perimeter_loop_seam",
 "perimeter_loop",
 "perimeter_overlap",
+"perimeter_reuse_identical_layers",
 "perimeter_reverse",
 "perimeter_round_corners",
 "perimeters_hole",
@@ -9516,6 +9547,7 @@ std::unordered_set<std::string> prusa_export_to_remove_keys = {
 "skirt_brim",
 "skirt_distance_from_brim",
 "skirt_extrusion_width",
+"sla_output_compression",
 "small_area_infill_flow_compensation",
 "small_area_infill_flow_compensation_model",
 "small_perimeter_max_length",
@@ -10907,23 +10939,13 @@ std::string validate(const FullPrintConfig& cfg)
     return "";
 }
 
-// Declare and initialize static caches of StaticPrintConfig derived classes.
+// Declare static caches of StaticPrintConfig derived classes. The caches are initialized on the first use of their class.
 #define PRINT_CONFIG_CACHE_ELEMENT_DEFINITION(r, data, CLASS_NAME) StaticPrintConfig::StaticCache<class Slic3r::CLASS_NAME> BOOST_PP_CAT(CLASS_NAME::s_cache_, CLASS_NAME);
-#define PRINT_CONFIG_CACHE_ELEMENT_INITIALIZATION(r, data, CLASS_NAME) Slic3r::CLASS_NAME::initialize_cache();
-#define PRINT_CONFIG_CACHE_INITIALIZE(CLASSES_SEQ) \
-    BOOST_PP_SEQ_FOR_EACH(PRINT_CONFIG_CACHE_ELEMENT_DEFINITION, _, BOOST_PP_TUPLE_TO_SEQ(CLASSES_SEQ)) \
-    int print_config_static_initializer() { \
-        /* Putting a trace here to avoid the compiler to optimize out this function. */ \
-        /*BOOST_LOG_TRIVIAL(trace) << "Initializing StaticPrintConfigs";*/ \
-        /* Tamas: alternative solution through a static volatile int. Boost log pollutes stdout and prevents tests from generating clean output */ \
-        static volatile int ret = 1; \
-        BOOST_PP_SEQ_FOR_EACH(PRINT_CONFIG_CACHE_ELEMENT_INITIALIZATION, _, BOOST_PP_TUPLE_TO_SEQ(CLASSES_SEQ)) \
-        return ret; \
-    }
-PRINT_CONFIG_CACHE_INITIALIZE((
+#define PRINT_CONFIG_CACHE_DEFINE(CLASSES_SEQ) \
+    BOOST_PP_SEQ_FOR_EACH(PRINT_CONFIG_CACHE_ELEMENT_DEFINITION, _, BOOST_PP_TUPLE_TO_SEQ(CLASSES_SEQ))
+PRINT_CONFIG_CACHE_DEFINE((
     PrintObjectConfig, PrintRegionConfig, MachineEnvelopeConfig, GCodeConfig, PrintConfig, FullPrintConfig, 
     SLAMaterialConfig, SLAPrintConfig, SLAPrintObjectConfig, SLAPrinterConfig, SLAFullPrintConfig))
-static int print_config_static_initialized = print_config_static_initializer();
 
 CLIActionsConfigDef::CLIActionsConfigDef()
 {
@@ -10995,6 +11017,21 @@ CLIActionsConfigDef::CLIActionsConfigDef()
     def->set_default_value(new ConfigOptionBool(false));
 #endif // ENABLE_GL_CORE_PROFILE
 
+    def = this->add("batch", coBool);
+    def->label = L("Batch mode");
+    def->tooltip = L("Read jobs from the standard input, one per line, until its end. Each line holds the command line arguments "
+                     "of a single job (actions, transforms, options and input files), which may be quoted with double quotes. "
+                     "Several jobs are processed concurrently (see --batch-jobs), the config files and print objects are kept "
+                     "between the jobs. \"job N done\" or \"job N failed\" is written to the standard output once the N-th job finishes.");
+    def->set_default_value(new ConfigOptionBool(false));
+
+    def = this->add("server", coBool);
+    def->label = L("Slicing server");
+    def->tooltip = L("Run as a headless slicing server listening on a local socket (see --server-socket). The clients send "
+                     "JSON requests changing the config or the model and requesting the slicing, one per line. The sliced print "
+                     "is kept between the requests, so only the steps invalidated by a change are recalculated.");
+    def->set_default_value(new ConfigOptionBool(false));
+
     def = this->add("slice", coBool);
     def->label = L("Slice");
     def->tooltip = L("Slice the model as FFF or SLA based on the printer_technology configuration value.");
@@ -11170,6 +11207,16 @@ CLIMiscConfigDef::CLIMiscConfigDef()
     def->tooltip = L("Sets the maximum number of threads the slicing process will use. If not defined, it will be decided automatically.");
     def->min = 1;
 
+    def = this->add("batch_jobs", coInt);
+    def->label = L("Concurrent batch jobs");
+    def->tooltip = L("Number of jobs processed concurrently in the batch mode. The threads (see --threads) are split evenly between them.");
+    def->min = 1;
+    def->set_default_value(new ConfigOptionInt(1));
+
+    def = this->add("server_socket", coString);
+    def->label = L("Slicing server socket");
+    def->tooltip = L("Path of the local socket the slicing server listens on. If not defined, a socket in the temporary directory is used.");
+
     def = this->add("loglevel", coInt);
     def->label = L("Logging level");
     def->tooltip = L("Sets logging sensitivity. 0:fatal, 1:error, 2:warning, 3:info, 4:debug, 5:trace\n"
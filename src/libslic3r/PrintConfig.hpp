@@ -602,17 +602,19 @@ public: \
     /* Overrides ConfigBase::keys(). Collect names of all configuration values maintained by this configuration store. */ \
     t_config_option_keys     keys() const override { return s_cache_##CLASS_NAME.keys(); } \
     const t_config_option_keys& keys_ref() const override { return s_cache_##CLASS_NAME.keys(); } \
-    static const CLASS_NAME& defaults() { assert(s_cache_##CLASS_NAME.initialized()); return s_cache_##CLASS_NAME.defaults(); } \
+    static const CLASS_NAME& defaults() { initialize_cache(); return s_cache_##CLASS_NAME.defaults(); } \
 private: \
-    friend int print_config_static_initializer(); \
+    /* The cache is initialized on the first use of CLASS_NAME, thus a process not using some of the static configs */ \
+    /* does not pay for their initialization at startup. Thread safe, as the initialization of a local static is. */ \
     static void initialize_cache() \
     { \
-        assert(! s_cache_##CLASS_NAME.initialized()); \
-        if (! s_cache_##CLASS_NAME.initialized()) { \
+        static const bool initialized = []() { \
             CLASS_NAME *inst = new CLASS_NAME(1); \
             inst->initialize(s_cache_##CLASS_NAME, (const char*)inst); \
             s_cache_##CLASS_NAME.finalize(inst, inst->def()); \
-        } \
+            return true; \
+        }(); \
+        assert(initialized && s_cache_##CLASS_NAME.initialized()); \
     } \
     /* Cache object holding a key/option map, a list of option keys and a copy of this static config initialized with the defaults. */ \
     static StaticPrintConfig::StaticCache<CLASS_NAME> s_cache_##CLASS_NAME;
@@ -621,7 +623,7 @@ private: \
     STATIC_PRINT_CONFIG_CACHE_BASE(CLASS_NAME) \
 public: \
     /* Public default constructor will initialize the key/option cache and the default object copy if needed. */ \
-    CLASS_NAME() { assert(s_cache_##CLASS_NAME.initialized()); *this = s_cache_##CLASS_NAME.defaults(); } \
+    CLASS_NAME() { initialize_cache(); *this = s_cache_##CLASS_NAME.defaults(); } \
 protected: \
     /* Protected constructor to be called when compounded. */ \
     CLASS_NAME(int) {}
@@ -687,7 +689,7 @@ protected: \
 #define PRINT_CONFIG_CLASS_DERIVED_DEFINE1(CLASS_NAME, CLASSES_PARENTS_TUPLE, PARAMETER_DEFINITION, PARAMETER_REGISTRATION, PARAMETER_HASHES, PARAMETER_EQUALS) \
 class CLASS_NAME : PRINT_CONFIG_CLASS_DERIVED_CLASS_LIST(CLASSES_PARENTS_TUPLE) { \
     STATIC_PRINT_CONFIG_CACHE_DERIVED(CLASS_NAME) \
-    CLASS_NAME() : PRINT_CONFIG_CLASS_DERIVED_INITIALIZER(CLASSES_PARENTS_TUPLE, 0) { assert(s_cache_##CLASS_NAME.initialized()); *this = s_cache_##CLASS_NAME.defaults(); } \
+    CLASS_NAME() : PRINT_CONFIG_CLASS_DERIVED_INITIALIZER(CLASSES_PARENTS_TUPLE, 0) { initialize_cache(); *this = s_cache_##CLASS_NAME.defaults(); } \
 public: \
     PARAMETER_DEFINITION \
     size_t hash() const throw() \
@@ -768,6 +770,7 @@ PRINT_CONFIG_CLASS_DEFINE(
     ((ConfigOptionFloat,                mmu_segmented_region_interlocking_depth))
     ((ConfigOptionFloat,                model_precision))
     ((ConfigOptionPercent,              perimeter_bonding))
+    ((ConfigOptionBool,                 perimeter_reuse_identical_layers))
     ((ConfigOptionFloat,                raft_contact_distance))
     ((ConfigOptionFloat,                raft_expansion))
     ((ConfigOptionPercent,              raft_first_layer_density))
@@ -1557,6 +1560,9 @@ PRINT_CONFIG_CLASS_DEFINE(
 
     // Indirectly controls the minimum size of created cavities.
     ((ConfigOptionFloat, hollowing_closing_distance))
+
+    // Slice the interior from its grid, without generating the interior mesh.
+    ((ConfigOptionBool, hollowing_direct_slicing))
 )
 
 enum SLAMaterialSpeed { slamsSlow, slamsFast, slamsHighViscosity };
@@ -1624,6 +1630,7 @@ PRINT_CONFIG_CLASS_DEFINE(
     ((ConfigOptionFloat,                        min_initial_exposure_time))
     ((ConfigOptionFloat,                        max_initial_exposure_time))
     ((ConfigOptionString,                       printer_custom_variables))
+    ((ConfigOptionInt,                          sla_output_compression))
     ((ConfigOptionFloat,                        sla_output_precision))
     ((ConfigOptionPoints,                       thumbnails))
     ((ConfigOptionString,                       thumbnails_color))
@@ -271,16 +271,41 @@ void PrintObject::make_perimeters()
         BOOST_LOG_TRIVIAL(debug) << "Generating extra perimeters for region " << region_id << " in parallel - end";
     }
 
+    // Prismatic objects have long runs of layers with the same slices. Generate the perimeters only for the first two layers
+    // of such a run (odd and even layers may differ) and copy them to the other layers of the same parity.
+    std::vector<size_t> perimeters_source_layer(m_layers.size());
+    Slic3r::parallel_for(size_t(0), m_layers.size(),
+        [this, &perimeters_source_layer](const size_t layer_idx) {
+            m_print->throw_if_canceled();
+            perimeters_source_layer[layer_idx] = m_config.perimeter_reuse_identical_layers.value &&
+                layer_idx >= 2 && m_layers[layer_idx]->has_same_perimeters_input(*m_layers[layer_idx - 2]) ?
+                layer_idx - 2 : layer_idx;
+        }
+    );
+    size_t num_layers_copied = 0;
+    for (size_t layer_idx = 0; layer_idx < m_layers.size(); ++ layer_idx)
+        if (size_t source_idx = perimeters_source_layer[layer_idx]; source_idx != layer_idx) {
+            perimeters_source_layer[layer_idx] = perimeters_source_layer[source_idx];
+            ++ num_layers_copied;
+        }
+    m_print->throw_if_canceled();
+
+    auto update_perimeters_status = [this]() {
+        int32_t nb_layers_done = m_print->secondary_status_counter_increment();
+        m_print->set_status( int((nb_layers_done * 100) / m_print->secondary_status_counter_get_max()), L("Generating perimeters: layer %s / %s"), 
+            { std::to_string(nb_layers_done), std::to_string(m_print->secondary_status_counter_get_max()) }, PrintBase::SlicingStatus::SECONDARY_STATE);
+    };
+
     BOOST_LOG_TRIVIAL(debug) << "Generating perimeters in parallel - start";
     Slic3r::parallel_for(size_t(0), m_layers.size(),
-        [this](const size_t layer_idx) {
+        [this, &perimeters_source_layer, &update_perimeters_status](const size_t layer_idx) {
+                if (perimeters_source_layer[layer_idx] != layer_idx)
+                    return;
                 PRINT_OBJECT_TIME_LIMIT_MILLIS(PRINT_OBJECT_TIME_LIMIT_DEFAULT);
                 m_print->throw_if_canceled();
 
                 // updating progress
-                int32_t nb_layers_done = m_print->secondary_status_counter_increment();
-                m_print->set_status( int((nb_layers_done * 100) / m_print->secondary_status_counter_get_max()), L("Generating perimeters: layer %s / %s"), 
-                    { std::to_string(nb_layers_done), std::to_string(m_print->secondary_status_counter_get_max()) }, PrintBase::SlicingStatus::SECONDARY_STATE);
+                update_perimeters_status();
 
                 // make perimeters
                 m_layers[layer_idx]->make_perimeters();
@@ -289,6 +314,21 @@ void PrintObject::make_perimeters()
     m_print->throw_if_canceled();
     BOOST_LOG_TRIVIAL(debug) << "Generating perimeters in parallel - end";
 
+    if (num_layers_copied > 0) {
+        BOOST_LOG_TRIVIAL(debug) << "Copying perimeters of " << num_layers_copied << " identical layers in parallel - start";
+        Slic3r::parallel_for(size_t(0), m_layers.size(),
+            [this, &perimeters_source_layer, &update_perimeters_status](const size_t layer_idx) {
+                if (size_t source_idx = perimeters_source_layer[layer_idx]; source_idx != layer_idx) {
+                    m_print->throw_if_canceled();
+                    update_perimeters_status();
+                    m_layers[layer_idx]->copy_perimeters_from(*m_layers[source_idx]);
+                }
+            }
+        );
+        m_print->throw_if_canceled();
+        BOOST_LOG_TRIVIAL(debug) << "Copying perimeters of " << num_layers_copied << " identical layers in parallel - end";
+    }
+
     if (print()->config().milling_diameter.size() > 0) {
         BOOST_LOG_TRIVIAL(debug) << "Generating milling post-process in parallel - start";
         Slic3r::parallel_for(size_t(0), m_layers.size(),
@@ -1136,6 +1176,7 @@ bool PrintObject::invalidate_state_by_config_options(
             || opt_key == "perimeter_extrusion_width"
             || opt_key == "perimeter_loop"
             || opt_key == "perimeter_loop_seam"
+            || opt_key == "perimeter_reuse_identical_layers"
             || opt_key == "perimeter_reverse"
             || opt_key == "perimeter_round_corners"
             || opt_key == "thin_perimeters"
@@ -1488,6 +1529,10 @@ bool PrintObject::invalidate_state_by_config_options(
 bool PrintObject::invalidate_step(PrintObjectStep step)
 {
 	bool invalidated = Inherited::invalidate_step(step);
+
+    // The seam placement data is calculated from the perimeters.
+    if (step == posSlice || step == posPerimeters || step == posCalculateOverhangingPerimeters || step == posSimplifyPath)
+        m_seam_data.reset();
     
     // propagate to dependent steps
     if (step == posPerimeters) {
@@ -1505,10 +1550,12 @@ bool PrintObject::invalidate_step(PrintObjectStep step)
                                                posSimplifyPath });
         invalidated |= m_print->invalidate_steps({ psSkirtBrim });
         m_slicing_params->valid = false;
+        m_brim_footprint = {};
     } else if (step == posSupportMaterial) {
         invalidated |= m_print->invalidate_steps({ psSkirtBrim,  });
         invalidated |= this->invalidate_steps({ posEstimateCurledExtrusions });
         m_slicing_params->valid = false;
+        m_brim_footprint = {};
     }
 
     // invalidate alerts step always, since it depends on everything (except supports, but with supports enabled it is skipped anyway.)
@@ -1528,6 +1575,8 @@ bool PrintObject::invalidate_all_steps()
     bool result = Inherited::invalidate_all_steps() | m_print->invalidate_all_steps();
 	// Then reset some of the depending values.
 	m_slicing_params->valid = false;
+    m_brim_footprint = {};
+    m_seam_data.reset();
 	return result;
 }
 
@@ -5,8 +5,13 @@
 #include "QuadricEdgeCollapse.hpp"
 #include <tuple>
 #include <optional>
+#include <numeric>
+#include <unordered_map>
+#include <mutex>
 #include "MutablePriorityQueue.hpp"
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/task_arena.h>
 
 using namespace Slic3r;
 
@@ -137,7 +142,14 @@ namespace QuadricEdgeCollapse {
     void change_neighbors(EdgeInfos &e_infos, VertexInfos &v_infos, uint32_t ti0, uint32_t ti1,
                           uint32_t vi0, uint32_t vi1, uint32_t vi_top0,
                           const Triangle &t1, CopyEdgeInfos& infos, EdgeInfos &e_infos1);
-    void compact(const VertexInfos &v_infos, const TriangleInfos &t_infos, const EdgeInfos &e_infos, indexed_triangle_set &its);
+    // vertex_map, when given, is filled with the new index of each vertex, or -1 for removed vertices
+    void compact(const VertexInfos &v_infos, const TriangleInfos &t_infos, const EdgeInfos &e_infos, indexed_triangle_set &its,
+                 std::vector<uint32_t> *vertex_map = nullptr);
+    // Reduce the mesh, edges touching a locked vertex are never collapsed.
+    // Returns the error of the last collapsed edge.
+    float reduce(indexed_triangle_set &its, uint32_t triangle_count, float maximal_error,
+                 const std::vector<bool> *locked, std::vector<uint32_t> *vertex_map,
+                 ThrowOnCancel &throw_on_cancel, StatusFn &status_fn);
 
 #ifdef EXPENSIVE_DEBUG_CHECKS
     void store_surround(const char *obj_filename, size_t triangle_index, int depth, const indexed_triangle_set &its,
@@ -157,6 +169,10 @@ namespace QuadricEdgeCollapse {
     const int status_set_offsets = 10;
     const int status_calc_errors = 30;
     const int status_create_refs = 10;
+    // minimal count of triangles in one partition of its_quadric_edge_collapse_parallel
+    const size_t min_partition_triangle_count = 100000;
+    // part of the status of its_quadric_edge_collapse_parallel given to the partitions, in percents
+    const int status_partitions_size = 80;
     } // namespace QuadricEdgeCollapse
 
 using namespace QuadricEdgeCollapse;
@@ -175,6 +191,18 @@ void Slic3r::its_quadric_edge_collapse(
     if (throw_on_cancel == nullptr) throw_on_cancel = []() {};
     if (status_fn == nullptr) status_fn = [](int) {};
 
+    float last_collapsed_error = reduce(its, triangle_count, maximal_error, nullptr, nullptr, throw_on_cancel, status_fn);
+    if (max_error != nullptr) *max_error = last_collapsed_error;
+}
+
+float QuadricEdgeCollapse::reduce(indexed_triangle_set    &its,
+                                  uint32_t                 triangle_count,
+                                  float                    maximal_error,
+                                  const std::vector<bool> *locked,
+                                  std::vector<uint32_t>   *vertex_map,
+                                  ThrowOnCancel           &throw_on_cancel,
+                                  StatusFn                &status_fn)
+{
     StatusFn init_status_fn = [&](int percent) {
         float n_percent = percent * status_init_size / 100.f;
         status_fn(static_cast<int>(std::round(n_percent)));
@@ -244,6 +272,8 @@ void Slic3r::its_quadric_edge_collapse(
         VertexInfo &v_info0 = v_infos[vi0];
         VertexInfo &v_info1 = v_infos[vi1];
         assert(!v_info0.is_deleted() && !v_info1.is_deleted());
+        // locked edge is handled the same way as an edge with only one triangle
+        bool is_locked = locked != nullptr && ((*locked)[vi0] || (*locked)[vi1]);
         
         // new vertex position
         SymMat q(v_info0.q);
@@ -251,7 +281,8 @@ void Slic3r::its_quadric_edge_collapse(
         Vec3f new_vertex0 = calculate_vertex(vi0, vi1, q, its.vertices);
         // set of triangle indices that change quadric
         uint32_t ti1 = -1; // triangle 1 index
-        auto ti1_opt = (v_info0.count < v_info1.count)?
+        auto ti1_opt = is_locked ? std::optional<uint32_t>{} :
+            (v_info0.count < v_info1.count)?
             find_triangle_index1(vi1, v_info0, ti0, e_infos, its.indices) :
             find_triangle_index1(vi0, v_info1, ti0, e_infos, its.indices) ;
         if (ti1_opt.has_value()) { 
@@ -346,7 +377,192 @@ void Slic3r::its_quadric_edge_collapse(
     }
 
     // compact triangle
-    compact(v_infos, t_infos, e_infos, its);
+    compact(v_infos, t_infos, e_infos, its, vertex_map);
+    return last_collapsed_error;
+}
+
+void Slic3r::its_quadric_edge_collapse_parallel(
+    indexed_triangle_set &    its,
+    uint32_t                  triangle_count,
+    float *                   max_error,
+    std::function<void(void)> throw_on_cancel,
+    std::function<void(int)>  status_fn,
+    size_t                    partition_count)
+{
+    // check input
+    if (triangle_count >= its.indices.size()) return;
+    float maximal_error = (max_error == nullptr)? std::numeric_limits<float>::max() : *max_error;
+    if (maximal_error <= 0.f) return;
+    if (throw_on_cancel == nullptr) throw_on_cancel = []() {};
+    if (status_fn == nullptr) status_fn = [](int) {};
+
+    if (partition_count == 0)
+        partition_count = std::min(size_t(tbb::this_task_arena::max_concurrency()),
+                                   its.indices.size() / min_partition_triangle_count);
+    partition_count = std::min(partition_count, its.indices.size());
+    if (partition_count < 2) {
+        its_quadric_edge_collapse(its, triangle_count, max_error, throw_on_cancel, status_fn);
+        return;
+    }
+
+    // Split triangles into slabs of the same triangle count by their centers
+    // along the longest axis of the bounding box.
+    Vec3f bb_min = its.vertices.front(), bb_max = bb_min;
+    for (const stl_vertex &v : its.vertices) {
+        bb_min = bb_min.cwiseMin(v);
+        bb_max = bb_max.cwiseMax(v);
+    }
+    Vec3f::Index axis;
+    (bb_max - bb_min).maxCoeff(&axis);
+
+    std::vector<float> centers(its.indices.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size()),
+    [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+            const Triangle &t = its.indices[i];
+            centers[i] = its.vertices[t[0]][axis] + its.vertices[t[1]][axis] + its.vertices[t[2]][axis];
+        }
+    }); // END parallel for
+    std::vector<uint32_t> order(its.indices.size());
+    std::iota(order.begin(), order.end(), 0);
+    tbb::parallel_sort(order.begin(), order.end(),
+        [&centers](uint32_t ti1, uint32_t ti2) { return centers[ti1] < centers[ti2]; });
+    centers = {};
+    throw_on_cancel();
+
+    auto partition_begin = [&its, partition_count](size_t pi) {
+        return pi * its.indices.size() / partition_count;
+    };
+
+    // owner partition of each vertex, shared_vertex for vertices on border of partitions
+    const uint32_t no_partition = std::numeric_limits<uint32_t>::max();
+    const uint32_t shared_vertex = no_partition - 1;
+    std::vector<uint32_t> vertex_partition(its.vertices.size(), no_partition);
+    for (size_t pi = 0; pi < partition_count; ++pi)
+        for (size_t i = partition_begin(pi); i < partition_begin(pi + 1); ++i)
+            for (size_t j = 0; j < 3; ++j) {
+                uint32_t &vp = vertex_partition[its.indices[order[i]][j]];
+                if (vp == no_partition)
+                    vp = uint32_t(pi);
+                else if (vp != pi)
+                    vp = shared_vertex;
+            }
+    throw_on_cancel();
+
+    // Simplify partitions concurrently, vertices on borders are locked.
+    struct Partition {
+        indexed_triangle_set its;
+        // global index of each vertex of its, -1 for vertices not on border
+        std::vector<uint32_t> border_vertices;
+        float last_collapsed_error = 0.f;
+    };
+    std::vector<Partition> partitions(partition_count);
+    // local index of vertices owned by one partition
+    std::vector<uint32_t> local_index(its.vertices.size(), no_partition);
+
+    std::mutex status_mutex;
+    size_t finished_partitions = 0;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, partition_count, 1),
+    [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t pi = range.begin(); pi < range.end(); ++pi) {
+            Partition &partition = partitions[pi];
+            std::vector<uint32_t> global_index;
+            std::unordered_map<uint32_t, uint32_t> border_index;
+            std::vector<bool> locked;
+            auto get_local_index = [&](int32_t vi) -> int32_t {
+                bool is_border = vertex_partition[vi] == shared_vertex;
+                if (! is_border && local_index[vi] != no_partition)
+                    return local_index[vi];
+                if (is_border)
+                    if (auto it = border_index.find(vi); it != border_index.end())
+                        return it->second;
+                uint32_t li = uint32_t(global_index.size());
+                (is_border ? border_index[vi] : local_index[vi]) = li;
+                global_index.emplace_back(vi);
+                locked.push_back(is_border);
+                partition.its.vertices.emplace_back(its.vertices[vi]);
+                return li;
+            };
+
+            size_t begin = partition_begin(pi), end = partition_begin(pi + 1);
+            partition.its.indices.reserve(end - begin);
+            uint32_t border_triangle_count = 0;
+            for (size_t i = begin; i < end; ++i) {
+                const Triangle &t = its.indices[order[i]];
+                Triangle &lt = partition.its.indices.emplace_back(get_local_index(t[0]), get_local_index(t[1]), get_local_index(t[2]));
+                if (locked[lt[0]] || locked[lt[1]] || locked[lt[2]])
+                    ++border_triangle_count;
+            }
+
+            // Triangles touching the border are reduced by the final pass, they are not counted
+            // into the share of the partition. Otherwise the inside of a partition with a long border
+            // would be reduced much more than the rest of the mesh.
+            uint32_t partition_triangle_count = border_triangle_count +
+                uint32_t(uint64_t(triangle_count) * (end - begin) / its.indices.size());
+            std::vector<uint32_t> vertex_map;
+            if (partition_triangle_count < partition.its.indices.size()) {
+                StatusFn partition_status_fn = [](int) {};
+                partition.last_collapsed_error = reduce(partition.its, partition_triangle_count, maximal_error,
+                                                        &locked, &vertex_map, throw_on_cancel, partition_status_fn);
+            } else {
+                vertex_map.resize(global_index.size());
+                std::iota(vertex_map.begin(), vertex_map.end(), 0);
+            }
+
+            partition.border_vertices.assign(partition.its.vertices.size(), no_partition);
+            for (uint32_t li = 0; li < vertex_map.size(); ++li)
+                if (locked[li] && vertex_map[li] != no_partition)
+                    partition.border_vertices[vertex_map[li]] = global_index[li];
+
+            std::lock_guard<std::mutex> lk(status_mutex);
+            ++finished_partitions;
+            status_fn(int(finished_partitions * status_partitions_size / partition_count));
+        }
+    }); // END parallel for
+    throw_on_cancel();
+
+    // Merge partitions, border vertices are shared by the partitions.
+    size_t vertex_count = 0, triangle_count_merged = 0;
+    for (const Partition &partition : partitions) {
+        vertex_count += partition.its.vertices.size();
+        triangle_count_merged += partition.its.indices.size();
+    }
+    float last_collapsed_error = 0.f;
+    std::vector<uint32_t> &merged_index = local_index;
+    std::fill(merged_index.begin(), merged_index.end(), no_partition);
+    its.vertices.clear();
+    its.vertices.reserve(vertex_count);
+    its.indices.clear();
+    its.indices.reserve(triangle_count_merged);
+    for (Partition &partition : partitions) {
+        std::vector<int32_t> vertex_map(partition.its.vertices.size());
+        for (size_t li = 0; li < partition.its.vertices.size(); ++li) {
+            uint32_t vi = partition.border_vertices[li];
+            if (vi != no_partition && merged_index[vi] != no_partition) {
+                vertex_map[li] = merged_index[vi];
+                continue;
+            }
+            vertex_map[li] = int32_t(its.vertices.size());
+            if (vi != no_partition)
+                merged_index[vi] = vertex_map[li];
+            its.vertices.emplace_back(partition.its.vertices[li]);
+        }
+        for (const Triangle &t : partition.its.indices)
+            its.indices.emplace_back(vertex_map[t[0]], vertex_map[t[1]], vertex_map[t[2]]);
+        last_collapsed_error = std::max(last_collapsed_error, partition.last_collapsed_error);
+        partition = {};
+    }
+
+    // Final pass simplifies borders of partitions.
+    if (triangle_count < its.indices.size()) {
+        auto final_status_fn = [&status_fn](int percent) {
+            status_fn(status_partitions_size + percent * (100 - status_partitions_size) / 100);
+        };
+        float final_error = maximal_error;
+        its_quadric_edge_collapse(its, triangle_count, &final_error, throw_on_cancel, final_status_fn);
+        last_collapsed_error = std::max(last_collapsed_error, final_error);
+    }
+    status_fn(100);
     if (max_error != nullptr) *max_error = last_collapsed_error;
 }
 
@@ -840,12 +1056,16 @@ void QuadricEdgeCollapse::change_neighbors(EdgeInfos &     e_infos,
 void QuadricEdgeCollapse::compact(const VertexInfos &   v_infos,
                                   const TriangleInfos & t_infos,
                                   const EdgeInfos &     e_infos,
-                                  indexed_triangle_set &its)
+                                  indexed_triangle_set &its,
+                                  std::vector<uint32_t> *vertex_map)
 {
+    if (vertex_map != nullptr)
+        vertex_map->assign(v_infos.size(), std::numeric_limits<uint32_t>::max());
     uint32_t vi_new = 0;
     for (uint32_t vi = 0; vi < v_infos.size(); ++vi) {
         const VertexInfo &v_info = v_infos[vi];
         if (v_info.is_deleted()) continue; // deleted
+        if (vertex_map != nullptr) (*vertex_map)[vi] = vi_new;
         uint32_t e_info_end = v_info.start + v_info.count;
         for (uint32_t ei = v_info.start; ei < e_info_end; ++ei) { 
             const EdgeInfo &e_info = e_infos[ei];
@@ -34,6 +34,32 @@ void its_quadric_edge_collapse(
     std::function<void(void)> throw_on_cancel = nullptr,
     std::function<void(int)>  statusfn        = nullptr);
 
+/// <summary>
+/// Simplify mesh by Quadric metric, in parallel for big meshes.
+/// Mesh is split spatially into partitions which are simplified concurrently
+/// with vertices on the partition borders locked. The borders are simplified
+/// by a final pass over the merged mesh.
+/// </summary>
+/// <param name="its">IN/OUT triangle mesh to be simplified.</param>
+/// <param name="triangle_count">Wanted triangle count.</param>
+/// <param name="max_error">Maximal Quadric for reduce.
+/// When nullptr then max float is used
+/// Output: Biggest of the last used ErrorValues to collapse edge</param>
+/// <param name="throw_on_cancel">Could stop process of calculation.
+/// Called from worker threads.</param>
+/// <param name="statusfn">Give a feed back to user about progress. Values 1 - 100.
+/// Called from worker threads.</param>
+/// <param name="partition_count">Count of partitions.
+/// When zero, it is chosen by the mesh size and the thread count,
+/// meshes too small to split are simplified by its_quadric_edge_collapse</param>
+void its_quadric_edge_collapse_parallel(
+    indexed_triangle_set &    its,
+    uint32_t                  triangle_count  = 0,
+    float *                   max_error       = nullptr,
+    std::function<void(void)> throw_on_cancel = nullptr,
+    std::function<void(int)>  statusfn        = nullptr,
+    size_t                    partition_count = 0);
+
 } // namespace Slic3r
 #endif // slic3r_quadric_edge_collapse_hpp_
 
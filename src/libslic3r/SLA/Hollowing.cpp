@@ -108,7 +108,8 @@ InteriorPtr generate_interior(const VoxelGrid       &vgrid,
     double adaptivity = 0.;
     InteriorPtr interior = InteriorPtr{new Interior{}};
 
-    interior->mesh = grid_to_mesh(*gridptr, iso_surface, adaptivity);
+    if (hc.generate_mesh)
+        interior->mesh = grid_to_mesh(*gridptr, iso_surface, adaptivity);
     interior->gridptr = std::move(gridptr);
 
     if (ctl.stopcondition()) return {};
@@ -121,6 +122,18 @@ InteriorPtr generate_interior(const VoxelGrid       &vgrid,
     return interior;
 }
 
+std::vector<ExPolygons> slice_interior(const Interior           &interior,
+                                       const std::vector<float> &slicegrid,
+                                       std::function<void()>     throw_on_cancel)
+{
+    if (!interior.gridptr)
+        return std::vector<ExPolygons>(slicegrid.size());
+
+    const VoxelGrid &grid = *interior.gridptr;
+
+    return grid_to_slices(grid, slicegrid, interior.iso_surface, 1. / get_voxel_scale(grid), throw_on_cancel);
+}
+
 indexed_triangle_set DrainHole::to_mesh() const
 {
     auto r = double(radius);
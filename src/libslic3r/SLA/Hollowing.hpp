@@ -23,6 +23,8 @@ struct HollowingConfig
     double quality          = 0.5;
     double closing_distance = 0.5;
     bool enabled = true;
+    // Without the interior mesh, the interior can only be sliced from its grid, see slice_interior().
+    bool generate_mesh = true;
 };
 
 enum HollowingFlags { hfRemoveInsideTriangles = 0x1 };
@@ -83,6 +85,12 @@ constexpr float HoleStickOutLength = 1.f;
 
 double get_voxel_scale(double mesh_volume, const HollowingConfig &hc);
 
+// Slice the interior at the given heights directly from its grid, at the
+// resolution of the grid. The interior mesh is not needed.
+std::vector<ExPolygons> slice_interior(const Interior           &interior,
+                                       const std::vector<float> &slicegrid,
+                                       std::function<void()>     throw_on_cancel = []{});
+
 InteriorPtr generate_interior(const VoxelGrid &mesh,
                               const HollowingConfig &  = {},
                               const JobController &ctl = {});
@@ -7,37 +7,481 @@
 #define SLARASTER_CPP
 
 #include <functional>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <queue>
 
 #include <libslic3r/SLA/RasterBase.hpp>
 #include <libslic3r/SLA/AGGRaster.hpp>
 
 // minz image write:
 #include <miniz.h>
+#include <qoi/qoi.h>
 
 namespace Slic3r { namespace sla {
 
+namespace {
+
+// Length of the run of the value starting at begin.
+size_t run_length(const uint8_t *begin, const uint8_t *end, uint8_t value)
+{
+    const uint8_t *p = begin;
+    const uint64_t pattern = 0x0101010101010101ull * value;
+    for (uint64_t word; end - p >= 8; p += 8) {
+        std::memcpy(&word, p, 8);
+        if (word != pattern)
+            break;
+    }
+    while (p != end && *p == value)
+        ++ p;
+    return size_t(p - begin);
+}
+
+// Deflate encoder producing a single dynamic Huffman block of literals and
+// matches at distance 1 only. Runs of a single value are found by a linear
+// scan, which is an order of magnitude faster than the hash chains of a
+// general deflate compressor, while the rasters of the layers consisting of
+// long runs of empty or fully exposed pixels compress about as well.
+class RunLengthDeflate {
+public:
+    // Append bytes to the compressed stream.
+    void put(const uint8_t *data, size_t len)
+    {
+        const uint8_t *end = data + len;
+        while (data != end) {
+            if (m_has_last) {
+                size_t n = run_length(data, end, m_last);
+                update_adler32(m_last, n);
+                m_run += n;
+                data += n;
+                if (data == end)
+                    break;
+            }
+            flush_run();
+            emit_literal(*data);
+            update_adler32(*data, 1);
+            m_last     = *data ++;
+            m_has_last = true;
+        }
+    }
+
+    // Compressed deflate stream without the zlib header.
+    std::vector<uint8_t> finish();
+
+    // Adler-32 checksum of the bytes put so far.
+    uint32_t adler32() const { return uint32_t((m_adler_b << 16) | m_adler_a); }
+
+private:
+    static constexpr uint16_t len_base[29]  = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    static constexpr uint8_t  len_extra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+
+    // Literal / length symbol of a match length.
+    static unsigned len_symbol(unsigned len) { return 256 + unsigned(std::upper_bound(len_base, len_base + 29, len) - len_base); }
+
+    void emit_literal(uint8_t c)
+    {
+        m_tokens.emplace_back(c);
+        ++ m_freq[c];
+    }
+
+    // Update the Adler-32 checksum by a run of n bytes of the value in constant time.
+    void update_adler32(uint8_t value, size_t n)
+    {
+        static constexpr uint64_t base = 65521;
+        // Sum of 1, 2, ..., n modulo base.
+        const uint64_t sum = n % 2 == 0 ? (n / 2 % base) * ((n + 1) % base) % base : (n % base) * ((n + 1) / 2 % base) % base;
+        m_adler_b = (m_adler_b + (n % base) * m_adler_a + sum * value) % base;
+        m_adler_a = (m_adler_a + (n % base) * value) % base;
+    }
+
+    // Emit the pending run of the last byte as matches at distance 1.
+    void flush_run()
+    {
+        size_t n = m_run;
+        m_run = 0;
+        while (n >= 3) {
+            size_t len = std::min<size_t>(n, 258);
+            // Don't leave a remainder too short for a match.
+            if (n - len > 0 && n - len < 3)
+                len = n - 3;
+            m_tokens.emplace_back(uint16_t(256 + len - 3));
+            ++ m_freq[len_symbol(unsigned(len))];
+            n -= len;
+        }
+        while (n -- > 0)
+            emit_literal(m_last);
+    }
+
+    // Literals below 256, 256 + length - 3 for a match.
+    std::vector<uint16_t>     m_tokens;
+    std::array<uint32_t, 286> m_freq {};
+    size_t                    m_run      { 0 };
+    uint8_t                   m_last     { 0 };
+    bool                      m_has_last { false };
+    uint64_t                  m_adler_a  { 1 };
+    uint64_t                  m_adler_b  { 0 };
+};
+
+class BitWriter {
+public:
+    void put(uint32_t bits, unsigned num_bits)
+    {
+        m_acc |= uint64_t(bits) << m_num_bits;
+        m_num_bits += num_bits;
+        for (; m_num_bits >= 8; m_num_bits -= 8, m_acc >>= 8)
+            m_out.emplace_back(uint8_t(m_acc));
+    }
+
+    std::vector<uint8_t> finish()
+    {
+        if (m_num_bits > 0)
+            m_out.emplace_back(uint8_t(m_acc));
+        return std::move(m_out);
+    }
+
+private:
+    std::vector<uint8_t> m_out;
+    uint64_t             m_acc      { 0 };
+    unsigned             m_num_bits { 0 };
+};
+
+// Code lengths of a Huffman code of the frequencies limited to max_len bits.
+// The code is complete if at least two symbols are used.
+std::vector<uint8_t> huffman_code_lengths(const uint32_t *freq, size_t num_symbols, unsigned max_len)
+{
+    std::vector<uint8_t> lengths(num_symbols, 0);
+    std::vector<size_t>  used;
+    for (size_t i = 0; i < num_symbols; ++ i)
+        if (freq[i] > 0)
+            used.emplace_back(i);
+    if (used.size() < 2) {
+        if (! used.empty())
+            lengths[used.front()] = 1;
+        return lengths;
+    }
+
+    // Leaves of the tree are the first used.size() nodes.
+    struct Node { uint64_t weight; int left; int right; };
+    std::vector<Node> nodes;
+    using QueueItem = std::pair<uint64_t, int>;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+    for (size_t symbol : used) {
+        queue.push({ freq[symbol], int(nodes.size()) });
+        nodes.push_back({ freq[symbol], -1, -1 });
+    }
+    while (queue.size() > 1) {
+        QueueItem a = queue.top(); queue.pop();
+        QueueItem b = queue.top(); queue.pop();
+        queue.push({ a.first + b.first, int(nodes.size()) });
+        nodes.push_back({ a.first + b.first, a.second, b.second });
+    }
+    std::vector<unsigned> depth(nodes.size(), 0);
+    for (int i = int(nodes.size()) - 1; i >= 0; -- i)
+        if (nodes[i].left >= 0)
+            depth[nodes[i].left] = depth[nodes[i].right] = depth[i] + 1;
+
+    // Limit the code lengths the same way as miniz does: clamp and rebalance the number of codes per length.
+    std::vector<unsigned> num_codes(*std::max_element(depth.begin(), depth.begin() + used.size()) + max_len + 1, 0);
+    for (size_t i = 0; i < used.size(); ++ i)
+        ++ num_codes[std::min(depth[i], max_len)];
+    uint64_t total = 0;
+    for (unsigned len = max_len; len > 0; -- len)
+        total += uint64_t(num_codes[len]) << (max_len - len);
+    for (; total != (uint64_t(1) << max_len); -- total) {
+        -- num_codes[max_len];
+        for (unsigned len = max_len - 1; len > 0; -- len)
+            if (num_codes[len] > 0) {
+                -- num_codes[len];
+                num_codes[len + 1] += 2;
+                break;
+            }
+    }
+
+    // The most frequent symbols get the shortest codes.
+    std::stable_sort(used.begin(), used.end(), [freq](size_t a, size_t b) { return freq[a] > freq[b]; });
+    auto it = used.begin();
+    for (unsigned len = 1; len <= max_len; ++ len)
+        for (unsigned i = 0; i < num_codes[len]; ++ i)
+            lengths[*it ++] = uint8_t(len);
+    return lengths;
+}
+
+// Canonical Huffman codes of the code lengths, bit reversed for BitWriter.
+std::vector<uint16_t> huffman_codes(const std::vector<uint8_t> &lengths)
+{
+    unsigned num_codes[16] = {}, next_code[16] = {};
+    for (uint8_t len : lengths)
+        ++ num_codes[len];
+    num_codes[0] = 0;
+    for (unsigned len = 1, code = 0; len < 16; ++ len)
+        next_code[len] = code = (code + num_codes[len - 1]) << 1;
+    std::vector<uint16_t> codes(lengths.size(), 0);
+    for (size_t i = 0; i < lengths.size(); ++ i)
+        if (unsigned len = lengths[i]; len > 0) {
+            unsigned code = next_code[len] ++, reversed = 0;
+            for (unsigned bit = 0; bit < len; ++ bit, code >>= 1)
+                reversed = (reversed << 1) | (code & 1);
+            codes[i] = uint16_t(reversed);
+        }
+    return codes;
+}
+
+std::vector<uint8_t> RunLengthDeflate::finish()
+{
+    flush_run();
+    // End of block.
+    m_freq[256] = 1;
+
+    std::vector<uint8_t> lit_lengths = huffman_code_lengths(m_freq.data(), m_freq.size(), 15);
+    size_t num_lit = m_freq.size();
+    while (num_lit > 257 && lit_lengths[num_lit - 1] == 0)
+        -- num_lit;
+    // A single distance code of distance 1.
+    static constexpr size_t num_dist = 1;
+
+    // Code lengths of both codes, run-length encoded by the symbols 16 (repeat previous), 17 and 18 (repeat zero).
+    std::vector<uint8_t> lengths(lit_lengths.begin(), lit_lengths.begin() + num_lit);
+    lengths.emplace_back(1);
+    std::vector<std::pair<uint8_t, uint8_t>> cl_symbols; // symbol, value of the extra bits
+    std::array<uint32_t, 19>                 cl_freq {};
+    for (size_t i = 0; i < lengths.size();) {
+        const uint8_t len = lengths[i];
+        size_t        run = std::min(run_length(lengths.data() + i, lengths.data() + lengths.size(), len), lengths.size() - i);
+        i += run;
+        if (len == 0) {
+            for (; run >= 11; run -= std::min<size_t>(run, 138))
+                cl_symbols.push_back({ 18, uint8_t(std::min<size_t>(run, 138) - 11) });
+            if (run >= 3) {
+                cl_symbols.push_back({ 17, uint8_t(run - 3) });
+                run = 0;
+            }
+        } else {
+            cl_symbols.push_back({ len, 0 });
+            for (-- run; run >= 3; run -= std::min<size_t>(run, 6))
+                cl_symbols.push_back({ 16, uint8_t(std::min<size_t>(run, 6) - 3) });
+        }
+        for (; run > 0; -- run)
+            cl_symbols.push_back({ len, 0 });
+    }
+    for (const auto &symbol : cl_symbols)
+        ++ cl_freq[symbol.first];
+    // Inflate rejects an incomplete code length code, which a single symbol would produce.
+    if (std::count_if(cl_freq.begin(), cl_freq.end(), [](uint32_t f) { return f > 0; }) < 2)
+        ++ cl_freq[cl_freq[0] > 0 ? 1 : 0];
+    std::vector<uint8_t> cl_lengths = huffman_code_lengths(cl_freq.data(), cl_freq.size(), 7);
+    static constexpr uint8_t cl_order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+    size_t num_cl = 19;
+    while (num_cl > 4 && cl_lengths[cl_order[num_cl - 1]] == 0)
+        -- num_cl;
+
+    const std::vector<uint16_t> lit_codes = huffman_codes(lit_lengths);
+    const std::vector<uint16_t> cl_codes  = huffman_codes(cl_lengths);
+    BitWriter out;
+    // Final block, dynamic Huffman codes.
+    out.put(1, 1);
+    out.put(2, 2);
+    out.put(unsigned(num_lit - 257), 5);
+    out.put(unsigned(num_dist - 1), 5);
+    out.put(unsigned(num_cl - 4), 4);
+    for (size_t i = 0; i < num_cl; ++ i)
+        out.put(cl_lengths[cl_order[i]], 3);
+    static constexpr uint8_t cl_extra[3] = { 2, 3, 7 };
+    for (const auto &[symbol, extra] : cl_symbols) {
+        out.put(cl_codes[symbol], cl_lengths[symbol]);
+        if (symbol >= 16)
+            out.put(extra, cl_extra[symbol - 16]);
+    }
+    for (uint16_t token : m_tokens)
+        if (token < 256)
+            out.put(lit_codes[token], lit_lengths[token]);
+        else {
+            const unsigned len    = token - 256 + 3;
+            const unsigned symbol = len_symbol(len);
+            out.put(lit_codes[symbol], lit_lengths[symbol]);
+            out.put(len - len_base[symbol - 257], len_extra[symbol - 257]);
+            // Distance 1 is the single bit distance code 0.
+            out.put(0, 1);
+        }
+    out.put(lit_codes[256], lit_lengths[256]);
+    return out.finish();
+}
+
+void append_be32(std::vector<uint8_t> &out, uint32_t value)
+{
+    for (int shift = 24; shift >= 0; shift -= 8)
+        out.emplace_back(uint8_t(value >> shift));
+}
+
+void append_png_chunk(std::vector<uint8_t> &png, const char *type, const uint8_t *data, size_t len)
+{
+    append_be32(png, uint32_t(len));
+    const size_t start = png.size();
+    png.insert(png.end(), type, type + 4);
+    png.insert(png.end(), data, data + len);
+    append_be32(png, uint32_t(mz_crc32(MZ_CRC32_INIT, png.data() + start, len + 4)));
+}
+
+// zlib stream of the rows of the image prefixed with the filter type None.
+// Other PNG filters turn the long runs of a single value into shorter runs of
+// differences and compress the rasters of the layers worse.
+std::vector<uint8_t> png_image_data(const uint8_t *data, size_t w, size_t h, size_t num_components, int level)
+{
+    const size_t  stride = w * num_components;
+    const uint8_t filter = 0;
+    std::vector<uint8_t> out;
+
+    if (level == 1) {
+        RunLengthDeflate deflate;
+        for (size_t y = 0; y < h; ++ y) {
+            deflate.put(&filter, 1);
+            deflate.put(data + y * stride, stride);
+        }
+        // zlib header: deflate with 32K window, fastest compression.
+        out = { 0x78, 0x01 };
+        std::vector<uint8_t> compressed = deflate.finish();
+        out.insert(out.end(), compressed.begin(), compressed.end());
+        append_be32(out, deflate.adler32());
+        return out;
+    }
+
+    auto *comp = static_cast<tdefl_compressor*>(MZ_MALLOC(sizeof(tdefl_compressor)));
+    if (comp == nullptr)
+        return out;
+    tdefl_init(comp, [](const void *buf, int len, void *user) -> mz_bool {
+            auto *out = static_cast<std::vector<uint8_t>*>(user);
+            out->insert(out->end(), static_cast<const uint8_t*>(buf), static_cast<const uint8_t*>(buf) + len);
+            return MZ_TRUE;
+        }, &out, tdefl_create_comp_flags_from_zip_params(std::clamp(level, 0, 9), MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY));
+    bool ok = true;
+    for (size_t y = 0; y < h && ok; ++ y)
+        ok = tdefl_compress_buffer(comp, &filter, 1, TDEFL_NO_FLUSH) == TDEFL_STATUS_OKAY &&
+             tdefl_compress_buffer(comp, data + y * stride, stride, TDEFL_NO_FLUSH) == TDEFL_STATUS_OKAY;
+    ok = ok && tdefl_compress_buffer(comp, nullptr, 0, TDEFL_FINISH) == TDEFL_STATUS_DONE;
+    MZ_FREE(comp);
+    if (! ok)
+        out.clear();
+    return out;
+}
+
+} // namespace
+
 EncodedRaster PNGRasterEncoder::operator()(const void *ptr, size_t w, size_t h,
                                            size_t      num_components)
 {
-    std::vector<uint8_t> buf;
-    size_t s = 0;
-    
-    void *rawdata = tdefl_write_image_to_png_file_in_memory(
-        ptr, int(w), int(h), int(num_components), &s);
-    
-    // On error, data() will return an empty vector. No other info can be
-    // retrieved from miniz anyway...
-    if (rawdata == nullptr) return EncodedRaster({}, "png");
-    
-    auto pptr = static_cast<std::uint8_t*>(rawdata);
-    
-    buf.reserve(s);
-    std::copy(pptr, pptr + s, std::back_inserter(buf));
-    
-    MZ_FREE(rawdata);
+    // Color types of grayscale, grayscale with alpha, RGB and RGBA.
+    static constexpr uint8_t color_types[5] = { 0, 0, 4, 2, 6 };
+    if (w == 0 || h == 0 || num_components < 1 || num_components > 4)
+        return EncodedRaster({}, "png");
+
+    std::vector<uint8_t> idat = png_image_data(static_cast<const uint8_t*>(ptr), w, h, num_components, compression_level);
+    // On error, data() will return an empty vector.
+    if (idat.empty())
+        return EncodedRaster({}, "png");
+
+    std::vector<uint8_t> ihdr;
+    append_be32(ihdr, uint32_t(w));
+    append_be32(ihdr, uint32_t(h));
+    // 8 bits per component, deflate compression, adaptive filtering, no interlacing.
+    ihdr.insert(ihdr.end(), { 8, color_types[num_components], 0, 0, 0 });
+
+    static constexpr uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    std::vector<uint8_t> buf(signature, signature + 8);
+    buf.reserve(idat.size() + 8 + 3 * 12 + ihdr.size());
+    append_png_chunk(buf, "IHDR", ihdr.data(), ihdr.size());
+    append_png_chunk(buf, "IDAT", idat.data(), idat.size());
+    append_png_chunk(buf, "IEND", nullptr, 0);
+
     return EncodedRaster(std::move(buf), "png");
 }
 
+EncodedRaster QOIRasterEncoder::operator()(const void *ptr, size_t w, size_t h,
+                                           size_t      num_components)
+{
+    if (num_components == 3 || num_components == 4) {
+        qoi_desc desc { unsigned(w), unsigned(h), (unsigned char)num_components, QOI_LINEAR };
+        int   size = 0;
+        void *data = qoi_encode(ptr, &desc, &size);
+        if (data == nullptr)
+            return EncodedRaster({}, "qoi");
+        std::vector<uint8_t> buf(static_cast<uint8_t*>(data), static_cast<uint8_t*>(data) + size);
+        free(data);
+        return EncodedRaster(std::move(buf), "qoi");
+    }
+    if (num_components != 1 || w == 0 || h == 0)
+        return EncodedRaster({}, "qoi");
+
+    // Encoding the grayscale pixels directly as opaque RGB avoids expanding the whole raster.
+    // The operations follow the reference encoder of qoi.h.
+    static constexpr uint8_t op_index = 0x00, op_diff = 0x40, op_luma = 0x80, op_run = 0xc0, op_rgb = 0xfe;
+    std::vector<uint8_t> buf;
+    buf.insert(buf.end(), { 'q', 'o', 'i', 'f' });
+    append_be32(buf, uint32_t(w));
+    append_be32(buf, uint32_t(h));
+    buf.insert(buf.end(), { 3, QOI_LINEAR });
+
+    // Index of the seen pixels, addressed by the QOI hash of the opaque gray pixel.
+    // Initially all the pixels of the index are transparent black, thus different from any opaque pixel.
+    std::array<int, 64> index;
+    index.fill(-1);
+    const auto *pixels = static_cast<const uint8_t*>(ptr);
+    const auto *end    = pixels + w * h;
+    uint8_t     prev   = 0;
+    for (const uint8_t *px = pixels; px != end;) {
+        if (*px == prev) {
+            for (size_t run = run_length(px, end, prev); run > 0; run -= std::min<size_t>(run, 62)) {
+                buf.emplace_back(uint8_t(op_run | (std::min<size_t>(run, 62) - 1)));
+                px += std::min<size_t>(run, 62);
+            }
+            continue;
+        }
+        const uint8_t value = *px ++;
+        const int     hash  = (value * 3 + value * 5 + value * 7 + 255 * 11) % 64;
+        if (index[hash] == value)
+            buf.emplace_back(uint8_t(op_index | hash));
+        else {
+            index[hash] = value;
+            const int d = int(int8_t(uint8_t(value - prev)));
+            if (d >= -2 && d <= 1)
+                buf.emplace_back(uint8_t(op_diff | ((d + 2) << 4) | ((d + 2) << 2) | (d + 2)));
+            else if (d >= -32 && d <= 31)
+                buf.insert(buf.end(), { uint8_t(op_luma | (d + 32)), 0x88 });
+            else
+                buf.insert(buf.end(), { op_rgb, value, value, value });
+        }
+        prev = value;
+    }
+    buf.insert(buf.end(), { 0, 0, 0, 0, 0, 0, 0, 1 });
+
+    return EncodedRaster(std::move(buf), "qoi");
+}
+
+EncodedRaster RLERasterEncoder::operator()(const void *ptr, size_t w, size_t h,
+                                           size_t      num_components)
+{
+    if (num_components != 1)
+        return EncodedRaster({}, "rle");
+
+    std::vector<uint8_t> buf;
+    for (uint32_t value : { uint32_t(w), uint32_t(h) })
+        for (int shift = 0; shift < 32; shift += 8)
+            buf.emplace_back(uint8_t(value >> shift));
+
+    const auto *pixels = static_cast<const uint8_t*>(ptr);
+    const auto *end    = pixels + w * h;
+    for (const uint8_t *px = pixels; px != end;) {
+        const size_t run = run_length(px, end, *px);
+        buf.emplace_back(*px);
+        size_t len = run;
+        for (; len >= 0x80; len >>= 7)
+            buf.emplace_back(uint8_t(len | 0x80));
+        buf.emplace_back(uint8_t(len));
+        px += run;
+    }
+
+    return EncodedRaster(std::move(buf), "rle");
+}
+
 std::ostream &operator<<(std::ostream &stream, const EncodedRaster &bytes)
 {
     stream.write(reinterpret_cast<const char *>(bytes.data()),
@@ -102,6 +102,28 @@ public:
 };
 
 struct PNGRasterEncoder {
+    static constexpr int DefaultCompressionLevel = 1;
+
+    // Compression level of the image data as in zlib: 0 stores the data,
+    // 1 uses a fast run-length deflate encoder suited for the rasters of the
+    // layers consisting of long spans of a single value, 2 to 9 use the
+    // deflate compressor of miniz which is slower but compresses noisy
+    // images better.
+    int compression_level = DefaultCompressionLevel;
+
+    EncodedRaster operator()(const void *ptr, size_t w, size_t h, size_t num_components);
+};
+
+// Quite OK Image format, grayscale rasters are stored as RGB.
+struct QOIRasterEncoder {
+    EncodedRaster operator()(const void *ptr, size_t w, size_t h, size_t num_components);
+};
+
+// Raw run-length encoding of a raster with a single component: width and
+// height as 32 bit little endian integers followed by the runs of the pixels
+// in row major order, each run stored as the pixel value followed by the
+// length of the run as unsigned LEB128.
+struct RLERasterEncoder {
     EncodedRaster operator()(const void *ptr, size_t w, size_t h, size_t num_components);
 };
 
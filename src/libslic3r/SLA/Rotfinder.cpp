@@ -9,7 +9,6 @@
 #include <libslic3r/Execution/ExecutionTBB.hpp>
 #include <libslic3r/Execution/ExecutionSeq.hpp>
 
-#include <libslic3r/Optimize/BruteforceOptimizer.hpp>
 #include <libslic3r/Optimize/NLoptOptimizer.hpp>
 
 #include "libslic3r/SLAPrint.hpp"
@@ -17,7 +16,7 @@
 
 #include <libslic3r/Geometry.hpp>
 
-#include <thread>
+#include <numeric>
 
 namespace Slic3r { namespace sla {
 
@@ -36,32 +35,6 @@ std::array<Vec3f, 3> get_triangle_vertices(const TriangleMesh &mesh,
             mesh.its.vertices[face(2)]};
 }
 
-std::array<Vec3f, 3> get_transformed_triangle(const TriangleMesh &mesh,
-                                              const Transform3f & tr,
-                                              size_t              faceidx)
-{
-    const auto &tri = get_triangle_vertices(mesh, faceidx);
-    return {tr * tri[0], tr * tri[1], tr * tri[2]};
-}
-
-template<class T> Vec<3, T> normal(const std::array<Vec<3, T>, 3> &tri)
-{
-    Vec<3, T> U = tri[1] - tri[0];
-    Vec<3, T> V = tri[2] - tri[0];
-    return U.cross(V).normalized();
-}
-
-template<class T, class AccessFn>
-T sum_score(AccessFn &&accessfn, size_t facecount, size_t Nthreads)
-{
-    T  initv         = 0.;
-    auto   mergefn   = [](T a, T b) { return a + b; };
-    size_t grainsize = facecount / Nthreads;
-    size_t from = 0, to = facecount;
-
-    return execution::reduce(ex_tbb, from, to, initv, mergefn, accessfn, grainsize);
-}
-
 // Get area and normal of a triangle
 struct Facestats {
     Vec3f  normal;
@@ -77,37 +50,89 @@ struct Facestats {
     }
 };
 
-// Try to guess the number of support points needed to support a mesh
-double get_misalginment_score(const TriangleMesh &mesh, const Transform3f &tr)
-{
-    if (mesh.its.vertices.empty()) return NaNd;
-
-    auto accessfn = [&mesh, &tr](size_t fi) {
-        Facestats fc{get_transformed_triangle(mesh, tr, fi)};
+// The facets are scored in blocks of this size. After each block, the bound
+// of the final score is checked and rotations which can't beat the best score
+// found so far are abandoned.
+constexpr size_t FACET_BLOCK_SIZE = 4096;
+
+// Normals and areas of the facets of the mesh to rotate, precomputed once for
+// all the evaluated rotations. A rotation keeps the facet areas, only the
+// normals need to be rotated. Stored as a structure of arrays for the score
+// loops to vectorize.
+struct FacetData {
+    std::vector<float>  nx, ny, nz;
+    std::vector<float>  area;
+    std::vector<float>  sqrt_area;
+    // Sum of the facet areas of each FACET_BLOCK_SIZE block.
+    std::vector<double> block_area;
+    double              total_area = 0.;
+
+    explicit FacetData(const indexed_triangle_set &its)
+    {
+        size_t facecount = its.indices.size();
+        nx.assign(facecount, 0.f);
+        ny.assign(facecount, 0.f);
+        nz.assign(facecount, 0.f);
+        area.assign(facecount, 0.f);
+        sqrt_area.assign(facecount, 0.f);
+        block_area.assign((facecount + FACET_BLOCK_SIZE - 1) / FACET_BLOCK_SIZE, 0.);
+
+        execution::for_each(ex_tbb, size_t(0), block_area.size(), [this, &its, facecount](size_t blk) {
+            size_t from = blk * FACET_BLOCK_SIZE, to = std::min(facecount, from + FACET_BLOCK_SIZE);
+            double blkarea = 0.;
+            for (size_t fi = from; fi < to; ++fi) {
+                const Vec3i32 &face = its.indices[fi];
+                Facestats fc{{its.vertices[face(0)], its.vertices[face(1)], its.vertices[face(2)]}};
+                nx[fi] = fc.normal.x();
+                ny[fi] = fc.normal.y();
+                nz[fi] = fc.normal.z();
+                area[fi] = float(fc.area);
+                sqrt_area[fi] = float(std::sqrt(fc.area));
+                blkarea += fc.area;
+            }
+            block_area[blk] = blkarea;
+        }, execution::max_concurrency(ex_tbb));
+
+        total_area = std::accumulate(block_area.begin(), block_area.end(), 0.);
+    }
 
-        float score = fc.area
-                      * (std::abs(fc.normal.dot(Vec3f::UnitX()))
-                         + std::abs(fc.normal.dot(Vec3f::UnitY()))
-                         + std::abs(fc.normal.dot(Vec3f::UnitZ())));
+    size_t size() const { return area.size(); }
+};
 
-        // We should score against the alignment with the reference planes
-        return scaled<int_fast64_t>(score);
-    };
+// Sum of the facet areas weighted by the alignment of the facet normals with
+// the reference planes. To be maximized. Returns a value below the bound as soon
+// as the score can't reach the bound.
+double get_misalginment_score(const FacetData &fd, const Matrix3f &rot, double bound)
+{
+    // |nx| + |ny| + |nz| of a unit normal is at most sqrt(3), with a margin
+    // for the rounding errors.
+    constexpr double MAX_ALIGNMENT = 1.7321;
+
+    double S = 0., remaining = MAX_ALIGNMENT * fd.total_area;
+    for (size_t blk = 0; blk < fd.block_area.size(); ++blk) {
+        size_t from = blk * FACET_BLOCK_SIZE, to = std::min(fd.size(), from + FACET_BLOCK_SIZE);
+        float  blkscore = 0.f;
+        for (size_t fi = from; fi < to; ++fi) {
+            Vec3f n = rot * Vec3f{fd.nx[fi], fd.ny[fi], fd.nz[fi]};
+            blkscore += fd.area[fi] * (std::abs(n.x()) + std::abs(n.y()) + std::abs(n.z()));
+        }
+        S += blkscore;
+        remaining -= MAX_ALIGNMENT * fd.block_area[blk];
 
-    size_t facecount = mesh.its.indices.size();
-    size_t Nthreads  = std::thread::hardware_concurrency();
-    double S = unscaled(sum_score<int_fast64_t>(accessfn, facecount, Nthreads));
+        if (S + remaining < bound)
+            return std::numeric_limits<double>::lowest();
+    }
 
-    return S / facecount;
+    return S;
 }
 
-// The score function for a particular face
-inline double get_supportedness_score(const Facestats &fc)
+// The score function for a particular face with the given cosine of the angle
+// between its normal and the DOWN vector.
+inline float get_supportedness_score(float cosphi, float sqrt_area)
 {
     // Simply get the angle (acos of dot product) between the face normal and
     // the DOWN vector.
-    float cosphi = fc.normal.dot(DOWN);
-    float phi = 1.f - std::acos(cosphi) / float(PI);
+    float phi = 1.f - std::acos(std::clamp(cosphi, -1.f, 1.f)) / float(PI);
 
     // Make the huge slopes more significant than the smaller slopes
     phi = phi * phi * phi;
@@ -115,68 +140,75 @@ inline double get_supportedness_score(const Facestats &fc)
     // Multiply with the square root of face area of the current face,
     // the area is less important as it grows.
     // This makes many smaller overhangs a bigger impact.
-    return std::sqrt(fc.area) * POINTS_PER_UNIT_AREA * phi;
+    return sqrt_area * float(POINTS_PER_UNIT_AREA) * phi;
 }
 
-// Try to guess the number of support points needed to support a mesh
-double get_supportedness_score(const TriangleMesh &mesh, const Transform3f &tr)
+// Try to guess the number of support points needed to support a mesh. To be
+// minimized. Returns a value above the bound as soon as the score can't get
+// below the bound.
+double get_supportedness_score(const FacetData &fd, const Matrix3f &rot, double bound)
 {
-    if (mesh.its.vertices.empty()) return NaNd;
-
-    auto accessfn = [&mesh, &tr](size_t fi) {
-        Facestats fc{get_transformed_triangle(mesh, tr, fi)};
-        return scaled<int_fast64_t>(get_supportedness_score(fc));
-    };
-
-    size_t facecount = mesh.its.indices.size();
-    size_t Nthreads  = std::thread::hardware_concurrency();
-    double S = unscaled(sum_score<int_fast64_t>(accessfn, facecount, Nthreads));
-
-    return S / facecount;
-}
-
-// Find transformed mesh ground level without copy and with parallel reduce.
-float find_ground_level(const TriangleMesh &mesh,
-                         const Transform3f & tr,
-                         size_t              threads)
-{
-    size_t vsize = mesh.its.vertices.size();
-
-    auto minfn = [](float a, float b) { return std::min(a, b); };
+    // Only the Z component of the rotated normal is needed.
+    const Vec3f zrow = rot.row(Z).transpose();
+
+    double S = 0.;
+    for (size_t blk = 0; blk < fd.block_area.size(); ++blk) {
+        size_t from = blk * FACET_BLOCK_SIZE, to = std::min(fd.size(), from + FACET_BLOCK_SIZE);
+        float  blkscore = 0.f;
+        for (size_t fi = from; fi < to; ++fi) {
+            float nz = zrow.x() * fd.nx[fi] + zrow.y() * fd.ny[fi] + zrow.z() * fd.nz[fi];
+            blkscore += get_supportedness_score(-nz, fd.sqrt_area[fi]);
+        }
+        S += blkscore;
 
-    auto accessfn = [&mesh, &tr] (size_t vi) {
-        return (tr * mesh.its.vertices[vi]).z();
-    };
+        // The scores of the facets are not negative.
+        if (S > bound)
+            return std::numeric_limits<double>::max();
+    }
 
-    auto zmin = std::numeric_limits<float>::max();
-    size_t granularity = vsize / threads;
-    return execution::reduce(ex_tbb, size_t(0), vsize, zmin, minfn, accessfn, granularity);
+    return S;
 }
 
-double get_supportedness_onfloor_score(const TriangleMesh &mesh,
-                                       const Transform3f  &tr)
+// The same as get_supportedness_score(), but the facets touching the ground
+// level are rewarded instead.
+double get_supportedness_onfloor_score(const indexed_triangle_set &its,
+                                       const FacetData            &fd,
+                                       const Matrix3f             &rot,
+                                       double                      bound)
 {
-    if (mesh.its.vertices.empty()) return NaNd;
+    const Vec3f zrow = rot.row(Z).transpose();
 
-    size_t Nthreads = std::thread::hardware_concurrency();
+    std::vector<float> vz(its.vertices.size());
+    float zmin = std::numeric_limits<float>::max();
+    for (size_t vi = 0; vi < its.vertices.size(); ++vi) {
+        vz[vi] = zrow.dot(its.vertices[vi]);
+        zmin = std::min(zmin, vz[vi]);
+    }
 
-    float zmin = find_ground_level(mesh, tr, Nthreads);
     float zlvl = zmin + 0.1f; // Set up a slight tolerance from z level
 
-    auto accessfn = [&mesh, &tr, zlvl](size_t fi) {
-        std::array<Vec3f, 3> tri = get_transformed_triangle(mesh, tr, fi);
-        Facestats fc{tri};
-
-        if (tri[0].z() <= zlvl && tri[1].z() <= zlvl && tri[2].z() <= zlvl)
-            return -2 * fc.area * POINTS_PER_UNIT_AREA;
-
-        return get_supportedness_score(fc);
-    };
+    double S = 0., remaining_area = fd.total_area;
+    for (size_t blk = 0; blk < fd.block_area.size(); ++blk) {
+        size_t from = blk * FACET_BLOCK_SIZE, to = std::min(fd.size(), from + FACET_BLOCK_SIZE);
+        float  blkscore = 0.f;
+        for (size_t fi = from; fi < to; ++fi) {
+            const Vec3i32 &face = its.indices[fi];
+            if (vz[face(0)] <= zlvl && vz[face(1)] <= zlvl && vz[face(2)] <= zlvl)
+                blkscore -= 2.f * fd.area[fi] * float(POINTS_PER_UNIT_AREA);
+            else {
+                float nz = zrow.x() * fd.nx[fi] + zrow.y() * fd.ny[fi] + zrow.z() * fd.nz[fi];
+                blkscore += get_supportedness_score(-nz, fd.sqrt_area[fi]);
+            }
+        }
+        S += blkscore;
+        remaining_area -= fd.block_area[blk];
 
-    size_t facecount = mesh.its.indices.size();
-    double S = unscaled(sum_score<int_fast64_t>(accessfn, facecount, Nthreads));
+        // Any of the remaining facets may still lie on the floor.
+        if (S - 2. * POINTS_PER_UNIT_AREA * remaining_area * (1. + EPSILON) > bound)
+            return std::numeric_limits<double>::max();
+    }
 
-    return S / facecount;
+    return S;
 }
 
 using XYRotation = std::array<double, 2>;
@@ -256,32 +288,44 @@ std::vector<XYRotation> get_chull_rotations(const TriangleMesh &mesh, size_t max
     return ret;
 }
 
-// Find the best score from a set of function inputs. Evaluate for every point.
-template<size_t N, class Fn, class It, class StopCond>
-std::array<double, N> find_min_score(Fn &&fn, It from, It to, StopCond &&stopfn)
+// Rotations around the X and Y axes sampled on a gridsize x gridsize grid
+// spanning <-PI, PI> in both axes, at most max_count of them.
+std::vector<XYRotation> get_grid_rotations(size_t gridsize, size_t max_count)
 {
-    std::array<double, N> ret = {};
+    gridsize = std::max(gridsize, size_t(2));
+    double step = 2. * PI / (gridsize - 1);
 
-    double score = std::numeric_limits<double>::max();
+    auto ret = reserve_vector<XYRotation>(std::min(max_count, gridsize * gridsize));
+    for (size_t iy = 0; iy < gridsize; ++iy)
+        for (size_t ix = 0; ix < gridsize && ret.size() < max_count; ++ix)
+            ret.push_back({-PI + ix * step, -PI + iy * step});
 
-    size_t Nthreads = std::thread::hardware_concurrency();
-    size_t dist = std::distance(from, to);
-    std::vector<double> scores(dist, score);
+    return ret;
+}
 
-    execution::for_each(
-        ex_tbb, size_t(0), dist, [&stopfn, &scores, &fn, &from](size_t i) {
-            if (stopfn()) return;
+// Extent of the vertices along the Z axis after rotation. To be minimized.
+// Returns a value above the bound as soon as the extent exceeds the bound.
+double get_z_extent(const indexed_triangle_set &its, const Matrix3f &rot, double bound)
+{
+    if (its.vertices.empty())
+        return 0.;
 
-            scores[i] = fn(*(from + i));
-        },
-        dist / Nthreads);
+    const Vec3f zrow = rot.row(Z).transpose();
 
-    auto it = std::min_element(scores.begin(), scores.end());
+    float zmin = zrow.dot(its.vertices.front()), zmax = zmin;
+    for (size_t from = 0; from < its.vertices.size(); from += FACET_BLOCK_SIZE) {
+        size_t to = std::min(its.vertices.size(), from + FACET_BLOCK_SIZE);
+        for (size_t vi = from; vi < to; ++vi) {
+            float z = zrow.dot(its.vertices[vi]);
+            zmin = std::min(zmin, z);
+            zmax = std::max(zmax, z);
+        }
 
-    if (it != scores.end())
-        ret = *(from + std::distance(scores.begin(), it));
+        if (zmax - zmin > bound)
+            return std::numeric_limits<double>::max();
+    }
 
-    return ret;
+    return zmax - zmin;
 }
 
 } // namespace
@@ -317,17 +361,56 @@ struct RotfinderBoilerplate {
         , params{p}
     {}
 
-    void statusfn() {
-        int s = status * 100 / max_tries;
+    void statusfn(unsigned count = 1) {
+        status += count;
+        int s = status * 100 / std::max(max_tries, 1u);
         if (s != prev_status) {
             params.statuscb()(s);
             prev_status = s;
         }
-
-        ++status;
     }
 
     bool stopcond() { return ! params.statuscb()(-1); }
+
+    // Evaluate the score of the rotations in parallel batches and return the
+    // best one, the first one of equal scores. scorefn(rot, bound) gets the
+    // best score of the previous batches as the bound (the worst score if the
+    // early exit is disabled), and may give up a rotation early with a score
+    // not better than the bound. As the bound is constant within a batch, the
+    // result does not depend on the scheduling.
+    template<class ScoreFn, class BetterFn>
+    XYRotation find_best_rotation(const std::vector<XYRotation> &rotations,
+                                  double                         worst_score,
+                                  ScoreFn                      &&scorefn,
+                                  BetterFn                     &&better)
+    {
+        XYRotation best_rot   = {0., 0.};
+        double     best_score = worst_score;
+
+        size_t batch_size = 4 * execution::max_concurrency(ex_tbb);
+        std::vector<double> scores(batch_size);
+        for (size_t from = 0; from < rotations.size() && !stopcond(); from += batch_size) {
+            size_t to = std::min(rotations.size(), from + batch_size);
+            std::fill(scores.begin(), scores.end(), worst_score);
+
+            double bound = params.early_exit() ? best_score : worst_score;
+            execution::for_each(ex_tbb, from, to, [this, &rotations, &scores, &scorefn, from, bound](size_t i) {
+                if (stopcond()) return;
+
+                scores[i - from] = scorefn(to_transform3f(rotations[i]).linear(), bound);
+            }, 1);
+
+            for (size_t i = from; i < to; ++i)
+                if (better(scores[i - from], best_score)) {
+                    best_score = scores[i - from];
+                    best_rot   = rotations[i];
+                }
+
+            statusfn(unsigned(to - from));
+        }
+
+        return best_rot;
+    }
 };
 
 Vec2d find_best_misalignment_rotation(const ModelObject &      mo,
@@ -335,27 +418,19 @@ Vec2d find_best_misalignment_rotation(const ModelObject &      mo,
 {
     RotfinderBoilerplate<1000> bp{mo, params};
 
-    // Preparing the optimizer.
+    FacetData fd{bp.mesh.its};
+
+    // We are searching rotations around only two axes x, y, on a 2D grid
+    // which has gridsize^2 points.
     size_t gridsize = std::sqrt(bp.max_tries);
-    opt::Optimizer<opt::AlgBruteForce> solver(
-        opt::StopCriteria{}.max_iterations(bp.max_tries)
-                           .stop_condition([&bp] { return bp.stopcond(); }),
-        gridsize
-    );
-
-    // We are searching rotations around only two axes x, y. Thus the
-    // problem becomes a 2 dimensional optimization task.
-    // We can specify the bounds for a dimension in the following way:
-    auto bounds = opt::bounds({ {-PI, PI}, {-PI, PI} });
-
-    auto result = solver.to_max().optimize(
-        [&bp] (const XYRotation &rot)
-        {
-            bp.statusfn();
-            return get_misalginment_score(bp.mesh, to_transform3f(rot));
-        }, opt::initvals({0., 0.}), bounds);
-
-    return {result.optimum[0], result.optimum[1]};
+    std::vector<XYRotation> inputs = get_grid_rotations(gridsize, bp.max_tries);
+
+    XYRotation rot = bp.find_best_rotation(inputs, std::numeric_limits<double>::lowest(),
+        [&fd](const Matrix3f &rot, double bound) {
+            return get_misalginment_score(fd, rot, bound);
+        }, std::greater<double>{});
+
+    return {rot[0], rot[1]};
 }
 
 Vec2d find_least_supports_rotation(const ModelObject &      mo,
@@ -369,6 +444,8 @@ Vec2d find_least_supports_rotation(const ModelObject &      mo,
 
     pocfg.apply(mo.config.get());
 
+    FacetData fd{bp.mesh.its};
+
     XYRotation rot;
 
     // Different search methods have to be used depending on the model elevation
@@ -379,62 +456,26 @@ Vec2d find_least_supports_rotation(const ModelObject &      mo,
 
         // If the model can be placed on the bed directly, we only need to
         // check the 3D convex hull face rotations.
-
-        auto objfn = [&bp](const XYRotation &rot) {
-            bp.statusfn();
-            Transform3f tr = to_transform3f(rot);
-            return get_supportedness_onfloor_score(bp.mesh, tr);
-        };
-
-        rot = find_min_score<2>(objfn, inputs.begin(), inputs.end(), [&bp] {
-            return bp.stopcond();
-        });
+        rot = bp.find_best_rotation(inputs, std::numeric_limits<double>::max(),
+            [&bp, &fd](const Matrix3f &rot, double bound) {
+                return get_supportedness_onfloor_score(bp.mesh.its, fd, rot, bound);
+            }, std::less<double>{});
 
     } else {
-        // Preparing the optimizer.
-        size_t gridsize = std::sqrt(bp.max_tries); // 2D grid has gridsize^2 calls
-        opt::Optimizer<opt::AlgBruteForce> solver(
-            opt::StopCriteria{}.max_iterations(bp.max_tries)
-                               .stop_condition([&bp] { return bp.stopcond(); }),
-            gridsize
-        );
-
-        // We are searching rotations around only two axes x, y. Thus the
-        // problem becomes a 2 dimensional optimization task.
-        // We can specify the bounds for a dimension in the following way:
-        auto bounds = opt::bounds({ {-PI, PI}, {-PI, PI} });
-
-        auto result = solver.to_min().optimize(
-            [&bp] (const XYRotation &rot)
-            {
-                bp.statusfn();
-                return get_supportedness_score(bp.mesh, to_transform3f(rot));
-            }, opt::initvals({0., 0.}), bounds);
-
-        // Save the result
-        rot = result.optimum;
+        // We are searching rotations around only two axes x, y, on a 2D grid
+        // which has gridsize^2 points.
+        size_t gridsize = std::sqrt(bp.max_tries);
+        std::vector<XYRotation> inputs = get_grid_rotations(gridsize, bp.max_tries);
+
+        rot = bp.find_best_rotation(inputs, std::numeric_limits<double>::max(),
+            [&fd](const Matrix3f &rot, double bound) {
+                return get_supportedness_score(fd, rot, bound);
+            }, std::less<double>{});
     }
 
     return {rot[0], rot[1]};
 }
 
-inline BoundingBoxf3 bounding_box_with_tr(const indexed_triangle_set &its,
-                                          const Transform3f &tr)
-{
-    if (its.vertices.empty())
-        return {};
-
-    Vec3f bmin = tr * its.vertices.front(), bmax = tr * its.vertices.front();
-
-    for (const Vec3f &p : its.vertices) {
-        Vec3f pp = tr * p;
-        bmin = pp.cwiseMin(bmin);
-        bmax = pp.cwiseMax(bmax);
-    }
-
-    return {bmin.cast<double>(), bmax.cast<double>()};
-}
-
 Vec2d find_min_z_height_rotation(const ModelObject &mo,
                                  const RotOptimizeParams &params)
 {
@@ -466,15 +507,10 @@ Vec2d find_min_z_height_rotation(const ModelObject &mo,
     inputs.shrink_to_fit();
     bp.max_tries = inputs.size();
 
-    auto objfn = [&bp, &chull](const XYRotation &rot) {
-        bp.statusfn();
-        Transform3f tr = to_transform3f(rot);
-        return bounding_box_with_tr(chull.its, tr).size().z();
-    };
-
-    XYRotation rot = find_min_score<2>(objfn, inputs.begin(), inputs.end(), [&bp] {
-        return bp.stopcond();
-    });
+    XYRotation rot = bp.find_best_rotation(inputs, std::numeric_limits<double>::max(),
+        [&chull](const Matrix3f &rot, double bound) {
+            return get_z_extent(chull.its, rot, bound);
+        }, std::less<double>{});
 
     return {rot[0], rot[1]};
 }
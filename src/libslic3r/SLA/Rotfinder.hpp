@@ -23,12 +23,16 @@ using RotOptimizeStatusCB = std::function<bool(int)>;
 
 class RotOptimizeParams {
     float m_accuracy = 1.;
+    bool m_early_exit = true;
     const DynamicPrintConfig *m_print_config = nullptr;
     RotOptimizeStatusCB m_statuscb = [](int) { return true; };
 
 public:
 
     RotOptimizeParams &accuracy(float a) { m_accuracy = a; return *this; }
+    // Stop scoring a rotation as soon as it can't beat the best one. Does not
+    // change the result, disabling it is only useful for testing.
+    RotOptimizeParams &early_exit(bool e) { m_early_exit = e; return *this; }
     RotOptimizeParams &print_config(const DynamicPrintConfig *c)
     {
         m_print_config = c;
@@ -41,6 +45,7 @@ public:
     }
 
     float accuracy() const { return m_accuracy; }
+    bool early_exit() const { return m_early_exit; }
     const DynamicPrintConfig * print_config() const { return m_print_config; }
     const RotOptimizeStatusCB &statuscb() const { return m_statuscb; }
 };
@@ -83,36 +83,72 @@ void SupportPointGenerator::execute(const std::vector<ExPolygons> &slices,
                                     const std::vector<float> &     heights)
 {
     process(slices, heights);
-    project_onto_mesh(m_output);
+    project_onto_mesh(m_output, heights);
 }
 
-void SupportPointGenerator::project_onto_mesh(std::vector<sla::SupportPoint>& points) const
+bool SupportPointGenerator::is_in_cavity(const sla::SupportPoint& point, const std::vector<float>& heights) const
+{
+    if (m_cavities.empty() || heights.empty())
+        return false;
+
+    // The points are generated at the heights of the layers.
+    const size_t layer_id = std::min(size_t(std::lower_bound(heights.begin(), heights.end(), point.pos.z() - float(EPSILON)) - heights.begin()),
+                                     heights.size() - 1);
+    const Point  pt       = scaled<coord_t>(Vec2f(point.pos.x(), point.pos.y()));
+    // The ceiling of a cavity is the first layer above the cavity, test the layer below as well.
+    for (size_t idx = layer_id == 0 ? 0 : layer_id - 1; idx <= layer_id && idx < m_cavities.size(); ++ idx)
+        if (expolygons_contain(m_cavities[idx], pt))
+            return true;
+    return false;
+}
+
+void SupportPointGenerator::project_onto_mesh(std::vector<sla::SupportPoint>& points, const std::vector<float>& heights) const
 {
     // The function  makes sure that all the points are really exactly placed on the mesh.
 
-    // Use a reasonable granularity to account for the worker thread synchronization cost.
-    static constexpr size_t gransize = 64;
+    // The points are projected in batches, the upward and the downward rays of a batch are cast on the mesh
+    // as two streams of parallel rays.
+    static constexpr size_t batch_size = 64;
 
-    execution::for_each(ex_tbb, size_t(0), points.size(), [this, &points](size_t idx)
+    execution::for_each(ex_tbb, size_t(0), (points.size() + batch_size - 1) / batch_size, [this, &points, &heights](size_t batch_idx)
     {
-        if ((idx % 16) == 0)
-            // Don't call the following function too often as it flushes CPU write caches due to synchronization primitves.
-            m_throw_on_cancel();
+        // Don't call the following function too often as it flushes CPU write caches due to synchronization primitves.
+        m_throw_on_cancel();
+
+        const size_t begin = batch_idx * batch_size;
+        const size_t end   = std::min(points.size(), begin + batch_size);
+        std::vector<Vec3d>  sources;
+        std::vector<size_t> indices;
+        sources.reserve(end - begin);
+        indices.reserve(end - begin);
+        for (size_t idx = begin; idx < end; ++ idx)
+            // The mesh has no surface to project the points of a cavity onto.
+            if (! is_in_cavity(points[idx], heights)) {
+                sources.emplace_back(points[idx].pos.cast<double>());
+                indices.emplace_back(idx);
+            }
+        if (sources.empty())
+            return;
 
-        Vec3f& p = points[idx].pos;
         // Project the point upward and downward and choose the closer intersection with the mesh.
-        AABBMesh::hit_result hit_up   = m_emesh.query_ray_hit(p.cast<double>(), Vec3d(0., 0., 1.));
-        AABBMesh::hit_result hit_down = m_emesh.query_ray_hit(p.cast<double>(), Vec3d(0., 0., -1.));
+        std::vector<AABBMesh::hit_result> hits_up   = m_emesh.query_ray_hit(sources, std::vector<Vec3d>(sources.size(), Vec3d(0., 0., 1.)));
+        std::vector<AABBMesh::hit_result> hits_down = m_emesh.query_ray_hit(sources, std::vector<Vec3d>(sources.size(), Vec3d(0., 0., -1.)));
 
-        bool up   = hit_up.is_hit();
-        bool down = hit_down.is_hit();
+        for (size_t i = 0; i < sources.size(); ++ i) {
+            AABBMesh::hit_result &hit_up   = hits_up[i];
+            AABBMesh::hit_result &hit_down = hits_down[i];
 
-        if (!up && !down)
-            return;
+            bool up   = hit_up.is_hit();
+            bool down = hit_down.is_hit();
+
+            if (!up && !down)
+                continue;
 
-        AABBMesh::hit_result& hit = (!down || (hit_up.distance() < hit_down.distance())) ? hit_up : hit_down;
-        p = p + (hit.distance() * hit.direction()).cast<float>();
-    }, gransize);
+            AABBMesh::hit_result& hit = (!down || (hit_up.distance() < hit_down.distance())) ? hit_up : hit_down;
+            Vec3f& p = points[indices[i]].pos;
+            p = p + (hit.distance() * hit.direction()).cast<float>();
+        }
+    });
 }
 
 static std::vector<SupportPointGenerator::MyLayer> make_layers(
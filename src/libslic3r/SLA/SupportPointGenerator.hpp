@@ -195,10 +195,16 @@ public:
     
     void execute(const std::vector<ExPolygons> &slices,
                  const std::vector<float> &     heights);
+
+    // Regions of a cavity missing from the mesh, one entry per slice. The points generated
+    // inside the regions of their own layer or of the layer below are not projected onto
+    // the mesh and stay at the height of their layer. Must be set before execute().
+    void set_cavities(std::vector<ExPolygons> cavities) { m_cavities = std::move(cavities); }
     
     void seed(std::mt19937::result_type s) { m_rng.seed(s); }
 private:
     std::vector<SupportPoint> m_output;
+    std::vector<ExPolygons>   m_cavities;
     
     SupportPointGenerator::Config m_config;
     
@@ -213,7 +219,9 @@ private:
 
     void add_support_points(Structure& structure, PointGrid3D &grid3d);
 
-    void project_onto_mesh(std::vector<SupportPoint>& points) const;
+    void project_onto_mesh(std::vector<SupportPoint>& points, const std::vector<float>& heights) const;
+
+    bool is_in_cavity(const SupportPoint& point, const std::vector<float>& heights) const;
 
 #ifdef SLA_SUPPORTPOINTGEN_DEBUG
     static void output_expolygons(const ExPolygons& expolys, const std::string &filename);
@@ -146,8 +146,11 @@ struct Beam_ { // Defines a set of rays displaced along a cone's surface
 
 using Beam = Beam_<>;
 
+// The rays around a beam or a pinhead are coherent, they are cast on the mesh as a single stream
+// (see AABBMesh::query_ray_hit() for a bundle of rays), thus the execution policy is not used
+// to cast the individual rays in parallel.
 template<class Ex, size_t RayCount = Beam::SAMPLES>
-Hit beam_mesh_hit(Ex policy,
+Hit beam_mesh_hit(Ex /* policy */,
                   const AABBMesh &mesh,
                   const Beam_<RayCount> &beam,
                   double sd)
@@ -163,38 +166,44 @@ Hit beam_mesh_hit(Ex policy,
 
     using Hit = AABBMesh::hit_result;
 
+    // Rays from the circle on the source sphere to the circle on the destination sphere.
+    std::vector<Vec3d> sources(RayCount);
+    std::vector<Vec3d> raydirs(RayCount);
+    for (size_t i = 0; i < RayCount; ++ i) {
+        Vec3d p_src = ring.get(i, src, r_src + sd);
+        Vec3d p_dst = ring.get(i, dst, r_dst + sd);
+        raydirs[i] = (p_dst - p_src).normalized();
+        sources[i] = p_src + r_src * raydirs[i];
+    }
+
     // Hit results
-    std::array<Hit, RayCount> hits;
-
-    execution::for_each(
-        policy, size_t(0), hits.size(),
-        [&mesh, r_src, r_dst, src, dst, &ring, dir, sd, &hits](size_t i) {
-            Hit &hit = hits[i];
-
-            // Point on the circle on the pin sphere
-            Vec3d p_src = ring.get(i, src, r_src + sd);
-            Vec3d p_dst = ring.get(i, dst, r_dst + sd);
-            Vec3d raydir = (p_dst - p_src).normalized();
-
-            auto hr = mesh.query_ray_hit(p_src + r_src * raydir, raydir);
-
-            if (hr.is_inside()) {
-                if (hr.distance() > 2 * r_src + sd)
-                    hit = Hit(0.0);
-                else {
-                    // re-cast the ray from the outside of the object
-                    auto q = p_src + (hr.distance() + EPSILON) * raydir;
-                    hit = mesh.query_ray_hit(q, raydir);
-                }
-            } else
-                hit = hr;
-        }, std::min(execution::max_concurrency(policy), RayCount));
+    std::vector<Hit> hits = mesh.query_ray_hit(sources, raydirs);
+
+    // Re-cast the rays starting inside the object from the outside of the object.
+    std::vector<size_t> recast;
+    for (size_t i = 0; i < RayCount; ++ i)
+        if (Hit &hr = hits[i]; hr.is_inside()) {
+            if (hr.distance() > 2 * r_src + sd)
+                hr = Hit(0.0);
+            else {
+                sources[recast.size()] = sources[i] - r_src * raydirs[i] + (hr.distance() + EPSILON) * raydirs[i];
+                raydirs[recast.size()] = raydirs[i];
+                recast.emplace_back(i);
+            }
+        }
+    if (! recast.empty()) {
+        sources.resize(recast.size());
+        raydirs.resize(recast.size());
+        std::vector<Hit> recast_hits = mesh.query_ray_hit(sources, raydirs);
+        for (size_t i = 0; i < recast.size(); ++ i)
+            hits[recast[i]] = recast_hits[i];
+    }
 
     return min_hit(hits.begin(), hits.end());
 }
 
 template<class Ex>
-Hit pinhead_mesh_hit(Ex              ex,
+Hit pinhead_mesh_hit(Ex              /* ex */,
                      const AABBMesh &mesh,
                      const Vec3d    &s,
                      const Vec3d    &dir,
@@ -214,9 +223,6 @@ Hit pinhead_mesh_hit(Ex              ex,
     auto &m         = mesh;
     using HitResult = AABBMesh::hit_result;
 
-       // Hit results
-    std::array<HitResult, SAMPLES> hits;
-
     struct Rings
     {
         double             rpin;
@@ -233,48 +239,57 @@ Hit pinhead_mesh_hit(Ex              ex,
     // of the pinhead robe (side) surface. The result will be the smallest
     // hit distance.
 
-    execution::for_each(
-        ex, size_t(0), hits.size(), [&m, &rings, sd, &hits](size_t i) {
-            // Point on the circle on the pin sphere
-            Vec3d ps = rings.pinring(i);
-            // This is the point on the circle on the back sphere
-            Vec3d p = rings.backring(i);
-
-            auto &hit = hits[i];
-
-               // Point ps is not on mesh but can be inside or
-               // outside as well. This would cause many problems
-               // with ray-casting. To detect the position we will
-               // use the ray-casting result (which has an is_inside
-               // predicate).
-
-            Vec3d n = (p - ps).normalized();
-            auto  q = m.query_ray_hit(ps + sd * n, n);
-
-            if (q.is_inside()) { // the hit is inside the model
-                if (q.distance() > rings.rpin) {
-                    // If we are inside the model and the hit
-                    // distance is bigger than our pin circle
-                    // diameter, it probably indicates that the
-                    // support point was already inside the
-                    // model, or there is really no space
-                    // around the point. We will assign a zero
-                    // hit distance to these cases which will
-                    // enforce the function return value to be
-                    // an invalid ray with zero hit distance.
-                    // (see min_element at the end)
-                    hit = HitResult(0.0);
-                } else {
-                    // re-cast the ray from the outside of the
-                    // object. The starting point has an offset
-                    // of 2*safety_distance because the
-                    // original ray has also had an offset
-                    auto q2 = m.query_ray_hit(ps + (q.distance() + 2 * sd) * n, n);
-                    hit     = q2;
-                }
-            } else
-                hit = q;
-        }, std::min(execution::max_concurrency(ex), SAMPLES));
+    std::vector<Vec3d> pins(SAMPLES);
+    std::vector<Vec3d> sources(SAMPLES);
+    std::vector<Vec3d> raydirs(SAMPLES);
+    for (size_t i = 0; i < SAMPLES; ++ i) {
+        // Point on the circle on the pin sphere
+        pins[i] = rings.pinring(i);
+        // This is the point on the circle on the back sphere
+        Vec3d p = rings.backring(i);
+        raydirs[i] = (p - pins[i]).normalized();
+        sources[i] = pins[i] + sd * raydirs[i];
+    }
+
+    // Point ps is not on mesh but can be inside or
+    // outside as well. This would cause many problems
+    // with ray-casting. To detect the position we will
+    // use the ray-casting result (which has an is_inside
+    // predicate).
+    std::vector<HitResult> hits = m.query_ray_hit(sources, raydirs);
+
+    std::vector<size_t> recast;
+    for (size_t i = 0; i < SAMPLES; ++ i)
+        if (HitResult &q = hits[i]; q.is_inside()) { // the hit is inside the model
+            if (q.distance() > rings.rpin) {
+                // If we are inside the model and the hit
+                // distance is bigger than our pin circle
+                // diameter, it probably indicates that the
+                // support point was already inside the
+                // model, or there is really no space
+                // around the point. We will assign a zero
+                // hit distance to these cases which will
+                // enforce the function return value to be
+                // an invalid ray with zero hit distance.
+                // (see min_element at the end)
+                q = HitResult(0.0);
+            } else {
+                // re-cast the ray from the outside of the
+                // object. The starting point has an offset
+                // of 2*safety_distance because the
+                // original ray has also had an offset
+                sources[recast.size()] = pins[i] + (q.distance() + 2 * sd) * raydirs[i];
+                raydirs[recast.size()] = raydirs[i];
+                recast.emplace_back(i);
+            }
+        }
+    if (! recast.empty()) {
+        sources.resize(recast.size());
+        raydirs.resize(recast.size());
+        std::vector<HitResult> recast_hits = m.query_ray_hit(sources, raydirs);
+        for (size_t i = 0; i < recast.size(); ++ i)
+            hits[recast[i]] = recast_hits[i];
+    }
 
     return min_hit(hits.begin(), hits.end());
 }
@@ -856,6 +856,7 @@ bool SLAPrint::invalidate_state_by_config_options(const std::vector<t_config_opt
         "display_mirror_y"sv,
         "display_orientation"sv,
         "output_format"sv,
+        "sla_output_compression"sv,
         "sla_output_precision"sv
     };
 
@@ -957,6 +958,7 @@ bool SLAPrintObject::invalidate_state_by_config_options(const std::vector<t_conf
             || opt_key == "hollowing_min_thickness"
             || opt_key == "hollowing_quality"
             || opt_key == "hollowing_closing_distance"
+            || opt_key == "hollowing_direct_slicing"
             ) {
             steps.emplace_back(slaposHollowing);
         } else if (
@@ -391,6 +391,8 @@ private:
     public:
 
         sla::InteriorPtr interior;
+        // Slices of a directly sliced interior at m_model_height_levels, subtracted from the model slices.
+        std::vector<ExPolygons> interior_slices;
     };
     
     std::unique_ptr<HollowingData> m_hollowing_data;
@@ -552,6 +554,10 @@ public:
     void export_print(const std::string    &fname,
                       const ThumbnailsList &thumbnails,
                       const std::string    &projectname = "");
+
+    // Rasterize the layers in the streaming mode even if the print is small, see SLAArchiveWriter::set_streaming().
+    // Large prints are always rasterized in the streaming mode.
+    void set_force_raster_streaming(bool force) { m_force_raster_streaming = force; }
     
 private:
     
@@ -573,6 +579,7 @@ private:
     
     // The archive object which collects the raster images after slicing
     std::unique_ptr<SLAArchiveWriter>     m_archiver;
+    bool                                  m_force_raster_streaming = false;
     
     // Estimated print time, material consumed.
     SLAPrintStatistics              m_print_statistics;
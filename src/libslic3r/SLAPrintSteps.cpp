@@ -340,7 +340,9 @@ void SLAPrint::Steps::hollow_model(SLAPrintObject &po)
     double thickness = po.m_config.hollowing_min_thickness.value;
     double quality  = po.m_config.hollowing_quality.value;
     double closing_d = po.m_config.hollowing_closing_distance.value;
+    bool   direct_slicing = po.m_config.hollowing_direct_slicing.value;
     sla::HollowingConfig hlwcfg{thickness, quality, closing_d};
+    hlwcfg.generate_mesh = ! direct_slicing;
     sla::JobController ctl;
     ctl.stopcondition = [this]() { return canceled(); };
     ctl.cancelfn = [this]() { throw_if_canceled(); };
@@ -348,9 +350,14 @@ void SLAPrint::Steps::hollow_model(SLAPrintObject &po)
     sla::InteriorPtr interior =
         generate_interior(po.mesh_to_slice(), hlwcfg, ctl);
 
-    if (!interior || sla::get_mesh(*interior).empty())
+    if (!interior || (direct_slicing ? is_grid_empty(sla::get_grid(*interior)) : sla::get_mesh(*interior).empty()))
         BOOST_LOG_TRIVIAL(warning) << "Hollowed interior is empty!";
-    else {
+    else if (direct_slicing) {
+        // The interior has no mesh, it is subtracted from the model slices in slice_model().
+        // Thus the cavity is not part of the preview.
+        po.m_hollowing_data.reset(new SLAPrintObject::HollowingData());
+        po.m_hollowing_data->interior = std::move(interior);
+    } else {
         po.m_hollowing_data.reset(new SLAPrintObject::HollowingData());
         po.m_hollowing_data->interior = std::move(interior);
 
@@ -387,8 +394,9 @@ void SLAPrint::Steps::drill_holes(SLAPrintObject &po)
 
     generate_preview(po, slaposDrillHoles);
 
-    // Release the data, won't be needed anymore, takes huge amount of ram
-    if (po.m_hollowing_data && po.m_hollowing_data->interior)
+    // Release the data, won't be needed anymore, takes huge amount of ram.
+    // A directly sliced interior is kept for slice_model().
+    if (po.m_hollowing_data && po.m_hollowing_data->interior && ! po.m_config.hollowing_direct_slicing.value)
         po.m_hollowing_data->interior.reset();
 }
 
@@ -505,6 +513,16 @@ void SLAPrint::Steps::slice_model(SLAPrintObject &po)
 
     po.m_model_slices = slice_csgmesh_ex(po.mesh_to_slice(), slice_grid, params, thr);
 
+    if (po.m_hollowing_data && po.m_hollowing_data->interior && po.m_config.hollowing_direct_slicing.value) {
+        std::vector<ExPolygons> &interior_slices = po.m_hollowing_data->interior_slices;
+        interior_slices = sla::slice_interior(*po.m_hollowing_data->interior, slice_grid, thr);
+        execution::for_each(ex_tbb, size_t(0), std::min(po.m_model_slices.size(), interior_slices.size()),
+            [&po, &interior_slices](size_t i) {
+                if (! interior_slices[i].empty())
+                    po.m_model_slices[i] = diff_ex(po.m_model_slices[i], interior_slices[i]);
+            }, execution::max_concurrency(ex_tbb));
+    }
+
     auto mit = slindex_it;
     for (size_t id = 0;
          id < po.m_model_slices.size() && mit != po.m_slice_index.end();
@@ -636,11 +654,29 @@ void SLAPrint::Steps::support_points(SLAPrintObject &po)
                 report_status(current, OBJ_STEP_LABELS(slaposSupportPoints));
         };
 
-        // Construction of this object does the calculation.
+        // A directly sliced interior has no mesh, thus the support mesh has no cavity and the points
+        // placed at the cavity ceilings would be projected onto the outer surface. These points are kept
+        // at the height of their layer instead. The interior is grown by half of the wall thickness
+        // to cover the gaps left by the printer corrections.
+        std::vector<ExPolygons> cavities;
+        if (po.m_config.hollowing_direct_slicing.value && po.m_hollowing_data && ! po.m_hollowing_data->interior_slices.empty()) {
+            const std::vector<ExPolygons> &interior_slices = po.m_hollowing_data->interior_slices;
+            const float                    delta           = float(scaled(0.5 * po.m_config.hollowing_min_thickness.value));
+            cavities.assign(interior_slices.size(), {});
+            execution::for_each(ex_tbb, size_t(0), interior_slices.size(),
+                [&cavities, &interior_slices, delta](size_t i) {
+                    if (! interior_slices[i].empty())
+                        cavities[i] = offset_ex(interior_slices[i], delta);
+                }, execution::max_concurrency(ex_tbb));
+        }
+
         throw_if_canceled();
         sla::SupportPointGenerator auto_supports(
-            po.m_supportdata->input.emesh, po.get_model_slices(),
-            heights, config, [this]() { throw_if_canceled(); }, statuscb);
+            po.m_supportdata->input.emesh, config, [this]() { throw_if_canceled(); }, statuscb);
+        std::random_device rd;
+        auto_supports.seed(rd());
+        auto_supports.set_cavities(std::move(cavities));
+        auto_supports.execute(po.get_model_slices(), heights);
 
         // Now let's extract the result.
         std::vector<sla::SupportPoint>& points = auto_supports.output();
@@ -1112,6 +1148,10 @@ void SLAPrint::Steps::merge_slices_and_eval_stats() {
     report_status(-2, "", SlicingStatus::RELOAD_SLA_PREVIEW);
 }
 
+// Number of pixels of all the layers together above which the layers are rasterized in the streaming mode.
+// That is roughly 250 layers of an 8K display.
+static constexpr double RASTER_STREAMING_MIN_PIXELS = 8e9;
+
 // Rasterizing the model objects, and their supports
 void SLAPrint::Steps::rasterize()
 {
@@ -1155,6 +1195,13 @@ void SLAPrint::Steps::rasterize()
         }
     };
 
+    // Keep the encoded layers in memory for small prints only, the layers of large prints
+    // are spooled to a temporary file as they are rasterized.
+    const SLAPrinterConfig &printer_config = m_print->m_printer_config;
+    const double raster_pixels = double(printer_config.display_pixels_x.get_int()) *
+        double(printer_config.display_pixels_y.get_int()) * double(m_print->m_printer_input.size());
+    m_print->m_archiver->set_streaming(m_print->m_force_raster_streaming || raster_pixels > RASTER_STREAMING_MIN_PIXELS);
+
     // last minute escape
     if(canceled()) return;
 
@@ -17,6 +17,9 @@
 #include <cmath>
 #include <cassert>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 namespace Slic3r {
 
 // Naive implementation of the Traveling Salesman Problem, it works by always taking the next closest neighbor.
@@ -1031,11 +1034,126 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy2(SegmentEndPointFunc
 	return chain_segments_greedy_constrained_reversals2_<PointType, SegmentEndPointFunc, false, decltype(could_reverse_func)>(end_point_func, could_reverse_func, num_segments, start_near);
 }
 
+// Collections with at least this number of segments are chained by the spatially partitioned algorithm.
+static constexpr const size_t ChainPartitionedMinSegments     = 4096;
+// Target number of segments per grid cell of the spatially partitioned algorithm.
+static constexpr const size_t ChainPartitionedSegmentsPerCell = 1024;
+
+struct ChainGridCell {
+	// Indices of the segments binned into this cell.
+	std::vector<size_t> segments;
+	// Where the chain of this cell shall start: At the side of the cell the serpentine enters the cell from.
+	Point               entry;
+};
+
+// Bin segments by their centers into a grid of cells, roughly ChainPartitionedSegmentsPerCell segments per cell.
+// Returns the non-empty cells in a serpentine (boustrophedon) order, starting at the corner closest to start_near:
+// Rows are visited one after the other, odd rows are traversed backwards, thus neighbor cells share a side.
+template<typename SegmentEndPointFunc>
+static std::vector<ChainGridCell> chain_partition_segments(SegmentEndPointFunc end_point_func, size_t num_segments, const Point *start_near)
+{
+	std::vector<Vec2d> centers;
+	centers.reserve(num_segments);
+	Vec2d bbox_min(std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+	Vec2d bbox_max = - bbox_min;
+	for (size_t i = 0; i < num_segments; ++ i) {
+		centers.emplace_back(0.5 * (end_point_func(i, true).template cast<double>() + end_point_func(i, false).template cast<double>()));
+		bbox_min = bbox_min.cwiseMin(centers.back());
+		bbox_max = bbox_max.cwiseMax(centers.back());
+	}
+
+	const Vec2d  size             = (bbox_max - bbox_min).cwiseMax(Vec2d(1., 1.));
+	const size_t num_cells_target = (num_segments + ChainPartitionedSegmentsPerCell - 1) / ChainPartitionedSegmentsPerCell;
+	const size_t cols             = std::max<size_t>(1, size_t(std::round(std::sqrt(double(num_cells_target) * size.x() / size.y()))));
+	const size_t rows             = std::max<size_t>(1, (num_cells_target + cols - 1) / cols);
+	const Vec2d  cell_size(size.x() / double(cols), size.y() / double(rows));
+	// Mirror the grid so that the serpentine starts at the corner closest to start_near.
+	const Vec2d  bbox_center      = 0.5 * (bbox_min + bbox_max);
+	const bool   flip_x           = start_near != nullptr && double(start_near->x()) > bbox_center.x();
+	const bool   flip_y           = start_near != nullptr && double(start_near->y()) > bbox_center.y();
+
+	std::vector<ChainGridCell> cells(rows * cols);
+	for (size_t i = 0; i < num_segments; ++ i) {
+		const Vec2d &c   = centers[i];
+		size_t       col = std::min(cols - 1, size_t(std::max(0., (flip_x ? bbox_max.x() - c.x() : c.x() - bbox_min.x()) / cell_size.x())));
+		size_t       row = std::min(rows - 1, size_t(std::max(0., (flip_y ? bbox_max.y() - c.y() : c.y() - bbox_min.y()) / cell_size.y())));
+		cells[row * cols + ((row & 1) ? cols - 1 - col : col)].segments.emplace_back(i);
+	}
+	for (size_t idx = 0; idx < cells.size(); ++ idx) {
+		const size_t row = idx / cols;
+		const size_t col = (row & 1) ? cols - 1 - idx % cols : idx % cols;
+		// Entry in the mirrored grid: The left side of the cell for even rows, the right side for odd rows.
+		const double u   = double((row & 1) ? col + 1 : col) * cell_size.x();
+		const double v   = (double(row) + 0.5) * cell_size.y();
+		cells[idx].entry = Point(coord_t(flip_x ? bbox_max.x() - u : bbox_min.x() + u), coord_t(flip_y ? bbox_max.y() - v : bbox_min.y() + v));
+	}
+	cells.erase(std::remove_if(cells.begin(), cells.end(), [](const ChainGridCell &cell) { return cell.segments.empty(); }), cells.end());
+	if (start_near != nullptr && ! cells.empty())
+		cells.front().entry = *start_near;
+	return cells;
+}
+
+// Chain a huge collection of segments by splitting it into grid cells, chaining the cells in parallel by chain_cell()
+// and concatenating the chains of the cells in the serpentine order of chain_partition_segments().
+// chain_cell(segments, entry) chains the segments of a single cell starting near entry, returning indices into segments.
+// Each cell is chained by the same algorithm as a small collection would be, thus the loss of quality compared to chaining
+// the whole collection at once is limited to the joins between the cells. A chain is joined from its end closer
+// to the end of the previous chain (if all its segments could be reversed), thus a join between neighbor cells
+// is bounded by the diagonal of the pair of cells, and a join over skipped empty cells is not longer
+// than the travel to the nearest end of the next chain.
+// The result is deterministic, it does not depend on the scheduling of the threads.
+template<typename SegmentEndPointFunc, typename CouldReverseFunc, typename ChainCellFunc>
+static std::vector<std::pair<size_t, bool>> chain_segments_partitioned(SegmentEndPointFunc end_point_func, CouldReverseFunc could_reverse_func, ChainCellFunc chain_cell, size_t num_segments, const Point *start_near)
+{
+	const std::vector<ChainGridCell> cells = chain_partition_segments(end_point_func, num_segments, start_near);
+	std::vector<std::vector<std::pair<size_t, bool>>> chains(cells.size());
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, cells.size(), 1), [&cells, &chains, &chain_cell](const tbb::blocked_range<size_t> &range) {
+		for (size_t idx = range.begin(); idx < range.end(); ++ idx) {
+			const std::vector<size_t> &segments = cells[idx].segments;
+			chains[idx] = chain_cell(segments, cells[idx].entry);
+			for (std::pair<size_t, bool> &segment : chains[idx])
+				segment.first = segments[segment.first];
+		}
+	});
+	std::vector<std::pair<size_t, bool>> out;
+	out.reserve(num_segments);
+	for (std::vector<std::pair<size_t, bool>> &chain : chains) {
+		if (! out.empty() && ! chain.empty()) {
+			const Point &last  = end_point_func(out.back().first, out.back().second);
+			const Point &front = end_point_func(chain.front().first, ! chain.front().second);
+			const Point &back  = end_point_func(chain.back().first, chain.back().second);
+			if ((back - last).cast<double>().squaredNorm() < (front - last).cast<double>().squaredNorm() &&
+				std::all_of(chain.begin(), chain.end(), [&could_reverse_func](const std::pair<size_t, bool> &segment) { return could_reverse_func(segment.first); })) {
+				std::reverse(chain.begin(), chain.end());
+				for (std::pair<size_t, bool> &segment : chain)
+					segment.second = ! segment.second;
+			}
+		}
+		append(out, chain);
+	}
+	assert(out.size() == num_segments);
+	return out;
+}
+
+// chain_segments_greedy_constrained_reversals(), switching to the spatially partitioned algorithm for huge collections.
+template<typename SegmentEndPointFunc, typename CouldReverseFunc>
+std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals_partitioned(SegmentEndPointFunc end_point_func, CouldReverseFunc could_reverse_func, size_t num_segments, const Point *start_near)
+{
+	if (num_segments < ChainPartitionedMinSegments)
+		return chain_segments_greedy_constrained_reversals<Point, SegmentEndPointFunc, CouldReverseFunc>(end_point_func, could_reverse_func, num_segments, start_near);
+	auto chain_cell = [&end_point_func, &could_reverse_func](const std::vector<size_t> &segments, const Point &entry) {
+		auto cell_end_point     = [&end_point_func, &segments](size_t idx, bool first_point) -> const Point& { return end_point_func(segments[idx], first_point); };
+		auto cell_could_reverse = [&could_reverse_func, &segments](size_t idx) { return could_reverse_func(segments[idx]); };
+		return chain_segments_greedy_constrained_reversals<Point, decltype(cell_end_point), decltype(cell_could_reverse)>(cell_end_point, cell_could_reverse, segments.size(), &entry);
+	};
+	return chain_segments_partitioned(end_point_func, could_reverse_func, chain_cell, num_segments, start_near);
+}
+
 std::vector<std::pair<size_t, bool>> chain_extrusion_entities(const std::vector<ExtrusionEntity*> &entities, const Point *start_near, const bool reversed)
 {
 	auto segment_end_point = [&entities, reversed](size_t idx, bool first_point) -> const Point& { return first_point == reversed ? entities[idx]->last_point() : entities[idx]->first_point(); };
 	auto could_reverse 	   = [&entities](size_t idx) { const ExtrusionEntity *ee = entities[idx]; return ee->can_reverse(); };
-	std::vector<std::pair<size_t, bool>> out = chain_segments_greedy_constrained_reversals<Point, decltype(segment_end_point), decltype(could_reverse)>(
+	std::vector<std::pair<size_t, bool>> out = chain_segments_greedy_constrained_reversals_partitioned<decltype(segment_end_point), decltype(could_reverse)>(
 		segment_end_point, could_reverse, entities.size(), start_near);
 	for (std::pair<size_t, bool> &segment : out) {
 		const ExtrusionEntity *ee = entities[segment.first];
@@ -1054,7 +1172,7 @@ std::vector<std::pair<size_t, bool>> chain_extrusion_entities(const std::vector<
 {
 	auto segment_end_point = [&entities, reversed](size_t idx, bool first_point) -> const Point& { return first_point == reversed ? entities[idx]->last_point() : entities[idx]->first_point(); };
 	auto could_reverse 	   = [&entities](size_t idx) { const ExtrusionEntity *ee = entities[idx]; return ee->can_reverse(); };
-	std::vector<std::pair<size_t, bool>> out = chain_segments_greedy_constrained_reversals<Point, decltype(segment_end_point), decltype(could_reverse)>(
+	std::vector<std::pair<size_t, bool>> out = chain_segments_greedy_constrained_reversals_partitioned<decltype(segment_end_point), decltype(could_reverse)>(
 		segment_end_point, could_reverse, entities.size(), start_near);
 	for (std::pair<size_t, bool> &segment : out) {
 		const ExtrusionEntity *ee = entities[segment.first];
@@ -2047,15 +2165,8 @@ static inline void improve_ordering_by_two_exchanges_with_segment_flipping(Polyl
 #endif /* NDEBUG */
 }
 
-// Used to optimize order of infill lines and brim lines.
-Polylines chain_polylines(Polylines &&polylines, const Point *start_near)
+static Polylines chain_polylines_greedy(Polylines &&polylines, const Point *start_near, bool improve_by_two_exchanges)
 {
-#ifdef DEBUG_SVG_OUTPUT
-	static int iRun = 0;
-	++ iRun;
-	svg_draw_polyline_chain("chain_polylines-initial", iRun, polylines);
-#endif /* DEBUG_SVG_OUTPUT */
-
 	Polylines out;
 	if (! polylines.empty()) {
 		auto segment_end_point = [&polylines](size_t idx, bool first_point) -> const Point& { return first_point ? polylines[idx].first_point() : polylines[idx].last_point(); };
@@ -2066,9 +2177,52 @@ Polylines chain_polylines(Polylines &&polylines, const Point *start_near)
 			if (segment_and_reversal.second)
 				out.back().reverse();
 		}
-		if (out.size() > 1 && start_near == nullptr) {
-			improve_ordering_by_two_exchanges_with_segment_flipping(out, start_near != nullptr);
-			//improve_ordering_by_segment_flipping(out, start_near != nullptr);
+		if (out.size() > 1 && improve_by_two_exchanges) {
+			improve_ordering_by_two_exchanges_with_segment_flipping(out, false);
+			//improve_ordering_by_segment_flipping(out, false);
+		}
+	}
+	return out;
+}
+
+// Used to optimize order of infill lines and brim lines.
+Polylines chain_polylines(Polylines &&polylines, const Point *start_near)
+{
+#ifdef DEBUG_SVG_OUTPUT
+	static int iRun = 0;
+	++ iRun;
+	svg_draw_polyline_chain("chain_polylines-initial", iRun, polylines);
+#endif /* DEBUG_SVG_OUTPUT */
+
+	Polylines out;
+	if (polylines.size() < ChainPartitionedMinSegments) {
+		out = chain_polylines_greedy(std::move(polylines), start_near, start_near == nullptr);
+	} else {
+		// Huge collection (gap fill, support lines): Chain the grid cells in parallel, including the two exchanges improvement,
+		// which is quadratic in the number of polylines.
+		auto segment_end_point = [&polylines](size_t idx, bool first_point) -> const Point& { return first_point ? polylines[idx].first_point() : polylines[idx].last_point(); };
+		std::vector<ChainGridCell> cells = chain_partition_segments(segment_end_point, polylines.size(), start_near);
+		std::vector<Polylines> chains(cells.size());
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, cells.size(), 1), [&polylines, &cells, &chains, start_near](const tbb::blocked_range<size_t> &range) {
+			for (size_t idx = range.begin(); idx < range.end(); ++ idx) {
+				Polylines cell_polylines;
+				cell_polylines.reserve(cells[idx].segments.size());
+				for (size_t segment : cells[idx].segments)
+					cell_polylines.emplace_back(std::move(polylines[segment]));
+				chains[idx] = chain_polylines_greedy(std::move(cell_polylines), &cells[idx].entry, start_near == nullptr);
+			}
+		});
+		out.reserve(polylines.size());
+		for (Polylines &chain : chains) {
+			// Join the chain from its end closer to the end of the previous chain, see chain_segments_partitioned().
+			if (! out.empty() && ! chain.empty() &&
+				(chain.back().last_point() - out.back().last_point()).cast<double>().squaredNorm() <
+				(chain.front().first_point() - out.back().last_point()).cast<double>().squaredNorm()) {
+				std::reverse(chain.begin(), chain.end());
+				for (Polyline &polyline : chain)
+					polyline.reverse();
+			}
+			append(out, std::move(chain));
 		}
 	}
 
@@ -2078,6 +2232,11 @@ Polylines chain_polylines(Polylines &&polylines, const Point *start_near)
 	return out;
 }
 
+Polylines chain_polylines_unpartitioned(Polylines &&polylines, const Point *start_near)
+{
+	return chain_polylines_greedy(std::move(polylines), start_near, start_near == nullptr);
+}
+
 template<class T> static inline T chain_path_items(const Points &points, const T &items)
 {
 	auto segment_end_point = [&points](size_t idx, bool /* first_point */) -> const Point& { return points[idx]; };
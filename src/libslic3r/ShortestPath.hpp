@@ -78,6 +78,9 @@ void                                 chain_and_reorder_extrusion_paths(std::vect
 
 Polylines 							 chain_polylines(Polylines &&src, const Point *start_near = nullptr);
 inline Polylines 					 chain_polylines(const Polylines& src, const Point* start_near = nullptr) { Polylines tmp(src); return chain_polylines(std::move(tmp), start_near); }
+// Chain polylines by a single greedy pass over the whole collection, without the spatial partitioning chain_polylines()
+// applies to huge collections. Quadratic in the worst case, to be used as a reference for benchmarking.
+Polylines 							 chain_polylines_unpartitioned(Polylines &&src, const Point *start_near = nullptr);
 
 ClipperLib::PolyNodes				 chain_clipper_polynodes(const Points &points, const ClipperLib::PolyNodes &items);
 
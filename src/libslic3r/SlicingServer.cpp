@@ -0,0 +1,227 @@
+#include "SlicingServer.hpp"
+
+#include "Exception.hpp"
+#include "ModelArrange.hpp"
+#include "Utils.hpp"
+
+#include <iterator>
+
+#include <boost/asio.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/log/trivial.hpp>
+
+#include "StdPath.hpp"
+#include "../nlohmann/json.hpp"
+
+namespace Slic3r {
+
+static const char *print_step_names[] = {
+    "wipe_tower", "alert_when_supports_needed", "skirt_brim", "gcode_export"
+};
+static_assert(std::size(print_step_names) == psCount, "print_step_names does not match PrintStep");
+
+static const char *print_object_step_names[] = {
+    "slice", "perimeters", "prepare_infill", "infill", "ironing", "support_spots_search", "support_material",
+    "estimate_curled_extrusions", "calculate_overhanging_perimeters", "simplify_path"
+};
+static_assert(std::size(print_object_step_names) == posCount, "print_object_step_names does not match PrintObjectStep");
+
+static const char *apply_status_name(PrintBase::ApplyStatus status)
+{
+    switch (status) {
+    case PrintBase::APPLY_STATUS_UNCHANGED:   return "unchanged";
+    case PrintBase::APPLY_STATUS_CHANGED:     return "changed";
+    case PrintBase::APPLY_STATUS_INVALIDATED: return "invalidated";
+    default:                                  return "unknown";
+    }
+}
+
+static Vec3d json_to_vec3d(const nlohmann::json &j)
+{
+    if (! j.is_array() || j.size() != 3)
+        throw RuntimeError("Expected an array of three numbers");
+    return { j[0].get<double>(), j[1].get<double>(), j[2].get<double>() };
+}
+
+// Serialized value of a config option from a JSON string, boolean, number or array of them.
+// Vector options take an array, its values are joined the same way the config files store them.
+static std::string json_to_config_value(const ConfigOptionDef *def, const nlohmann::json &value)
+{
+    if (value.is_string())
+        return value.get<std::string>();
+    if (value.is_boolean())
+        return value.get<bool>() ? "1" : "0";
+    if (value.is_array()) {
+        std::vector<std::string> values;
+        values.reserve(value.size());
+        for (const nlohmann::json &item : value) {
+            if (item.is_array() || item.is_object())
+                throw RuntimeError("Nested values are not supported: " + value.dump());
+            values.emplace_back(json_to_config_value(def, item));
+        }
+        if (def != nullptr && def->type == coStrings)
+            return escape_strings_cstyle(values);
+        std::string out;
+        for (const std::string &v : values) {
+            if (! out.empty())
+                out += ',';
+            out += v;
+        }
+        return out;
+    }
+    return value.dump();
+}
+
+SlicingServer::SlicingServer() : m_config(DynamicPrintConfig::full_print_config())
+{
+    m_print.set_status_silent();
+}
+
+std::string SlicingServer::handle_request(const std::string &request)
+{
+    nlohmann::json response;
+    try {
+        const nlohmann::json req = nlohmann::json::parse(request);
+        const std::string    cmd = req.at("cmd").get<std::string>();
+        if (cmd == "load_config") {
+            DynamicPrintConfig  config = DynamicPrintConfig::full_print_config();
+            ConfigSubstitutions substitutions = config.load(req.at("file").get<std::string>(), ForwardCompatibilitySubstitutionRule::Enable);
+            m_config = std::move(config);
+            response["substitutions"] = substitutions.size();
+        } else if (cmd == "set_config") {
+            // Validate all the values before changing the config, so that a failed request leaves the config intact.
+            DynamicPrintConfig config = m_config;
+            for (const auto &[key, value] : req.at("config").items())
+                config.set_deserialize_strict(key, json_to_config_value(config.option_def(key), value));
+            m_config = std::move(config);
+        } else if (cmd == "load_model") {
+            Model model = Model::read_from_file(req.at("file").get<std::string>(), nullptr, nullptr, Model::LoadAttribute::AddDefaultInstances);
+            if (req.value("arrange", true)) {
+                arr2::ArrangeSettings arrange_cfg;
+                arrange_cfg.set_distance_from_objects(min_object_distance(static_cast<const ConfigBase*>(&m_config)));
+                arrange_objects(model, arr2::to_arrange_bed(get_bed_shape(m_config)), arrange_cfg);
+            }
+            m_model = std::move(model);
+            response["objects"] = m_model.objects.size();
+        } else if (cmd == "set_instance") {
+            ModelObject   *object   = m_model.objects.at(req.at("object").get<size_t>());
+            ModelInstance *instance = object->instances.at(req.value("instance", size_t(0)));
+            if (auto it = req.find("offset"); it != req.end())
+                instance->set_offset(json_to_vec3d(*it));
+            if (auto it = req.find("rotation"); it != req.end())
+                instance->set_rotation(json_to_vec3d(*it));
+            if (auto it = req.find("scale"); it != req.end())
+                instance->set_scaling_factor(json_to_vec3d(*it));
+            object->invalidate_bounding_box();
+        } else if (cmd == "slice") {
+            DynamicPrintConfig config = m_config;
+            config.normalize_fdm();
+            if (config.opt_enum<PrinterTechnology>("printer_technology") != ptFFF)
+                throw RuntimeError("Only FFF printers are supported by the slicing server");
+            for (ModelObject *object : m_model.objects)
+                m_print.auto_assign_extruders(object);
+            response["apply"] = apply_status_name(m_print.apply(m_model, config));
+            if (std::pair<PrintBase::PrintValidationError, std::string> err = m_print.validate(); err.first != PrintBase::PrintValidationError::pveNone)
+                throw RuntimeError(err.second);
+            if (m_print.empty())
+                throw RuntimeError("Nothing to print. Either the print is empty or no object is fully inside the print volume.");
+
+            // Collect the steps invalidated by the apply, these will be recalculated.
+            const std::string path         = m_print.output_filepath(req.value("output", std::string()));
+            const bool        export_gcode = ! m_print.is_step_done(psGCodeExport) || path != m_output_path;
+            nlohmann::json    steps        = nlohmann::json::array();
+            for (size_t step = 0; step < psGCodeExport; ++ step)
+                if (! m_print.is_step_done(PrintStep(step)))
+                    steps.push_back(print_step_names[step]);
+            if (export_gcode)
+                steps.push_back(print_step_names[psGCodeExport]);
+            nlohmann::json object_steps = nlohmann::json::array();
+            for (const PrintObject *object : m_print.objects()) {
+                nlohmann::json invalidated = nlohmann::json::array();
+                for (size_t step = 0; step < posCount; ++ step)
+                    if (! object->is_step_done(PrintObjectStep(step)))
+                        invalidated.push_back(print_object_step_names[step]);
+                object_steps.push_back(std::move(invalidated));
+            }
+            response["steps"]        = std::move(steps);
+            response["object_steps"] = std::move(object_steps);
+
+            m_print.process();
+            if (export_gcode) {
+                // Forget the last output first, so that it is exported again if the export fails.
+                m_output_path.clear();
+                std::string outfile       = m_print.export_gcode(path, nullptr, nullptr);
+                std::string outfile_final = m_print.print_statistics().finalize_output_path(outfile);
+                if (outfile != outfile_final && rename_file(outfile, outfile_final))
+                    throw RuntimeError("Renaming file " + outfile + " to " + outfile_final + " failed");
+                m_output_path = path;
+                response["output"] = outfile_final;
+            }
+            const PrintStatistics &stats = m_print.print_statistics();
+            response["total_used_filament"]   = stats.total_used_filament;
+            response["total_extruded_volume"] = stats.total_extruded_volume;
+            response["total_weight"]          = stats.total_weight;
+            response["total_cost"]            = stats.total_cost;
+        } else if (cmd == "shutdown") {
+            m_shutdown = true;
+        } else
+            throw RuntimeError("Unknown command: " + cmd);
+        response["ok"] = true;
+    } catch (const std::exception &ex) {
+        response = nlohmann::json{ { "ok", false }, { "error", ex.what() } };
+    }
+    return response.dump();
+}
+
+void SlicingServer::serve(const std::string &socket_path)
+{
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+    using boost::asio::local::stream_protocol;
+    boost::asio::io_context io_context;
+    stream_protocol::acceptor acceptor(io_context);
+    try {
+        // Remove a socket left over by a previous run, but never any other file.
+        boost::system::error_code   ec;
+        boost::filesystem::file_type type = boost::filesystem::status(socket_path, ec).type();
+        if (type == boost::filesystem::socket_file)
+            boost::filesystem::remove(socket_path);
+        else if (type != boost::filesystem::file_not_found)
+            throw RuntimeError("The path exists and it is not a socket");
+        acceptor.open();
+        acceptor.bind(stream_protocol::endpoint(socket_path));
+        acceptor.listen();
+    } catch (const std::exception &ex) {
+        throw RuntimeError("Failed to listen on " + socket_path + ": " + ex.what());
+    }
+    BOOST_LOG_TRIVIAL(info) << "Slicing server listening on " << socket_path;
+
+    while (! m_shutdown) {
+        stream_protocol::socket socket(io_context);
+        acceptor.accept(socket);
+        boost::asio::streambuf  buffer;
+        boost::system::error_code ec;
+        while (! m_shutdown) {
+            boost::asio::read_until(socket, buffer, '\n', ec);
+            if (ec)
+                // The client disconnected.
+                break;
+            std::string request;
+            std::istream is(&buffer);
+            std::getline(is, request);
+            std::string response = this->handle_request(request) + "\n";
+            boost::asio::write(socket, boost::asio::buffer(response), ec);
+            if (ec)
+                break;
+        }
+    }
+
+    acceptor.close();
+    boost::system::error_code ec;
+    if (boost::filesystem::status(socket_path, ec).type() == boost::filesystem::socket_file)
+        boost::filesystem::remove(socket_path, ec);
+#else
+    throw RuntimeError("Local sockets are not supported on this platform");
+#endif
+}
+
+} // namespace Slic3r
@@ -0,0 +1,51 @@
+#ifndef slic3r_SlicingServer_hpp_
+#define slic3r_SlicingServer_hpp_
+
+#include <string>
+
+#include "Model.hpp"
+#include "Print.hpp"
+#include "PrintConfig.hpp"
+
+namespace Slic3r {
+
+// Headless slicing service keeping a single Print alive between the requests.
+// Same as with the BackgroundSlicingProcess of the GUI, the config and the model are applied to the Print
+// with Print::apply(), thus a change of a setting or of an instance placement only recalculates the steps it invalidates.
+//
+// Requests and responses are JSON objects, one per line:
+//  {"cmd":"load_config","file":"<path>"}                                      replace the config with a config file
+//  {"cmd":"set_config","config":{"<key>":<value>,...}}                        change some settings, vector values as arrays
+//  {"cmd":"load_model","file":"<path>","arrange":true}                        replace the model
+//  {"cmd":"set_instance","object":0,"instance":0,"offset":[x,y,z],"rotation":[x,y,z],"scale":[x,y,z]}
+//  {"cmd":"slice","output":"<path template>"}                                 process and export the G-code
+//  {"cmd":"shutdown"}
+// A response is {"ok":true,...} or {"ok":false,"error":"<message>"}. The response to "slice" lists the steps
+// recalculated by the request, the G-code is only exported again if it was invalidated or if the output path changed.
+class SlicingServer
+{
+public:
+    SlicingServer();
+
+    // Process a single request, return the response. Errors are reported by the response.
+    std::string handle_request(const std::string &request);
+    bool        shutdown_requested() const { return m_shutdown; }
+    const DynamicPrintConfig& config() const { return m_config; }
+
+    // Listen on a local socket and serve the clients one after another until a shutdown request arrives.
+    // A socket left at socket_path by a previous run is replaced, any other file at socket_path is an error.
+    // Throws RuntimeError if the socket could not be opened or if local sockets are not supported on this platform.
+    void        serve(const std::string &socket_path);
+
+private:
+    DynamicPrintConfig  m_config;
+    Model               m_model;
+    Print               m_print;
+    // Path of the last exported G-code, empty if the G-code was not exported yet.
+    std::string         m_output_path;
+    bool                m_shutdown { false };
+};
+
+} // namespace Slic3r
+
+#endif // slic3r_SlicingServer_hpp_
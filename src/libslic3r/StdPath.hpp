@@ -0,0 +1,21 @@
+#ifndef slic3r_StdPath_hpp_
+#define slic3r_StdPath_hpp_
+
+// Path and input file stream types of the platform, std::filesystem is not usable on older macOS targets.
+// std_path is also required by the bundled nlohmann/json, include this header before it.
+
+#ifdef __APPLE__
+    #include <boost/filesystem.hpp>
+    #include <boost/nowide/fstream.hpp>
+    typedef boost::filesystem::path std_path;
+    typedef boost::nowide::ifstream std_ifstream;
+    #define GET_STD_PATH_FOR_IFSTREAM(PARAM) PARAM.string()
+#else
+    #include <filesystem>
+    #include <fstream>
+    typedef std::filesystem::path std_path;
+    typedef std::ifstream std_ifstream;
+    #define GET_STD_PATH_FOR_IFSTREAM(PARAM) PARAM
+#endif
+
+#endif // slic3r_StdPath_hpp_
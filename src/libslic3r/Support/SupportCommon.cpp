@@ -1652,6 +1652,7 @@ void generate_support_toolpaths(
             (const tbb::blocked_range<size_t>& range) {
         for (size_t support_layer_id = range.begin(); support_layer_id < range.end(); ++ support_layer_id)
         {
+            SLIC3R_ALLOCATION_STATISTICS_SCOPE("generate_support_toolpaths raft layer");
             assert(support_layer_id < raft_layers.size());
             SupportLayer               &support_layer = *support_layers[support_layer_id];
             assert(support_layer.support_fills.entities().empty());
@@ -1830,6 +1831,7 @@ void generate_support_toolpaths(
             filler_base_interface->set_bounding_box(bbox_object);
         for (size_t support_layer_id = range.begin(); support_layer_id < range.end(); ++ support_layer_id)
         {
+            SLIC3R_ALLOCATION_STATISTICS_SCOPE("generate_support_toolpaths support layer");
             SupportLayer &support_layer = *support_layers[support_layer_id];
             LayerCache   &layer_cache   = layer_caches[support_layer_id];
             float         interface_angle_delta = 0;
@@ -42,6 +42,8 @@
 #include <boost/predef/other/endian.h>
 
 #include <tbb/concurrent_vector.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
 
 #include <Eigen/Core>
 #include <Eigen/Dense>
@@ -691,10 +693,11 @@ std::vector<Vec3i32> its_face_edge_ids(const indexed_triangle_set &its, std::vec
 int its_merge_vertices(indexed_triangle_set &its, bool shrink_to_fit)
 {
     // 1) Sort indices to vertices lexicographically by coordinates AND vertex index.
+    // The order is total, thus the parallel sort produces the same result as a serial one.
     auto sorted = reserve_vector<int>(its.vertices.size());
     for (int i = 0; i < int(its.vertices.size()); ++ i)
         sorted.emplace_back(i);
-    std::sort(sorted.begin(), sorted.end(), [&its](int il, int ir) {
+    tbb::parallel_sort(sorted.begin(), sorted.end(), [&its](int il, int ir) {
         const Vec3f &l = its.vertices[il];
         const Vec3f &r = its.vertices[ir];
         // Sort lexicographically by coordinates AND vertex index.
@@ -739,9 +742,13 @@ int its_merge_vertices(indexed_triangle_set &its, bool shrink_to_fit)
         // Shrink the vertices.
         its.vertices.erase(its.vertices.begin() + k, its.vertices.end());
         // Remap face indices.
-        for (stl_triangle_vertex_indices &face : its.indices)
-            for (int i = 0; i < 3; ++ i)
-                face(i) = map_vertices[face(i)];
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size(), 16384), [&its, &map_vertices](const tbb::blocked_range<size_t> &range) {
+            for (size_t face_idx = range.begin(); face_idx < range.end(); ++ face_idx) {
+                stl_triangle_vertex_indices &face = its.indices[face_idx];
+                for (int i = 0; i < 3; ++ i)
+                    face(i) = map_vertices[face(i)];
+            }
+        });
         // Optionally shrink to fit (reallocate) vertices.
         if (shrink_to_fit)
             its.vertices.shrink_to_fit();
@@ -285,6 +285,11 @@ inline typename CONTAINER_TYPE::value_type& next_value_modulo(typename CONTAINER
 extern std::string xml_escape(std::string text, bool is_marked = false);
 extern std::string xml_escape_double_quotes_attribute_value(std::string text);
 
+// Split a command line into arguments the way a POSIX shell does without expansions: arguments are separated by white space,
+// single or double quotes group characters including white space. Backslash is an ordinary character, so that Windows paths
+// do not need to be escaped. Throws RuntimeError on an unterminated quote.
+extern std::vector<std::string> split_command_line(const std::string &line);
+
 
 #if defined __GNUC__ && __GNUC__ < 5 && !defined __clang__
 // Older GCCs don't have std::is_trivially_copyable
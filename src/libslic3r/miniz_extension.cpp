@@ -2,7 +2,14 @@
 ///|/
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
+#include <algorithm>
+#include <atomic>
 #include <exception>
+#include <memory>
+#include <optional>
+
+#include <tbb/parallel_pipeline.h>
+#include <tbb/task_arena.h>
 
 #include "miniz_extension.hpp"
 
@@ -156,4 +163,113 @@ std::string MZ_Archive::get_errorstr(mz_zip_error mz_err)
     return "unknown error";
 }
 
+// Size of the uncompressed blocks deflated independently by MZ_ParallelDeflater.
+// The compression ratio does not suffer much if the blocks are much larger than the 32kB deflate window.
+static constexpr size_t PARALLEL_DEFLATE_BLOCK_SIZE = 1024 * 1024;
+
+// Deflate a single block into out, terminated by a full flush.
+static bool deflate_block(std::string_view data, int level, std::string &out)
+{
+    auto compressor = std::make_unique<tdefl_compressor>();
+    // Negative window bits: raw deflate stream without the zlib header, as stored in ZIP files.
+    const mz_uint flags = tdefl_create_comp_flags_from_zip_params(level, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY);
+    auto put = [](const void *buf, int len, void *user) -> mz_bool {
+        static_cast<std::string*>(user)->append(static_cast<const char*>(buf), size_t(len));
+        return MZ_TRUE;
+    };
+    return tdefl_init(compressor.get(), put, &out, int(flags)) == TDEFL_STATUS_OKAY &&
+           tdefl_compress_buffer(compressor.get(), data.data(), data.size(), TDEFL_FULL_FLUSH) == TDEFL_STATUS_OKAY;
+}
+
+MZ_ParallelDeflater::MZ_ParallelDeflater(mz_zip_archive *zip, const char *name, mz_uint64 max_size, int level)
+    : m_level(std::clamp<int>(level, 0, MZ_UBER_COMPRESSION))
+{
+    // The staged writer compresses nothing but the empty final block, which terminates the stream of the compressed blocks.
+    // It does not accept the store level, though the stored blocks are a valid deflate stream as well.
+    m_open = mz_zip_writer_add_staged_open(zip, &m_context, name, max_size, nullptr, nullptr, 0, mz_uint(std::max(m_level, 1)),
+        nullptr, 0, nullptr, 0);
+}
+
+MZ_ParallelDeflater::~MZ_ParallelDeflater()
+{
+    if (m_open)
+        this->finish();
+}
+
+bool MZ_ParallelDeflater::write_block(std::string_view data, const std::string &compressed)
+{
+    mz_zip_archive          *zip   = m_context.pZip;
+    mz_zip_writer_add_state &state = m_context.add_state;
+    if (m_context.file_ofs + data.size() > m_context.max_size) {
+        zip->m_last_error = MZ_ZIP_ARCHIVE_TOO_LARGE;
+        return false;
+    }
+    if (zip->m_pWrite(zip->m_pIO_opaque, state.m_cur_archive_file_ofs, compressed.data(), compressed.size()) != compressed.size()) {
+        zip->m_last_error = MZ_ZIP_FILE_WRITE_FAILED;
+        return false;
+    }
+    state.m_cur_archive_file_ofs += compressed.size();
+    state.m_comp_size            += compressed.size();
+    m_context.file_ofs           += data.size();
+    m_context.uncomp_crc32        = mz_uint32(mz_crc32(m_context.uncomp_crc32, reinterpret_cast<const mz_uint8*>(data.data()), data.size()));
+    return true;
+}
+
+bool MZ_ParallelDeflater::append(const std::vector<std::string_view> &data)
+{
+    if (! m_open)
+        return false;
+
+    std::vector<std::string_view> blocks;
+    for (std::string_view d : data)
+        for (size_t i = 0; i < d.size(); i += PARALLEL_DEFLATE_BLOCK_SIZE)
+            blocks.emplace_back(d.substr(i, PARALLEL_DEFLATE_BLOCK_SIZE));
+
+    // The blocks are deflated in parallel and written in order by the last filter, thus at most
+    // max_tokens compressed blocks are held in memory.
+    size_t            next_idx = 0;
+    // Written by the last filter and read by the first one, which may run on different threads.
+    std::atomic<bool> ok { true };
+    tbb::parallel_pipeline(2 * size_t(tbb::this_task_arena::max_concurrency()),
+        tbb::make_filter<void, size_t>(tbb::filter_mode::serial_in_order,
+            [&blocks, &next_idx, &ok](tbb::flow_control &fc) -> size_t {
+                if (! ok.load(std::memory_order_relaxed) || next_idx == blocks.size()) {
+                    fc.stop();
+                    return 0;
+                }
+                return next_idx ++;
+            }) &
+        tbb::make_filter<size_t, std::pair<size_t, std::optional<std::string>>>(tbb::filter_mode::parallel,
+            [this, &blocks](size_t idx) -> std::pair<size_t, std::optional<std::string>> {
+                std::string compressed;
+                if (! deflate_block(blocks[idx], m_level, compressed))
+                    return { idx, std::nullopt };
+                return { idx, std::move(compressed) };
+            }) &
+        tbb::make_filter<std::pair<size_t, std::optional<std::string>>, void>(tbb::filter_mode::serial_in_order,
+            [this, &blocks, &ok](std::pair<size_t, std::optional<std::string>> &&compressed) {
+                if (ok.load(std::memory_order_relaxed) && ! (compressed.second && this->write_block(blocks[compressed.first], *compressed.second)))
+                    ok.store(false, std::memory_order_relaxed);
+            }));
+    return ok.load(std::memory_order_relaxed);
+}
+
+bool MZ_ParallelDeflater::finish()
+{
+    if (! m_open)
+        return false;
+    m_open = false;
+    // The compressor of the staged writer has not seen any data yet, it terminates the stream with an empty final block.
+    return mz_zip_writer_add_staged_finish(&m_context);
+}
+
+bool mz_zip_writer_add_mem_parallel(mz_zip_archive *zip, const char *name, const void *data, size_t size, int level)
+{
+    if (size < PARALLEL_DEFLATE_BLOCK_SIZE)
+        // Nothing to parallelize.
+        return mz_zip_writer_add_mem(zip, name, data, size, mz_uint(level));
+    MZ_ParallelDeflater deflater(zip, name, size, level);
+    return deflater.append(std::string_view(static_cast<const char*>(data), size)) && deflater.finish();
+}
+
 } // namespace Slic3r
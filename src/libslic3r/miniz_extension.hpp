@@ -6,6 +6,8 @@
 #define MINIZ_EXTENSION_HPP
 
 #include <string>
+#include <string_view>
+#include <vector>
 #include <miniz.h>
 
 namespace Slic3r {
@@ -34,6 +36,41 @@ public:
     }
 };
 
+// Compresses the data of a single archive entry in parallel and writes it to the archive as it goes.
+// The data is split into blocks, which are deflated independently and terminated with a full flush,
+// thus the compressed blocks concatenate into a single deflate stream readable by any ZIP reader.
+// The entry is written with a data descriptor, so the CRC and the sizes are stored once the entry is finished.
+// The data may be appended in several calls to limit the amount of uncompressed data held in memory.
+class MZ_ParallelDeflater {
+public:
+    // Opens the entry name of zip, name has to stay valid until the entry is finished.
+    // max_size limits the uncompressed size, the ZIP64 extension is reserved for entries above 4GB.
+    // level is a ZIP compression level, 0 (store) to MZ_UBER_COMPRESSION.
+    MZ_ParallelDeflater(mz_zip_archive *zip, const char *name, mz_uint64 max_size, int level = MZ_DEFAULT_LEVEL);
+    // Finishes the entry if not finished yet to keep the archive consistent.
+    ~MZ_ParallelDeflater();
+
+    // Compresses the data in parallel and writes the compressed blocks to the archive in order.
+    // Fails if the entry could not be opened, on a write error or if max_size is exceeded.
+    bool append(const std::vector<std::string_view> &data);
+    bool append(std::string_view data) { return this->append(std::vector<std::string_view>{ data }); }
+
+    mz_uint64 uncompressed_size() const { return m_context.file_ofs; }
+
+    // Terminates the compressed stream and writes the data descriptor and the central directory record.
+    bool finish();
+
+private:
+    bool write_block(std::string_view data, const std::string &compressed);
+
+    int                          m_level;
+    bool                         m_open { false };
+    mz_zip_writer_staged_context m_context;
+};
+
+// Same as mz_zip_writer_add_mem(), but the data is compressed in parallel.
+bool mz_zip_writer_add_mem_parallel(mz_zip_archive *zip, const char *name, const void *data, size_t size, int level = MZ_DEFAULT_LEVEL);
+
 } // namespace Slic3r
 
 #endif // MINIZ_EXTENSION_HPP
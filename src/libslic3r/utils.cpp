@@ -5,6 +5,7 @@
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
 #include "Utils.hpp"
+#include "Exception.hpp"
 #include "I18N.hpp"
 
 #include <atomic>
@@ -1197,6 +1198,37 @@ std::string xml_escape_double_quotes_attribute_value(std::string text)
     return text;
 }
 
+std::vector<std::string> split_command_line(const std::string &line)
+{
+    std::vector<std::string> args;
+    std::string              arg;
+    // An argument may be empty if quoted, thus track whether any argument is being collected.
+    bool                     in_arg = false;
+    for (size_t i = 0; i < line.size(); ++ i) {
+        const char c = line[i];
+        if (c == '"' || c == '\'') {
+            size_t end = line.find(c, i + 1);
+            if (end == std::string::npos)
+                throw Slic3r::RuntimeError(format("Unterminated quote at position %1% of \"%2%\"", i, line));
+            arg.append(line, i + 1, end - i - 1);
+            in_arg = true;
+            i = end;
+        } else if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            if (in_arg) {
+                args.emplace_back(std::move(arg));
+                arg.clear();
+                in_arg = false;
+            }
+        } else {
+            arg += c;
+            in_arg = true;
+        }
+    }
+    if (in_arg)
+        args.emplace_back(std::move(arg));
+    return args;
+}
+
 std::string short_time(const std::string &time, bool force_localization /*= false*/)
 {
 	// Parse the dhms time format.
@@ -7428,6 +7428,7 @@ void Plater::export_platter()
                 OptionStore3mf{}
                 .set_fullpath_sources(wxGetApp().app_config->get("export_sources_full_pathnames") == "1")
                 .set_thumbnail_data(&thumbnail_data)
+                .set_compression_level(wxGetApp().app_config->get_int("3mf_compression_level"))
                 .set_export_config(extra_options->with_config())
                 .set_export_modifiers(extra_options->with_modifers())
             );
@@ -7776,7 +7777,8 @@ bool Plater::export_3mf(const boost::filesystem::path& output_path)
     bool ret = false;
     try
     {
-        ret = Slic3r::store_3mf(path_u8.c_str(), &p->model, &cfg, OptionStore3mf{}.set_fullpath_sources(full_pathnames).set_thumbnail_data(&thumbnail_data));
+        ret = Slic3r::store_3mf(path_u8.c_str(), &p->model, &cfg, OptionStore3mf{}.set_fullpath_sources(full_pathnames).set_thumbnail_data(&thumbnail_data)
+            .set_compression_level(wxGetApp().app_config->get_int("3mf_compression_level")));
     }
     catch (boost::filesystem::filesystem_error& e)
     {
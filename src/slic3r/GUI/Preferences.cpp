@@ -546,6 +546,14 @@ void PreferencesDialog::build()
 			L("If enabled, allows the Reload from disk command to automatically find and load the files when invoked."),
 			app_config->get_bool("export_sources_full_pathnames"));
 
+		append_int_option(m_tabid_2_optgroups.back().back(), "3mf_compression_level",
+			L("3mf compression level"),
+			L("Compression level of the files stored into 3mf projects, from 0 (no compression, fastest) to 10 (smallest files, slowest)."
+			  "\nThe default is 6."),
+			6,
+			app_config->get_int("3mf_compression_level"),
+			ConfigOptionMode::comNone, 0, 10);
+
 #ifdef _WIN32
 		// Please keep in sync with ConfigWizard
 		append_bool_option(m_tabid_2_optgroups.back().back(), "associate_3mf",
@@ -463,6 +463,66 @@ TEST_CASE("NFP should be empty if item cannot fit into bed", "[arrange2]") {
     }
 }
 
+TEST_CASE("Cached NFP should match the calculated one", "[arrange2]") {
+    using namespace Slic3r;
+
+    arr2::InfiniteBed bed;
+
+    for (auto td : nfp_testdata) {
+        arr2::NFPCache::instance().clear();
+
+        std::array<std::reference_wrapper<const ArrangeItem>, 1> fixed =
+            {{td.stationary}};
+
+        // Fills the cache
+        arr2::calculate_nfp(td.orbiter, default_context(fixed), bed);
+        REQUIRE(arr2::NFPCache::instance().size() == 1);
+
+        // A copy of the fixed item, moved elsewhere, hits the cache
+        ArrangeItem moved = td.stationary;
+        arr2::translate(moved, Vec2crd{scaled(12.), scaled(-7.)});
+        arr2::translate(td.orbiter, Vec2crd{scaled(3.), scaled(5.)});
+        fixed = {{moved}};
+        ExPolygons cached = arr2::calculate_nfp(td.orbiter, default_context(fixed), bed);
+        REQUIRE(arr2::NFPCache::instance().size() == 1);
+
+        arr2::NFPCache::instance().clear();
+        ExPolygons calculated = arr2::calculate_nfp(td.orbiter, default_context(fixed), bed);
+
+        REQUIRE(!calculated.empty());
+        REQUIRE(diff_ex(cached, calculated).empty());
+        REQUIRE(diff_ex(calculated, cached).empty());
+    }
+}
+
+TEST_CASE("NFP cache hit requires equal shapes, not only equal fingerprints", "[arrange2]") {
+    using namespace Slic3r;
+
+    arr2::NFPCache cache;
+
+    Polygons square    = { Polygon{ {0, 0}, {10, 0}, {10, 10}, {0, 10} } };
+    Polygons other     = { Polygon{ {0, 0}, {20, 0}, {20, 10}, {0, 10} } };
+    Polygons nfp       = { Polygon{ {-10, -10}, {10, -10}, {10, 10}, {-10, 10} } };
+    Polygons other_nfp = { Polygon{ {-20, -10}, {20, -10}, {20, 10}, {-20, 10} } };
+
+    // Simulate a collision of the fingerprints of two different shapes.
+    arr2::NFPCache::Key key{arr2::shape_fingerprint(square), 0., arr2::shape_fingerprint(square), 0.};
+    cache.insert(key, square, square, nfp);
+
+    REQUIRE(cache.find(key, square, square) == nfp);
+    REQUIRE(! cache.find(key, other, square));
+    REQUIRE(! cache.find(key, square, other));
+
+    cache.insert(key, other, square, other_nfp);
+    REQUIRE(cache.size() == 2);
+    REQUIRE(cache.find(key, square, square) == nfp);
+    REQUIRE(cache.find(key, other, square) == other_nfp);
+
+    // Inserting the same shapes again does not add an entry.
+    cache.insert(key, square, square, nfp);
+    REQUIRE(cache.size() == 2);
+}
+
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem.hpp>
 
@@ -5,10 +5,13 @@
 #include <catch2/catch.hpp>
 
 #include <memory>
+#include <random>
 #include <regex>
 #include <fstream>
 
 #include "libslic3r/GCode.hpp"
+#include "libslic3r/GCode/ConflictChecker.hpp"
+#include "libslic3r/GCode/GCodeProcessor.hpp"
 #include "libslic3r/Geometry/ConvexHull.hpp"
 #include "libslic3r/ModelArrange.hpp"
 #include "test_data.hpp"
@@ -323,3 +326,90 @@ TEST_CASE("M201 for acceleation reset", "[GCode]") {
     INFO("M204 is not generated for repetier firmware");
     CHECK(!has_m204);
 }
+
+TEST_CASE("Conflict checker finds intersections of different instances only", "[GCode]") {
+    auto line = [](double x1, double y1, double x2, double y2, int obj_id, int inst_id) {
+        return LineWithID(Line(Point::new_scale(x1, y1), Point::new_scale(x2, y2)), obj_id, inst_id, ExtrusionRole::Perimeter);
+    };
+    SECTION("crossing lines of two objects") {
+        LineWithIDs lines { line(0, 0, 10, 10, 0, 0), line(20, 20, 30, 20, 0, 0), line(0, 10, 10, 0, 1, 0), line(50, 50, 60, 60, 1, 0) };
+        ConflictComputeOpt result = ConflictChecker::find_inter_of_lines(lines);
+        REQUIRE(result.has_value());
+        CHECK(std::min(result->_obj1, result->_obj2) == 0);
+        CHECK(std::max(result->_obj1, result->_obj2) == 1);
+    }
+    SECTION("crossing lines of two instances of the same object") {
+        LineWithIDs lines { line(0, 0, 10, 10, 0, 0), line(0, 10, 10, 0, 0, 1) };
+        REQUIRE(ConflictChecker::find_inter_of_lines(lines).has_value());
+    }
+    SECTION("crossing lines of the same instance") {
+        LineWithIDs lines { line(0, 0, 10, 10, 0, 0), line(0, 10, 10, 0, 0, 0) };
+        REQUIRE(! ConflictChecker::find_inter_of_lines(lines).has_value());
+    }
+    SECTION("overlapping footprints without crossing lines") {
+        LineWithIDs lines { line(0, 0, 10, 0, 0, 0), line(10, 0, 10, 10, 0, 0), line(1, 5, 9, 6, 1, 0), line(20, 0, 20, 10, 1, 0) };
+        REQUIRE(! ConflictChecker::find_inter_of_lines(lines).has_value());
+    }
+}
+
+TEST_CASE("Estimated times per move type and per layer add up to the total time", "[GCode]") {
+    Print print;
+    Model model;
+    Slic3r::Test::init_print({ TestMesh::cube_20x20x20 }, print, model, DynamicPrintConfig::full_print_config());
+    print.process();
+    GCodeProcessorResult result;
+    boost::filesystem::path temp = boost::filesystem::unique_path();
+    print.export_gcode(temp.string(), &result, nullptr);
+    boost::filesystem::remove(temp);
+
+    const PrintEstimatedStatistics::Mode &mode = result.print_statistics.modes[static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Normal)];
+    REQUIRE(mode.time > 0.f);
+    float moves_time = 0.f;
+    for (const std::pair<EMoveType, float> &move_time : mode.moves_times)
+        moves_time += move_time.second;
+    float layers_time = 0.f;
+    for (float layer_time : mode.layers_times)
+        layers_time += layer_time;
+    CHECK(mode.layers_times.size() > 1);
+    CHECK(moves_time == Approx(mode.time).epsilon(1e-4));
+    CHECK(layers_time == Approx(mode.time).epsilon(1e-4));
+}
+
+TEST_CASE("Block times evaluated over arrays match the times of the single blocks", "[GCode]") {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> feedrate(0.f, 200.f);
+    std::uniform_real_distribution<float> acceleration(100.f, 5000.f);
+    // Short blocks don't reach the cruise feedrate, the long ones do.
+    std::uniform_real_distribution<float> distance(0.01f, 50.f);
+
+    std::vector<GCodeProcessor::TimeBlock> blocks(1000);
+    for (size_t i = 0; i < blocks.size(); ++ i) {
+        GCodeProcessor::TimeBlock &block = blocks[i];
+        block.distance                = distance(rng);
+        block.acceleration            = i % 4 == 0 ? 0.f : acceleration(rng);
+        block.feedrate_profile.cruise = i % 5 == 0 ? 0.f : feedrate(rng);
+        block.feedrate_profile.entry  = std::min(feedrate(rng), block.feedrate_profile.cruise);
+        block.feedrate_profile.exit   = std::min(feedrate(rng), block.feedrate_profile.cruise);
+        block.calculate_trapezoid();
+    }
+
+    size_t num_zero_acceleration = 0;
+    size_t num_zero_cruise       = 0;
+    size_t num_no_cruise_phase   = 0;
+    for (const GCodeProcessor::TimeBlock &block : blocks) {
+        num_zero_acceleration += block.acceleration == 0.f;
+        num_zero_cruise       += block.trapezoid.cruise_feedrate == 0.f;
+        num_no_cruise_phase   += block.trapezoid.cruise_feedrate != 0.f && block.trapezoid.cruise_distance() == 0.f;
+    }
+    REQUIRE(num_zero_acceleration > 0);
+    REQUIRE(num_zero_cruise > 0);
+    REQUIRE(num_no_cruise_phase > 0);
+
+    // The last blocks are kept in the planner queue and not evaluated.
+    const size_t num_blocks = blocks.size() - 3;
+    const Eigen::ArrayXf times = GCodeProcessor::blocks_time(blocks, num_blocks);
+    REQUIRE(size_t(times.size()) == num_blocks);
+    // The compiler may contract the scalar and the array expressions into fused multiply-adds differently.
+    for (size_t i = 0; i < num_blocks; ++ i)
+        CHECK(times[i] == Approx(blocks[i].time()).epsilon(1e-5).margin(1e-6));
+}
@@ -627,3 +627,66 @@ SCENARIO("Seam alignment", "[Perimeters]")
         test(Slic3r::Test::TestMesh::small_dorito);
     }
 }
+
+static Polylines perimeter_polylines(const LayerRegion &layerm)
+{
+    ArcPolylines polylines;
+    layerm.perimeters().collect_polylines(polylines);
+    return to_polylines(polylines);
+}
+
+static bool same_fill_surfaces(const LayerRegion &lhs, const LayerRegion &rhs)
+{
+    const Surfaces &l = lhs.fill_surfaces().surfaces;
+    const Surfaces &r = rhs.fill_surfaces().surfaces;
+    if (l.size() != r.size())
+        return false;
+    for (size_t i = 0; i < l.size(); ++ i)
+        if (l[i].surface_type != r[i].surface_type || ! (l[i].expolygon == r[i].expolygon))
+            return false;
+    return true;
+}
+
+SCENARIO("Perimeters of identical layers", "[Perimeters]")
+{
+    GIVEN("20mm cube") {
+        auto process = [](Print &print, bool reuse) {
+            Slic3r::Test::init_and_process_print({ Test::TestMesh::cube_20x20x20 }, print, {
+                { "layer_height",                     0.2 },
+                { "first_layer_height",               0.2 },
+                { "perimeters",                       3 },
+                { "perimeter_reuse_identical_layers", reuse }
+            });
+        };
+        Print print;
+        process(print, true);
+        const PrintObject &object = *print.objects().front();
+        const Layer       &layer  = *object.get_layer(50);
+        THEN("a layer in the middle of the cube has the same perimeters input as the layer two layers below") {
+            REQUIRE(layer.has_same_perimeters_input(*object.get_layer(48)));
+            REQUIRE(! layer.has_same_perimeters_input(*object.get_layer(49)));
+            REQUIRE(! object.get_layer(2)->has_same_perimeters_input(*object.get_layer(0)));
+        }
+        THEN("the reused perimeters are the same as the perimeters of the source layer") {
+            const LayerRegion &layerm        = *layer.get_region(0);
+            const LayerRegion &source_layerm = *object.get_layer(48)->get_region(0);
+            REQUIRE(! layerm.perimeters().empty());
+            REQUIRE(perimeter_polylines(layerm) == perimeter_polylines(source_layerm));
+            REQUIRE(same_fill_surfaces(layerm, source_layerm));
+            REQUIRE(layer.lslices_ex.size() == 1);
+            REQUIRE(layer.lslices_ex.front().islands.size() == 1);
+            REQUIRE(! layer.lslices_ex.front().islands.front().perimeters.empty());
+        }
+        THEN("the reused perimeters are the same as the perimeters generated without reuse") {
+            Print print_generated;
+            process(print_generated, false);
+            const PrintObject &object_generated = *print_generated.objects().front();
+            for (size_t layer_idx : { size_t(49), size_t(50) }) {
+                const LayerRegion &layerm           = *object.get_layer(layer_idx)->get_region(0);
+                const LayerRegion &generated_layerm = *object_generated.get_layer(layer_idx)->get_region(0);
+                REQUIRE(perimeter_polylines(layerm) == perimeter_polylines(generated_layerm));
+                REQUIRE(same_fill_surfaces(layerm, generated_layerm));
+            }
+        }
+    }
+}
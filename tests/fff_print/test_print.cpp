@@ -3,6 +3,9 @@
 #include "libslic3r/libslic3r.h"
 #include "libslic3r/Print.hpp"
 #include "libslic3r/Layer.hpp"
+#include "libslic3r/SlicingServer.hpp"
+
+#include <boost/filesystem/operations.hpp>
 
 #include "test_data.hpp"
 
@@ -197,3 +200,92 @@ SCENARIO("Ported from Perl", "[Print]") {
         }
     }
 }
+
+SCENARIO("SlicingServer: incremental slicing", "[Print]") {
+    GIVEN("Slicing server with a 20mm cube loaded") {
+        SlicingServer server;
+        const std::string output = (boost::filesystem::temp_directory_path() / "slicing_server_test.gcode").string();
+        const std::string slice  = "{\"cmd\":\"slice\",\"output\":\"" + output + "\"}";
+        REQUIRE(server.handle_request("{\"cmd\":\"load_model\",\"file\":\"" TEST_DATA_DIR "/20mm_cube.obj\"}").find("\"ok\":true") != std::string::npos);
+        std::string response = server.handle_request(slice);
+        REQUIRE(response.find("\"ok\":true") != std::string::npos);
+        THEN("first slicing calculates all the steps") {
+            REQUIRE(response.find("\"slice\"") != std::string::npos);
+            REQUIRE(response.find("\"gcode_export\"") != std::string::npos);
+        }
+        WHEN("slicing again without any change") {
+            response = server.handle_request(slice);
+            THEN("nothing is recalculated") {
+                REQUIRE(response.find("\"apply\":\"unchanged\"") != std::string::npos);
+                REQUIRE(response.find("\"steps\":[]") != std::string::npos);
+                REQUIRE(response.find("\"object_steps\":[[]]") != std::string::npos);
+            }
+        }
+        WHEN("infill density is changed") {
+            REQUIRE(server.handle_request("{\"cmd\":\"set_config\",\"config\":{\"fill_density\":\"40%\"}}").find("\"ok\":true") != std::string::npos);
+            response = server.handle_request(slice);
+            THEN("infill is recalculated, slices are reused") {
+                REQUIRE(response.find("\"ok\":true") != std::string::npos);
+                REQUIRE(response.find("\"infill\"") != std::string::npos);
+                REQUIRE(response.find("\"slice\"") == std::string::npos);
+                REQUIRE(response.find("\"gcode_export\"") != std::string::npos);
+            }
+        }
+        WHEN("vector values are set as arrays") {
+            response = server.handle_request("{\"cmd\":\"set_config\",\"config\":{\"retract_length\":[0.4,0.6],\"post_process\":[\"a;b\",\"c\"]}}");
+            THEN("the arrays are applied element by element") {
+                REQUIRE(response.find("\"ok\":true") != std::string::npos);
+                REQUIRE(server.config().option<ConfigOptionFloats>("retract_length")->get_values() == std::vector<double>{ 0.4, 0.6 });
+                REQUIRE(server.config().option<ConfigOptionStrings>("post_process")->get_values() == std::vector<std::string>{ "a;b", "c" });
+            }
+        }
+        WHEN("an invalid value is set") {
+            response = server.handle_request("{\"cmd\":\"set_config\",\"config\":{\"no_such_option\":1}}");
+            THEN("an error is reported") {
+                REQUIRE(response.find("\"ok\":false") != std::string::npos);
+            }
+        }
+        boost::filesystem::remove(output);
+    }
+}
+
+SCENARIO("Seam placement data is kept between G-code exports", "[Print]") {
+    GIVEN("Two 20mm cubes exported with aligned seams") {
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config_with({
+            { "seam_position", "aligned" }
+        });
+        Print print;
+        Model model;
+        Slic3r::Test::init_print({ TestMesh::cube_20x20x20, TestMesh::cube_20x20x20 }, print, model, config);
+        Slic3r::Test::gcode(print);
+        const PrintObjectSeamData *seam_data = print.get_object(0)->seam_data().get();
+        REQUIRE(seam_data != nullptr);
+        WHEN("an instance is moved") {
+            ModelInstance *instance = model.objects.back()->instances.front();
+            instance->set_offset(instance->get_offset() + Vec3d(30., 30., 0.));
+            model.objects.back()->invalidate_bounding_box();
+            print.apply(model, config);
+            REQUIRE(! print.is_step_done(psGCodeExport));
+            Slic3r::Test::gcode(print);
+            THEN("the seam data of both objects is reused") {
+                REQUIRE(print.get_object(0)->seam_data().get() == seam_data);
+            }
+        }
+        WHEN("the seam position is changed") {
+            config.set_deserialize_strict("seam_position", "rear");
+            print.apply(model, config);
+            Slic3r::Test::gcode(print);
+            THEN("the seam data is recalculated") {
+                REQUIRE(print.get_object(0)->seam_data() != nullptr);
+                REQUIRE(print.get_object(0)->seam_data().get() != seam_data);
+            }
+        }
+        WHEN("the perimeters are invalidated") {
+            config.set_deserialize_strict("perimeters", "2");
+            print.apply(model, config);
+            THEN("the seam data is released") {
+                REQUIRE(print.get_object(0)->seam_data() == nullptr);
+            }
+        }
+    }
+}
@@ -266,3 +266,36 @@ SCENARIO("Original Slic3r Skirt/Brim tests", "[SkirtBrim]") {
         }
     }
 }
+
+TEST_CASE("Brim is regenerated from the cached footprints after an object is moved", "[SkirtBrim]") {
+    DynamicPrintConfig config = DynamicPrintConfig::full_print_config_with({
+        { "skirts",     0 },
+        { "brim_width", 5 }
+    });
+    Print print;
+    Model model;
+    Slic3r::Test::init_print({ TestMesh::cube_20x20x20, TestMesh::cube_20x20x20 }, print, model, config);
+    print.process();
+    const size_t footprint_key = print.objects().front()->brim_footprint().key;
+    REQUIRE(footprint_key != 0);
+    REQUIRE(! print.brim().empty());
+
+    ModelInstance *instance = model.objects.back()->instances.front();
+    instance->set_offset(instance->get_offset() + Vec3d(30., 30., 0.));
+    model.objects.back()->invalidate_bounding_box();
+    print.apply(model, config);
+    REQUIRE(! print.is_step_done(psSkirtBrim));
+    REQUIRE(print.objects().front()->is_step_done(posSlice));
+    print.process();
+    SECTION("the footprints are reused") {
+        REQUIRE(print.objects().front()->brim_footprint().key == footprint_key);
+    }
+    SECTION("the brim matches the brim of a print sliced from scratch") {
+        Print fresh;
+        fresh.apply(model, config);
+        fresh.set_status_silent();
+        fresh.process();
+        REQUIRE(print.brim().entities().size() == fresh.brim().entities().size());
+        REQUIRE(print.brim().total_volume() == Approx(fresh.brim().total_volume()));
+    }
+}
@@ -80,6 +80,45 @@ SCENARIO("Export+Import geometry to/from 3mf file cycle", "[3mf]") {
     }
 }
 
+SCENARIO("Export+Import of large meshes to/from 3mf file cycle", "[3mf]") {
+    GIVEN("model with several large objects") {
+        // Large enough for the model file to be written and parsed in parallel.
+        Model src_model;
+        for (double radius : { 10., 20., 30. }) {
+            ModelObject *object = src_model.add_object("sphere", "", TriangleMesh(its_make_sphere(radius, PI / 180.)));
+            object->add_instance();
+        }
+        for (int compression_level : { 0, 1, 9 }) {
+            WHEN("model is saved+loaded to/from 3mf file with compression level " + std::to_string(compression_level)) {
+                std::string test_file = std::string(TEST_DATA_DIR) + "/test_3mf/large.3mf";
+                bool stored = store_3mf(test_file.c_str(), &src_model, nullptr, OptionStore3mf{}.set_compression_level(compression_level));
+
+                Model dst_model;
+                DynamicPrintConfig dst_config;
+                bool loaded = false;
+                {
+                    ConfigSubstitutionContext ctxt{ ForwardCompatibilitySubstitutionRule::Disable };
+                    loaded = load_3mf(test_file.c_str(), dst_config, ctxt, &dst_model, false);
+                }
+                boost::filesystem::remove(test_file);
+
+                THEN("objects are loaded in order with the same meshes") {
+                    REQUIRE(stored);
+                    REQUIRE(loaded);
+                    REQUIRE(dst_model.objects.size() == src_model.objects.size());
+                    for (size_t i = 0; i < src_model.objects.size(); ++ i) {
+                        const indexed_triangle_set &src = src_model.objects[i]->volumes.front()->mesh().its;
+                        const indexed_triangle_set &dst = dst_model.objects[i]->volumes.front()->mesh().its;
+                        REQUIRE(dst.vertices.size() == src.vertices.size());
+                        REQUIRE(dst.indices.size() == src.indices.size());
+                        REQUIRE(dst_model.objects[i]->raw_mesh_bounding_box().size().isApprox(src_model.objects[i]->raw_mesh_bounding_box().size()));
+                    }
+                }
+            }
+        }
+    }
+}
+
 SCENARIO("2D convex hull of sinking object", "[3mf]") {
     GIVEN("model") {
         // load a model
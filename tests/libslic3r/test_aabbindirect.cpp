@@ -61,6 +61,70 @@ TEST_CASE("Building a tree over a box, ray caster and closest query", "[AABBIndi
     REQUIRE(closest_point.z() == Approx(1.));
 }
 
+TEST_CASE("Building a tree in parallel produces the same tree as building it serially", "[AABBIndirect]")
+{
+    // Enough triangles to build the top levels of the tree in parallel.
+    indexed_triangle_set its = its_make_sphere(10., PI / 200.);
+    REQUIRE(its.indices.size() > 4 * 16384);
+
+    AABBTreeIndirect::Tree3f serial;
+    tbb::task_arena(1).execute([&its, &serial]() {
+        serial = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(its.vertices, its.indices);
+    });
+    AABBTreeIndirect::Tree3f parallel = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(its.vertices, its.indices);
+
+    REQUIRE(serial.nodes().size() == parallel.nodes().size());
+    bool same = true;
+    for (size_t i = 0; i < serial.nodes().size(); ++ i) {
+        const auto &s = serial.node(i);
+        const auto &p = parallel.node(i);
+        if (s.idx != p.idx || (s.is_valid() && (s.bbox.min() != p.bbox.min() || s.bbox.max() != p.bbox.max())))
+            same = false;
+    }
+    REQUIRE(same);
+
+    igl::Hit hit;
+    REQUIRE(AABBTreeIndirect::intersect_ray_first_hit(its.vertices, its.indices, parallel, Vec3d(0., 0., -20.), Vec3d(0., 0., 1.), hit));
+    REQUIRE(hit.t == Approx(10.).epsilon(0.01));
+}
+
+TEST_CASE("Casting a bundle of rays gives the same hits as casting the rays one by one", "[AABBIndirect]")
+{
+    indexed_triangle_set its = its_make_sphere(1., PI / 30.);
+    its_merge(its, its_make_cube(1., 1., 1.));
+    auto tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(its.vertices, its.indices);
+
+    std::vector<Vec3d> origins;
+    std::vector<Vec3d> dirs;
+    for (int i = 0; i < 20; ++ i)
+        for (int j = 0; j < 20; ++ j) {
+            origins.emplace_back(0.1 * i - 1., 0.1 * j - 1., -3.);
+            dirs.emplace_back(Vec3d(0.02 * (j - i), 0.01 * i, 1.).normalized());
+        }
+    // Rays from a common origin in all directions.
+    for (int i = 0; i < 100; ++ i) {
+        origins.emplace_back(0.5, 0.5, 0.5);
+        dirs.emplace_back(Vec3d(std::cos(0.3 * i), std::sin(0.3 * i), std::cos(0.17 * i)).normalized());
+    }
+
+    std::vector<igl::Hit> hits;
+    size_t num_hits = AABBTreeIndirect::intersect_rays_first_hit(its.vertices, its.indices, tree, origins, dirs, hits);
+    REQUIRE(hits.size() == origins.size());
+    size_t num_hits_single = 0;
+    for (size_t i = 0; i < origins.size(); ++ i) {
+        igl::Hit hit;
+        bool intersected = AABBTreeIndirect::intersect_ray_first_hit(its.vertices, its.indices, tree, origins[i], dirs[i], hit);
+        REQUIRE(intersected == (hits[i].id != -1));
+        if (intersected) {
+            ++ num_hits_single;
+            REQUIRE(hit.id == hits[i].id);
+            REQUIRE(hit.t == hits[i].t);
+        }
+    }
+    REQUIRE(num_hits == num_hits_single);
+    REQUIRE(num_hits > 0);
+}
+
 TEST_CASE("Creating a several 2d lines, testing closest point query", "[AABBIndirect]")
 {
     std::vector<Linef> lines { };
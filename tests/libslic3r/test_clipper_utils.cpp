@@ -415,3 +415,51 @@ TEST_CASE("Traversing Clipper PolyTree", "[ClipperUtils]") {
         REQUIRE(count_polys(output) == reference.size());
     }
 }
+
+SCENARIO("Clipper boolean operations with disjoint bounding boxes", "[ClipperUtils]") {
+    GIVEN("two squares far apart") {
+        Slic3r::Polygon square_left  { Point::new_scale(0, 0),  Point::new_scale(10, 0),  Point::new_scale(10, 10), Point::new_scale(0, 10) };
+        Slic3r::Polygon square_right { Point::new_scale(20, 0), Point::new_scale(30, 0),  Point::new_scale(30, 10), Point::new_scale(20, 10) };
+        WHEN("intersection_ex") {
+            THEN("result is empty") {
+                REQUIRE(intersection_ex(Polygons{ square_left }, Polygons{ square_right }).empty());
+                REQUIRE(intersection(Polygons{ square_left }, Polygons{ square_right }, ApplySafetyOffset::Yes).empty());
+            }
+        }
+        WHEN("diff_ex") {
+            ExPolygons result = diff_ex(Polygons{ square_left }, Polygons{ square_right });
+            THEN("subject is returned unchanged") {
+                REQUIRE(result.size() == 1);
+                REQUIRE(result.front().holes.empty());
+                REQUIRE(result.front().area() == Approx(square_left.area()));
+            }
+        }
+        WHEN("diff_ex with overlapping subject polygons") {
+            Slic3r::Polygon square_left2 = square_left;
+            square_left2.translate(Point::new_scale(5, 0));
+            ExPolygons result = diff_ex(Polygons{ square_left, square_left2 }, Polygons{ square_right });
+            THEN("subject is merged by the fill rule") {
+                REQUIRE(result.size() == 1);
+                REQUIRE(result.front().area() == Approx(scale_(15.) * scale_(10.)));
+            }
+        }
+    }
+    GIVEN("a frame around a square with overlapping bounding boxes") {
+        Slic3r::Polygon frame_outer { Point::new_scale(0, 0),  Point::new_scale(30, 0), Point::new_scale(30, 30), Point::new_scale(0, 30) };
+        Slic3r::Polygon frame_inner { Point::new_scale(5, 5),  Point::new_scale(5, 25), Point::new_scale(25, 25), Point::new_scale(25, 5) };
+        Slic3r::Polygon square      { Point::new_scale(10, 10), Point::new_scale(20, 10), Point::new_scale(20, 20), Point::new_scale(10, 20) };
+        WHEN("intersection_ex") {
+            THEN("result is empty") {
+                REQUIRE(intersection_ex(Polygons{ frame_outer, frame_inner }, Polygons{ square }).empty());
+            }
+        }
+        WHEN("diff_ex") {
+            ExPolygons result = diff_ex(Polygons{ frame_outer, frame_inner }, Polygons{ square });
+            THEN("frame is returned unchanged") {
+                REQUIRE(result.size() == 1);
+                REQUIRE(result.front().holes.size() == 1);
+                REQUIRE(result.front().area() == Approx(frame_outer.area() + frame_inner.area()));
+            }
+        }
+    }
+}
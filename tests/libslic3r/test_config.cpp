@@ -4,6 +4,7 @@
 #include "libslic3r/PrintConfig.hpp"
 #include "libslic3r/LocalesUtils.hpp"#include "libslic3r/Model.hpp"
 #include "libslic3r/Print.hpp"
+#include "libslic3r/ConfigBundleCache.hpp"
 #include <test_data.hpp>
 
 #include <cereal/types/polymorphic.hpp>
@@ -11,6 +12,11 @@
 #include <cereal/types/vector.hpp> 
 #include <cereal/archives/binary.hpp>
 
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <boost/property_tree/ini_parser.hpp>
+
 using namespace Slic3r;
 using namespace Slic3r::Test;
 
@@ -499,3 +505,59 @@ SCENARIO("DynamicPrintConfig serialization", "[Config]") {
         }
     }
 }
+
+TEST_CASE("Config bundle cache", "[Config]") {
+    namespace fs = boost::filesystem;
+    const fs::path bundle_path = fs::temp_directory_path() / fs::unique_path("bundle-%%%%-%%%%.ini");
+    const fs::path cache_path  = fs::temp_directory_path() / fs::unique_path("bundle-%%%%-%%%%.bin");
+    auto write_bundle = [&bundle_path](const std::string &layer_height) {
+        boost::nowide::ofstream ofs(bundle_path.string());
+        ofs << "[vendor]\nname = Test\n\n[print:*common*]\nperimeters = 2\n\n"
+               "[print:0.2mm]\ninherits = *common*\nlayer_height = " << layer_height << "\n";
+    };
+    write_bundle("0.2");
+    boost::property_tree::ptree tree;
+    boost::property_tree::read_ini(bundle_path.string(), tree);
+
+    boost::property_tree::ptree loaded;
+    REQUIRE(! load_config_bundle_cache(cache_path, bundle_path, loaded));
+    save_config_bundle_cache(cache_path, bundle_path, tree);
+    SECTION("the cache is loaded while the bundle does not change") {
+        REQUIRE(load_config_bundle_cache(cache_path, bundle_path, loaded));
+        REQUIRE(loaded == tree);
+    }
+    SECTION("the cache is loaded if the bundle was touched only") {
+        fs::last_write_time(bundle_path, fs::last_write_time(bundle_path) + 10);
+        REQUIRE(load_config_bundle_cache(cache_path, bundle_path, loaded));
+        REQUIRE(loaded == tree);
+        SECTION("the new modification time is stored into the cache") {
+            // A change of the same size keeping the stored modification time is not detected, the bundle is not hashed again.
+            const std::time_t mtime = fs::last_write_time(bundle_path);
+            write_bundle("0.3");
+            fs::last_write_time(bundle_path, mtime);
+            boost::property_tree::ptree reloaded;
+            REQUIRE(load_config_bundle_cache(cache_path, bundle_path, reloaded));
+            REQUIRE(reloaded == tree);
+        }
+    }
+    SECTION("the cache is invalidated by a change of the bundle") {
+        write_bundle("0.1");
+        fs::last_write_time(bundle_path, fs::last_write_time(bundle_path) + 10);
+        REQUIRE(! load_config_bundle_cache(cache_path, bundle_path, loaded));
+        REQUIRE(loaded.empty());
+    }
+    fs::remove(bundle_path);
+    fs::remove(cache_path);
+}
+
+TEST_CASE("Config bundle cache path", "[Config]") {
+    namespace fs = boost::filesystem;
+    const fs::path cache_dir = fs::path("cache") / "bundles";
+    const fs::path path1     = config_bundle_cache_path(cache_dir, fs::path("vendor") / "PrusaResearch.ini");
+    const fs::path path2     = config_bundle_cache_path(cache_dir, fs::path("resources") / "profiles" / "PrusaResearch.ini");
+    REQUIRE(path1.parent_path() == cache_dir);
+    REQUIRE(boost::starts_with(path1.filename().string(), "PrusaResearch-"));
+    REQUIRE(path1.extension() == ".bin");
+    REQUIRE(path1 != path2);
+    REQUIRE(path1 == config_bundle_cache_path(cache_dir, fs::path("vendor") / "PrusaResearch.ini"));
+}
@@ -17,6 +17,7 @@
 
 #include "../data/prusaparts.hpp"
 
+#include <random>
 #include <unordered_set>
 
 using namespace Slic3r;
@@ -581,6 +582,64 @@ SCENARIO("Path chaining", "[Geometry][!mayfail]") {
 	}
 }
 
+static double chain_travel(const Polylines &chained)
+{
+	double travel = 0.;
+	for (size_t i = 1; i < chained.size(); ++ i)
+		travel += (chained[i].first_point() - chained[i - 1].last_point()).cast<double>().norm();
+	return travel;
+}
+
+SCENARIO("Path chaining of a huge collection", "[Geometry]") {
+	GIVEN("A grid of short segments in a random order") {
+		// Short horizontal segments 1mm long, 2mm apart horizontally, 1mm apart vertically.
+		const int cols = 100;
+		const int rows = 60;
+		Polylines polylines;
+		for (int row = 0; row < rows; ++ row)
+			for (int col = 0; col < cols; ++ col)
+				polylines.push_back(Polyline{ Point::new_scale(2. * col, row), Point::new_scale(2. * col + 1., row) });
+		// Travel of the serpentine ordering of the grid.
+		double serpentine_travel = (rows * (cols - 1) + rows - 1) * scale_(1.);
+		std::shuffle(polylines.begin(), polylines.end(), std::mt19937(867092346));
+		const size_t num_points = polylines.size() * 2;
+
+		const Polylines chained = chain_polylines(Polylines(polylines));
+		THEN("All polylines are chained") {
+			REQUIRE(chained.size() == polylines.size());
+			size_t num_points_chained = 0;
+			for (const Polyline &pl : chained)
+				num_points_chained += pl.size();
+			REQUIRE(num_points_chained == num_points);
+		}
+		THEN("Travel is comparable to the serpentine ordering") {
+			REQUIRE(chain_travel(chained) < 2. * serpentine_travel);
+		}
+		THEN("Travel is comparable to chaining the whole collection at once") {
+			REQUIRE(chain_travel(chained) < 1.1 * chain_travel(chain_polylines_unpartitioned(Polylines(polylines))));
+		}
+	}
+	GIVEN("Four distant clusters of short segments in a random order, leaving the grid cells between them empty") {
+		Polylines polylines;
+		for (int cluster = 0; cluster < 4; ++ cluster) {
+			const double x0 = 200. * (cluster % 2);
+			const double y0 = 200. * (cluster / 2);
+			for (int row = 0; row < 32; ++ row)
+				for (int col = 0; col < 35; ++ col)
+					polylines.push_back(Polyline{ Point::new_scale(x0 + 2. * col, y0 + row), Point::new_scale(x0 + 2. * col + 1., y0 + row) });
+		}
+		std::shuffle(polylines.begin(), polylines.end(), std::mt19937(867092346));
+
+		const Polylines chained = chain_polylines(Polylines(polylines));
+		THEN("All polylines are chained") {
+			REQUIRE(chained.size() == polylines.size());
+		}
+		THEN("Travel is comparable to chaining the whole collection at once") {
+			REQUIRE(chain_travel(chained) < 1.1 * chain_travel(chain_polylines_unpartitioned(Polylines(polylines))));
+		}
+	}
+}
+
 SCENARIO("Line distances", "[Geometry]"){
     GIVEN("A line"){
         Line line(Point(0, 0), Point(20, 0));
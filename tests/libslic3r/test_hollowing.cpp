@@ -3,6 +3,7 @@
 #include <catch2/catch.hpp>
 
 #include "libslic3r/SLA/Hollowing.hpp"
+#include "libslic3r/TriangleMeshSlicer.hpp"
 
 TEST_CASE("Hollow two overlapping spheres") {
     using namespace Slic3r;
@@ -19,3 +20,59 @@ TEST_CASE("Hollow two overlapping spheres") {
     sphere1.WriteOBJFile("twospheres.obj");
 }
 
+
+// Largest distance of the contour vertices of a from the contours of b, unscaled.
+static double max_distance(const Slic3r::ExPolygons &a, const Slic3r::ExPolygons &b)
+{
+    using namespace Slic3r;
+
+    const Lines lines = to_lines(b);
+    double      dmax  = 0.;
+    for (const Point &pt : to_points(a)) {
+        double d = std::numeric_limits<double>::max();
+        for (const Line &line : lines)
+            d = std::min(d, double(line.distance_to(pt)));
+        dmax = std::max(dmax, d);
+    }
+    return unscaled(dmax);
+}
+
+TEST_CASE("Interior sliced from its grid matches the slices of the interior mesh") {
+    using namespace Slic3r;
+
+    TriangleMesh sphere = make_sphere(10., 2 * PI / 40.);
+
+    sla::InteriorPtr interior = sla::generate_interior(sphere.its);
+    REQUIRE(interior);
+
+    const indexed_triangle_set &interior_mesh = sla::get_mesh(*interior);
+    REQUIRE(! interior_mesh.empty());
+
+    std::vector<float> zs { -9.f, -6.f, -3.f, 0.f, 3.f, 6.f, 9.f };
+    std::vector<ExPolygons> from_mesh = slice_mesh_ex(interior_mesh, zs, MeshSlicingParamsEx{});
+    std::vector<ExPolygons> from_grid = sla::slice_interior(*interior, zs);
+
+    REQUIRE(from_grid.size() == zs.size());
+
+    const double voxel_size = 1. / get_voxel_scale(sla::get_grid(*interior));
+    for (size_t i = 0; i < zs.size(); ++ i) {
+        double area_mesh = 0., area_grid = 0.;
+        for (const ExPolygon &expoly : from_mesh[i]) area_mesh += expoly.area();
+        for (const ExPolygon &expoly : from_grid[i]) area_grid += expoly.area();
+        area_mesh *= SCALING_FACTOR * SCALING_FACTOR;
+        area_grid *= SCALING_FACTOR * SCALING_FACTOR;
+
+        if (area_mesh == 0.) {
+            REQUIRE(area_grid < 2 * PI * voxel_size);
+            continue;
+        }
+
+        // Within one voxel around the perimeter of the mesh slice.
+        double perimeter = 2. * std::sqrt(PI * area_mesh);
+        REQUIRE(std::abs(area_grid - area_mesh) < perimeter * voxel_size);
+
+        // The contours are interpolated from the sampled field, they don't snap to the voxel lattice.
+        REQUIRE(max_distance(from_grid[i], from_mesh[i]) < 0.5 * voxel_size);
+        REQUIRE(max_distance(from_mesh[i], from_grid[i]) < 0.5 * voxel_size);
+    }
+}
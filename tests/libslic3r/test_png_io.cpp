@@ -9,6 +9,9 @@
 #include "libslic3r/PNGReadWrite.hpp"
 #include "libslic3r/SLA/AGGRaster.hpp"
 #include "libslic3r/BoundingBox.hpp"
+#include "libslic3r/ExPolygon.hpp"
+
+#include <qoi/qoi.h>
 
 using namespace Slic3r;
 
@@ -56,3 +59,70 @@ TEST_CASE("PNG read", "[PNG]") {
         REQUIRE(sum == rstsum);
     }
 }
+
+TEST_CASE("Raster encoders round trip an anti-aliased raster", "[PNG]") {
+    // Anti-aliased circle of radius 30 pixels in the middle of a raster, with an empty margin.
+    sla::RasterBase::Trafo trafo;
+    trafo.center_x = scaled(60.);
+    trafo.center_y = scaled(40.);
+    sla::RasterGrayscaleAA rst{{121, 80}, {1., 1.}, trafo, agg::gamma_none()};
+    Polygon circle;
+    for (size_t i = 0; i < 360; ++ i)
+        circle.points.emplace_back(scaled(30. * cos(2. * PI * i / 360.)), scaled(30. * sin(2. * PI * i / 360.)));
+    rst.draw(ExPolygon(circle));
+
+    const size_t w = rst.resolution().width_px;
+    const size_t h = rst.resolution().height_px;
+    std::vector<uint8_t> pixels;
+    for (size_t r = 0; r < h; ++ r)
+        for (size_t c = 0; c < w; ++ c)
+            pixels.emplace_back(rst.read_pixel(c, r));
+    REQUIRE(std::count(pixels.begin(), pixels.end(), 255) > 0);
+    REQUIRE(std::count_if(pixels.begin(), pixels.end(), [](uint8_t px) { return px > 0 && px < 255; }) > 0);
+
+    for (int level : { 0, 1, 2, 6, 9 }) {
+        INFO("Compression level " << level);
+        sla::EncodedRaster enc_rst = rst.encode(sla::PNGRasterEncoder{level});
+        REQUIRE(Slic3r::png::is_png({enc_rst.data(), enc_rst.size()}));
+
+        png::ImageGreyscale img;
+        REQUIRE(png::decode_png({enc_rst.data(), enc_rst.size()}, img));
+        REQUIRE(img.rows == h);
+        REQUIRE(img.cols == w);
+        REQUIRE(img.buf == pixels);
+    }
+
+    SECTION("QOI") {
+        sla::EncodedRaster enc_rst = rst.encode(sla::QOIRasterEncoder{});
+        qoi_desc desc;
+        auto *rgb = static_cast<uint8_t*>(qoi_decode(enc_rst.data(), int(enc_rst.size()), &desc, 3));
+        REQUIRE(rgb != nullptr);
+        REQUIRE(desc.width == w);
+        REQUIRE(desc.height == h);
+        bool same = true;
+        for (size_t i = 0; i < pixels.size(); ++ i)
+            same &= rgb[3 * i] == pixels[i] && rgb[3 * i + 1] == pixels[i] && rgb[3 * i + 2] == pixels[i];
+        free(rgb);
+        REQUIRE(same);
+    }
+
+    SECTION("RLE") {
+        sla::EncodedRaster enc_rst = rst.encode(sla::RLERasterEncoder{});
+        const auto *data = static_cast<const uint8_t*>(enc_rst.data());
+        const auto *end  = data + enc_rst.size();
+        REQUIRE(data[0] + (data[1] << 8) == int(w));
+        REQUIRE(data[4] + (data[5] << 8) == int(h));
+        std::vector<uint8_t> decoded;
+        for (data += 8; data < end;) {
+            uint8_t value = *data ++;
+            size_t  len   = 0;
+            for (int shift = 0; data < end; shift += 7) {
+                len |= size_t(*data & 0x7f) << shift;
+                if ((*data ++ & 0x80) == 0)
+                    break;
+            }
+            decoded.insert(decoded.end(), len, value);
+        }
+        REQUIRE(decoded == pixels);
+    }
+}
@@ -0,0 +1,72 @@
+#include <catch2/catch.hpp>
+
+#include <libslic3r/ClipperUtils.hpp>
+#include <libslic3r/ExPolygon.hpp>
+#include <libslic3r/Point.hpp>
+
+using namespace Slic3r;
+
+static Polygons make_squares()
+{
+    Polygons squares;
+    for (coord_t i = 0; i < 10; ++ i) {
+        const coord_t x = scaled<coord_t>(20. * i), size = scaled<coord_t>(10.);
+        squares.push_back(Polygon{ { x, 0 }, { x + size, 0 }, { x + size, size }, { x, size } });
+    }
+    return squares;
+}
+
+TEST_CASE("Point vectors are served by the arena inside a scope", "[PointsAllocator]")
+{
+    Points outside(10);
+    REQUIRE(! PointsArena::owns(outside.data()));
+
+    Polygons results;
+    Polygons reference = offset(make_squares(), float(scaled(1.)));
+    {
+        PointsArenaScope arena;
+        Points temporary(10);
+        REQUIRE(PointsArena::owns(temporary.data()));
+
+        Polygons offsetted = offset(make_squares(), float(scaled(1.)));
+        REQUIRE(! offsetted.empty());
+        REQUIRE(PointsArena::owns(offsetted.front().points.data()));
+
+        arena.stop();
+        // Vectors allocated after stop() are served by the heap, the arena memory is still valid.
+        results = offsetted;
+        REQUIRE(! PointsArena::owns(results.front().points.data()));
+        REQUIRE(results == offsetted);
+    }
+    // The results survive the release of the arena.
+    REQUIRE(results == reference);
+
+    Points after(10);
+    REQUIRE(! PointsArena::owns(after.data()));
+}
+
+TEST_CASE("Nested arena scope does not release the arena of the outer scope", "[PointsAllocator]")
+{
+    PointsArenaScope arena;
+    Points outer(10, Point(1, 2));
+    {
+        PointsArenaScope nested;
+        Points inner(10);
+        REQUIRE(PointsArena::owns(inner.data()));
+        nested.stop();
+        Points still_arena(10);
+        REQUIRE(PointsArena::owns(still_arena.data()));
+    }
+    Points next(10, Point(3, 4));
+    REQUIRE(PointsArena::owns(outer.data()));
+    REQUIRE(PointsArena::owns(next.data()));
+    REQUIRE(outer == Points(10, Point(1, 2)));
+    REQUIRE(next == Points(10, Point(3, 4)));
+}
+
+TEST_CASE("Large point vectors are not served by the arena", "[PointsAllocator]")
+{
+    PointsArenaScope arena;
+    Points large(1024 * 1024);
+    REQUIRE(! PointsArena::owns(large.data()));
+}
@@ -239,6 +239,24 @@ TEST_CASE("Simplify frog_legs.obj to 5% by Quadric edge collapse", "[its][quadri
     Private::is_better_similarity(mesh.its, its, Private::frog_leg_5);
 }
 
+TEST_CASE("Simplify frog_legs.obj to 5% by parallel Quadric edge collapse", "[its][quadric_edge_collapse]")
+{
+    TriangleMesh mesh            = load_model("frog_legs.obj");
+    double       original_volume = its_volume(mesh.its);
+    uint32_t     wanted_count    = mesh.its.indices.size() * 0.05;
+    REQUIRE_FALSE(mesh.empty());
+    indexed_triangle_set its       = mesh.its; // copy
+    float                max_error = std::numeric_limits<float>::max();
+    size_t               partition_count = 4;
+    its_quadric_edge_collapse_parallel(its, wanted_count, &max_error, nullptr, nullptr, partition_count);
+    CHECK(its.indices.size() <= wanted_count);
+    double volume = its_volume(its);
+    CHECK(fabs(original_volume - volume) < 33.);
+    // borders of partitions are stitched back together
+    CHECK(its_num_open_edges(its) <= its_num_open_edges(mesh.its));
+    CHECK(!Private::exist_triangle_with_twice_vertices(its.indices));
+}
+
 #include <libigl/igl/qslim.h>
 TEST_CASE("Simplify frog_legs.obj to 5% by IGL/qslim", "[]")
 {
@@ -1,7 +1,14 @@
 #include <catch2/catch.hpp>
 
+#include <boost/filesystem/operations.hpp>
+
 #include "libslic3r/Model.hpp"
+#include "libslic3r/TriangleMesh.hpp"
 #include "libslic3r/Format/STL.hpp"
+#include "libslic3r/Format/OBJ.hpp"
+#include "libslic3r/Format/objparser.hpp"
+
+#include <fstream>
 
 using namespace Slic3r;
 
@@ -55,3 +62,77 @@ SCENARIO("Reading an STL file", "[stl]") {
 		}
 	}
 }
+
+SCENARIO("Reading large mesh files in parallel", "[stl][obj]") {
+	// Large enough for the memory mapped parallel loaders.
+	TriangleMesh sphere(its_make_sphere(10., PI / 360.));
+	REQUIRE(sphere.facets_count() > 65536);
+	const std::string tmp = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+	GIVEN("binary STL file") {
+		const std::string path = tmp + ".stl";
+		REQUIRE(its_write_stl_binary(path.c_str(), "sphere", sphere.its));
+		TriangleMesh mesh;
+		REQUIRE(mesh.ReadSTLFile(path.c_str()));
+		boost::filesystem::remove(path);
+		THEN("the mesh is loaded completely") {
+			REQUIRE(mesh.facets_count() == sphere.facets_count());
+			REQUIRE(mesh.its.vertices.size() == sphere.its.vertices.size());
+			REQUIRE(is_approx(mesh.stats().size, sphere.stats().size));
+			REQUIRE(mesh.stats().open_edges == 0);
+			REQUIRE(mesh.volume() == Approx(sphere.volume()));
+		}
+	}
+	GIVEN("OBJ file") {
+		const std::string path = tmp + ".obj";
+		REQUIRE(its_write_obj(sphere.its, path.c_str()));
+		REQUIRE(boost::filesystem::file_size(path) > 4 * 1024 * 1024);
+		TriangleMesh mesh;
+		REQUIRE(load_obj(path.c_str(), &mesh));
+		boost::filesystem::remove(path);
+		THEN("the mesh is loaded completely") {
+			REQUIRE(mesh.facets_count() == sphere.facets_count());
+			REQUIRE(mesh.its.vertices.size() == sphere.its.vertices.size());
+			REQUIRE(mesh.volume() == Approx(sphere.volume()).epsilon(1e-4));
+		}
+	}
+	GIVEN("OBJ file with relative face indices and long lines") {
+		// The long lines straddle the boundaries of the chunks parsed in parallel,
+		// the faces reference the vertices relatively, often across these boundaries.
+		const std::string path = tmp + ".obj";
+		{
+			std::ofstream out(path, std::ios::binary);
+			for (int i = 0; i < 60000; ++ i) {
+				if (i % 197 == 0)
+					out << "# " << std::string(1000 + (i * 7919) % 60000, 'x') << "\n";
+				if (i % 1009 == 0)
+					out << "o " << std::string(1000 + (i * 131) % 30000, 'o') << "\n";
+				if (i % 1013 == 0)
+					out << "g " << std::string(1000 + (i * 137) % 30000, 'g') << "\n";
+				out << "v" << std::string(1 + (i % 997 == 0 ? 40000 : i % 5), ' ') << i << " " << i % 17 << " " << i % 23 << "\n";
+				if (i >= 2) {
+					if (i % 3 == 0)
+						out << "f -3 -2 -1\n";
+					else if (i % 3 == 1)
+						// Mix in the absolute indices.
+						out << "f " << i - 1 << " -2 " << i + 1 << "\n";
+				}
+			}
+		}
+		REQUIRE(boost::filesystem::file_size(path) > 4 * 1024 * 1024);
+		ObjParser::ObjData mapped, serial;
+		REQUIRE(ObjParser::objparse(path.c_str(), mapped));
+		{
+			std::ifstream in(path, std::ios::binary);
+			REQUIRE(ObjParser::objparse(in, serial));
+		}
+		boost::filesystem::remove(path);
+		THEN("the chunked parser matches the serial one") {
+			REQUIRE(mapped.coordinates.size() == 60000 * 4);
+			REQUIRE(mapped.coordinates == serial.coordinates);
+			REQUIRE(mapped.vertices.size() == serial.vertices.size());
+			REQUIRE(mapped.vertices == serial.vertices);
+			REQUIRE(mapped.objects == serial.objects);
+			REQUIRE(mapped.groups == serial.groups);
+		}
+	}
+}
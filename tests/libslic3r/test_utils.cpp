@@ -1,6 +1,8 @@
 #include <catch2/catch.hpp>
 
 #include "libslic3r/libslic3r.h"
+#include "libslic3r/Exception.hpp"
+#include "libslic3r/Utils.hpp"
 
 SCENARIO("Test fast_round_up()") {
     using namespace Slic3r;
@@ -33,3 +35,28 @@ SCENARIO("Test fast_round_up()") {
         REQUIRE(fast_round_up<int>(-1.51) == -2);
     }
 }
+
+SCENARIO("Split a batch command line into arguments", "[Utils]") {
+    using namespace Slic3r;
+    using Args = std::vector<std::string>;
+
+    THEN("Windows paths keep their backslashes") {
+        REQUIRE(split_command_line("--export-gcode C:\\models\\a.stl") == Args{ "--export-gcode", "C:\\models\\a.stl" });
+    }
+    THEN("Repeated white space does not produce empty arguments") {
+        REQUIRE(split_command_line("  -g \t a.stl  ") == Args{ "-g", "a.stl" });
+    }
+    THEN("Double and single quotes group white space") {
+        REQUIRE(split_command_line("-o \"out dir/a.gcode\" 'my model.stl'") == Args{ "-o", "out dir/a.gcode", "my model.stl" });
+    }
+    THEN("Quotes are joined with the adjacent characters and may nest the other quote") {
+        REQUIRE(split_command_line("--output=\"C:\\my dir\"\\a.gcode 'say \"hi\"'") == Args{ "--output=C:\\my dir\\a.gcode", "say \"hi\"" });
+    }
+    THEN("Empty quotes produce an empty argument") {
+        REQUIRE(split_command_line("--post-process \"\"") == Args{ "--post-process", "" });
+    }
+    THEN("An unterminated quote is reported as an error") {
+        REQUIRE_THROWS_AS(split_command_line("-g \"unterminated a.stl"), Slic3r::RuntimeError);
+        REQUIRE_THROWS_AS(split_command_line("-g 'a.stl"), Slic3r::RuntimeError);
+    }
+}
@@ -6,7 +6,13 @@
 #include "libslic3r/Format/SLAArchiveFormatRegistry.hpp"
 #include "libslic3r/Format/SLAArchiveWriter.hpp"
 #include "libslic3r/Format/SLAArchiveReader.hpp"
+#include "libslic3r/miniz_extension.hpp"
 
+#include <fstream>
+#include <iterator>
+#include <map>
+
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/filesystem.hpp>
 
 using namespace Slic3r;
@@ -68,3 +74,69 @@ TEST_CASE("Archive export test", "[sla_archives]") {
         }
     }
 }
+
+// Layer images of a zip archive by their entry names, empty if the file is not a zip archive.
+static std::map<std::string, std::string> read_layer_images(const std::string &fname)
+{
+    std::map<std::string, std::string> images;
+    mz_zip_archive zip;
+    mz_zip_zero_struct(&zip);
+    if (! open_zip_reader(&zip, fname))
+        return images;
+    for (mz_uint i = 0; i < mz_zip_reader_get_num_files(&zip); ++ i) {
+        mz_zip_archive_file_stat stat;
+        REQUIRE(mz_zip_reader_file_stat(&zip, i, &stat));
+        if (boost::ends_with(stat.m_filename, ".png") || boost::ends_with(stat.m_filename, ".svg")) {
+            std::string data(size_t(stat.m_uncomp_size), 0);
+            REQUIRE(mz_zip_reader_extract_to_mem(&zip, i, data.data(), data.size(), 0));
+            images[stat.m_filename] = std::move(data);
+        }
+    }
+    close_zip_reader(&zip);
+    return images;
+}
+
+static std::string read_file(const std::string &fname)
+{
+    std::ifstream in(fname, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+TEST_CASE("Archive exported with streamed rasterization matches the in-memory one", "[sla_archives]") {
+    for (const auto &[format, entry] : registered_sla_archives()) {
+        INFO(std::string("Testing archive type: ") + entry.id);
+        auto m = Model::read_from_file(TEST_DATA_DIR PATH_SEPARATOR + std::string("20mm_cube.obj"), nullptr);
+
+        SLAFullPrintConfig fullcfg;
+        fullcfg.printer_technology.value = ptSLA;
+        fullcfg.output_format.value = format;
+        fullcfg.set("supports_enable", false);
+        fullcfg.set("pad_enable", false);
+
+        DynamicPrintConfig cfg;
+        cfg.apply(fullcfg);
+
+        std::string outputfnames[2];
+        for (bool streaming : { false, true }) {
+            SLAPrint print;
+            print.set_force_raster_streaming(streaming);
+            print.set_status_callback([](const PrintBase::SlicingStatus&) {});
+            print.apply(m, cfg);
+            print.process();
+
+            outputfnames[streaming] = std::string("output_streaming") + std::to_string(int(streaming)) + "." + entry.ext;
+            print.export_print(outputfnames[streaming], ThumbnailsList{}, "20mm_cube");
+            REQUIRE(boost::filesystem::exists(outputfnames[streaming]));
+        }
+
+        std::map<std::string, std::string> images[2] = { read_layer_images(outputfnames[0]), read_layer_images(outputfnames[1]) };
+        if (images[0].empty()) {
+            // Not a zip archive, the binary formats do not store the time of export.
+            REQUIRE(read_file(outputfnames[0]) == read_file(outputfnames[1]));
+        } else {
+            // Zip archives store the time of export, thus compare the layer images only.
+            REQUIRE(images[0].size() > 1);
+            REQUIRE(images[0] == images[1]);
+        }
+    }
+}
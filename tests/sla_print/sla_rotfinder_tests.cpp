@@ -0,0 +1,125 @@
+#include <catch2/catch.hpp>
+#include <test_utils.hpp>
+
+#include <libslic3r/Geometry.hpp>
+#include <libslic3r/Model.hpp>
+#include <libslic3r/PrintConfig.hpp>
+#include <libslic3r/SLA/Rotfinder.hpp>
+
+using namespace Slic3r;
+
+namespace {
+
+// Box of 40 x 20 x 5 mm tilted around the X and Y axes.
+TriangleMesh make_tilted_box()
+{
+    TriangleMesh mesh = make_cube(40., 20., 5.);
+    mesh.rotate_x(0.4f);
+    mesh.rotate_y(0.3f);
+    return mesh;
+}
+
+// Tilted box with a sphere attached off center, so that the scores of the
+// rotations don't tie. Has enough facets to be scored in several blocks.
+TriangleMesh make_tilted_box_with_sphere()
+{
+    TriangleMesh mesh   = make_cube(40., 20., 5.);
+    TriangleMesh sphere = make_sphere(8., PI / 64.);
+    sphere.translate(30.f, 5.f, 8.f);
+    mesh.merge(sphere);
+    mesh.rotate_x(0.4f);
+    mesh.rotate_y(0.3f);
+    return mesh;
+}
+
+ModelObject *add_object(Model &model, const TriangleMesh &mesh)
+{
+    ModelObject *mo = model.add_object();
+    mo->add_volume(mesh);
+    mo->add_instance();
+    return mo;
+}
+
+// The rotation returned by the Rotfinder is applied as the instance rotation,
+// the rotation around X first.
+Transform3d rotation_transform(const Vec2d &rot)
+{
+    return Geometry::rotation_transform(Vec3d{rot.x(), rot.y(), 0.});
+}
+
+double rotated_height(const ModelObject &mo, const Vec2d &rot)
+{
+    TriangleMesh mesh = mo.raw_mesh();
+    mesh.transform(rotation_transform(rot));
+    return mesh.bounding_box().size().z();
+}
+
+DynamicPrintConfig on_floor_config()
+{
+    DynamicPrintConfig cfg;
+    cfg.set_key_value("support_object_elevation", new ConfigOptionFloat(0.));
+    return cfg;
+}
+
+} // namespace
+
+TEST_CASE("Minimum Z height rotation lays a tilted box flat", "[Rotfinder]")
+{
+    Model        model;
+    ModelObject *mo = add_object(model, make_tilted_box());
+
+    Vec2d rot = sla::find_min_z_height_rotation(*mo);
+
+    REQUIRE(rotated_height(*mo, rot) == Approx(5.).margin(0.01));
+}
+
+TEST_CASE("Least supports rotation lays a tilted box flat on the floor", "[Rotfinder]")
+{
+    Model        model;
+    ModelObject *mo = add_object(model, make_tilted_box());
+
+    DynamicPrintConfig cfg = on_floor_config();
+    Vec2d rot = sla::find_least_supports_rotation(*mo, sla::RotOptimizeParams{}.print_config(&cfg));
+
+    REQUIRE(rotated_height(*mo, rot) == Approx(5.).margin(0.01));
+}
+
+TEST_CASE("Best misalignment rotation turns the faces of a box away from the axes", "[Rotfinder]")
+{
+    Model        model;
+    ModelObject *mo = add_object(model, make_cube(40., 20., 5.));
+
+    Vec2d rot = sla::find_best_misalignment_rotation(*mo);
+
+    // The largest face of the box weighs the most, its normal shall not be
+    // aligned with any of the axes.
+    Vec3d n = rotation_transform(rot).linear() * Vec3d::UnitZ();
+    REQUIRE(n.cwiseAbs().maxCoeff() < 0.9);
+}
+
+TEST_CASE("Early exit of the rotation scoring finds the same rotation as the exhaustive scoring", "[Rotfinder]")
+{
+    Model        model;
+    ModelObject *mo = add_object(model, make_tilted_box_with_sphere());
+
+    DynamicPrintConfig on_floor = on_floor_config();
+    auto params     = [](const DynamicPrintConfig *cfg) { return sla::RotOptimizeParams{}.print_config(cfg); };
+    auto exhaustive = [](const DynamicPrintConfig *cfg) { return sla::RotOptimizeParams{}.print_config(cfg).early_exit(false); };
+
+    SECTION("misalignment") {
+        REQUIRE(sla::find_best_misalignment_rotation(*mo, params(nullptr)) ==
+                sla::find_best_misalignment_rotation(*mo, exhaustive(nullptr)));
+    }
+    SECTION("least supports, elevated") {
+        REQUIRE(sla::find_least_supports_rotation(*mo, params(nullptr)) ==
+                sla::find_least_supports_rotation(*mo, exhaustive(nullptr)));
+    }
+    SECTION("least supports, on the floor") {
+        REQUIRE(sla::find_least_supports_rotation(*mo, params(&on_floor)) ==
+                sla::find_least_supports_rotation(*mo, exhaustive(&on_floor)));
+    }
+    SECTION("minimum Z height") {
+        REQUIRE(sla::find_min_z_height_rotation(*mo, params(nullptr)) ==
+                sla::find_min_z_height_rotation(*mo, exhaustive(nullptr)));
+    }
+}
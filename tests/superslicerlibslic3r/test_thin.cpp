@@ -519,3 +519,45 @@ SCENARIO("thin walls: ")
     }
 
 }
+
+SCENARIO("medial axis cache") {
+    GIVEN("the same gap fill area on two layers") {
+        ExPolygon expolygon;
+        expolygon.contour = Slic3r::Polygon{ Points{
+            Point::new_scale(-0.5, 0),
+            Point::new_scale(0.5, 0),
+            Point::new_scale(0.3, 10),
+            Point::new_scale(-0.3, 10) } };
+        MedialAxis::clear_cache();
+        ThickPolylines reference;
+        MedialAxis{ expolygon, scale_t(1.1), scale_t(0.5), scale_t(0.2) }.build(reference);
+        ThickPolylines first;
+        MedialAxis{ expolygon, scale_t(1.1), scale_t(0.5), scale_t(0.2) }.use_cache(true).build(first);
+        ExPolygon same_expolygon = expolygon;
+        ThickPolylines second;
+        MedialAxis{ same_expolygon, scale_t(1.1), scale_t(0.5), scale_t(0.2) }.use_cache(true).build(second);
+        THEN("the cached result is the same as the computed one") {
+            REQUIRE(!reference.empty());
+            REQUIRE(first.size() == reference.size());
+            REQUIRE(second.size() == reference.size());
+            for (size_t i = 0; i < reference.size(); ++ i) {
+                REQUIRE(first[i].points == reference[i].points);
+                REQUIRE(first[i].points_width == reference[i].points_width);
+                REQUIRE(second[i].points == reference[i].points);
+                REQUIRE(second[i].points_width == reference[i].points_width);
+            }
+        }
+        WHEN("a parameter changes") {
+            ThickPolylines other;
+            MedialAxis{ expolygon, scale_t(1.1), scale_t(0.5), scale_t(0.4) }.use_cache(true).build(other);
+            ThickPolylines other_reference;
+            MedialAxis{ expolygon, scale_t(1.1), scale_t(0.5), scale_t(0.4) }.build(other_reference);
+            THEN("the medial axis is computed with the new parameter") {
+                REQUIRE(other.size() == other_reference.size());
+                for (size_t i = 0; i < other.size(); ++ i)
+                    REQUIRE(other[i].points_width == other_reference[i].points_width);
+            }
+        }
+        MedialAxis::clear_cache();
+    }
+}